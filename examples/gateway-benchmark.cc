@@ -0,0 +1,419 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+#include "ns3/binary-codec.h"
+#include "ns3/gateway.h"
+#include "ns3/gateway-server.h"
+#include "ns3/gateway-transport.h"
+#include "ns3/shared-memory-transport.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("GatewayBenchmark");
+
+/*
+ * A throughput benchmark of complete gateway steps, for tracking performance across releases.
+ *
+ * For each combination of the swept parameters, a stand-in server is forked from the benchmark process. The server
+ * sends one message per step (containing fields of fieldSize bytes each) and waits for the gateway's response before
+ * sending the next step, like a lock-step co-simulation. The ns-3 process runs a gateway whose DoUpdate reads every
+ * field and sets one response value per node. Forking keeps the CPU time of the server out of the measurement of ns-3.
+ *
+ * Each combination produces one record with the steps per second (wall clock), the 50th and 99th percentile of the
+ * round-trip time measured by the server (from sending a step until receiving its response), and the CPU time used
+ * by the ns-3 process (all threads). Records are written to standard output as CSV (with a header line) or as JSON
+ * Lines (one object per line).
+ */
+
+// the parameters of one benchmark run
+struct Configuration
+{
+    std::string transport;  // tcp, unix, or shm
+    std::string framing;    // text or binary
+    uint32_t fields;        // number of fields in each server message
+    uint32_t fieldSize;     // size of each field in bytes
+    uint32_t nodes;         // number of values in each gateway response
+    uint32_t steps;         // number of steps
+};
+
+// a gateway that reads every received field and responds with one value per node
+class BenchmarkGateway : public Gateway
+{
+    public:
+        BenchmarkGateway(uint32_t nodes, Gateway::FRAMING framing):
+            Gateway(nodes, framing),
+            m_nodes(nodes),
+            m_steps(0),
+            m_bytes(0)
+        {
+        }
+
+        uint64_t GetBytes() const
+        {
+            return m_bytes;
+        }
+    private:
+        void DoInitialize(const GatewayMessage & data) override
+        {
+            DoUpdate(data);
+        }
+
+        void DoUpdate(const GatewayMessage & data) override
+        {
+            for (uint32_t i = 0; i < data.GetSize(); i++)
+            {
+                m_bytes += data[i].size();
+            }
+            for (uint32_t i = 0; i < m_nodes; i++)
+            {
+                SetValue(i, m_steps);
+            }
+            SendResponse();
+            m_steps++;
+        }
+
+        uint32_t m_nodes;   // the number of response values
+        uint32_t m_steps;   // the number of processed steps
+        uint64_t m_bytes;   // the number of received field bytes
+};
+
+// split a comma-separated list of positive integers
+std::vector<uint32_t>
+ParseList(const std::string & name, const std::string & list)
+{
+    std::vector<uint32_t> values;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        uint32_t value = 0;
+        if (item.empty() || item.find_first_not_of("0123456789") != std::string::npos
+            || (value = std::stoul(item)) == 0)
+        {
+            NS_FATAL_ERROR("ERROR: --" << name << " must be a comma-separated list of positive integers");
+        }
+        values.push_back(value);
+    }
+    return values;
+}
+
+// split a comma-separated list of names, each of which must be one of the allowed names
+std::vector<std::string>
+ParseNames(const std::string & name, const std::string & list, const std::vector<std::string> & allowed)
+{
+    std::vector<std::string> values;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        if (std::find(allowed.begin(), allowed.end(), item) == allowed.end())
+        {
+            NS_FATAL_ERROR("ERROR: --" << name << " contains the unknown value \"" << item << "\"");
+        }
+        values.push_back(item);
+    }
+    return values;
+}
+
+// write a value to the pipe read by the benchmark process
+void
+WriteResult(int resultPipe, const void * data, size_t size)
+{
+    if (write(resultPipe, data, size) != (ssize_t)size)
+    {
+        NS_FATAL_ERROR("ERROR: failed to return the benchmark results");
+    }
+}
+
+// the stand-in server (forked process), which writes one byte to resultPipe once it is listening, and then the
+// round-trip percentiles in microseconds (a failure to listen is a fatal error, which closes the pipe instead)
+void
+RunServer(const Configuration & configuration, const std::string & address, uint16_t port, int resultPipe)
+{
+    const char ready = 1;
+    Ptr<GatewayTransport> transport;
+    if (configuration.transport == "shm")
+    {
+        Ptr<SharedMemoryTransport> sharedMemoryTransport = Create<SharedMemoryTransport>();
+        sharedMemoryTransport->Listen(address);
+        WriteResult(resultPipe, &ready, sizeof(ready));
+        sharedMemoryTransport->Accept();
+        transport = sharedMemoryTransport;
+    }
+    else if (configuration.transport == "unix")
+    {
+        Ptr<UnixTransport> unixTransport = Create<UnixTransport>();
+        unixTransport->Listen(address);
+        WriteResult(resultPipe, &ready, sizeof(ready));
+        unixTransport->Accept();
+        transport = unixTransport;
+    }
+    else
+    {
+        Ptr<TcpTransport> tcpTransport = Create<TcpTransport>();
+        tcpTransport->Listen(port);
+        WriteResult(resultPipe, &ready, sizeof(ready));
+        tcpTransport->Accept();
+        transport = tcpTransport;
+    }
+
+    bool binary = (configuration.framing == "binary");
+    GatewayServer server(transport, binary ? Gateway::FRAMING::BINARY : Gateway::FRAMING::TEXT);
+
+    // every step sends the same values, so only the timestamp changes
+    std::string field(configuration.fieldSize, '7');
+    std::string payload;
+    for (uint32_t i = 0; i < configuration.fields; i++)
+    {
+        if (binary)
+        {
+            BinaryEncoder::AppendBytes(payload, field.data(), field.size());
+        }
+        else
+        {
+            payload += " " + field;
+        }
+    }
+
+    std::string message;
+    std::string response;
+    std::vector<double> latency(configuration.steps);
+    for (uint32_t step = 0; step < configuration.steps; step++)
+    {
+        if (binary)
+        {
+            message.assign(BinaryEncoder::HEADER_SIZE, '\0');
+            message += payload;
+            BinaryEncoder::WriteHeader(message, step, 0);
+        }
+        else
+        {
+            message = std::to_string(step) + " 0" + payload + "\r\n";
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        if (!server.Send(message) || !server.Receive(response))
+        {
+            NS_FATAL_ERROR("ERROR: the gateway closed the connection at step " << step);
+        }
+        latency[step] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    BinaryEncoder encoder;
+    server.Send(binary ? encoder.Finish(-1, 0) : "-1 0\r\n"); // terminate message
+    server.Close();
+
+    std::sort(latency.begin(), latency.end());
+    double percentiles[2] = {latency[configuration.steps / 2],
+                             latency[std::min<size_t>(configuration.steps - 1, configuration.steps * 0.99)]};
+    WriteResult(resultPipe, percentiles, sizeof(percentiles));
+}
+
+// the CPU time (user and system) used by every thread of this process
+double
+GetCpuSeconds()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+// run one configuration, and write its record to standard output
+void
+Run(const Configuration & configuration, uint16_t port, bool json)
+{
+    std::string address = (configuration.transport == "shm")
+        ? "/ns3-cosim-benchmark-" + std::to_string(getpid())        // shared memory object
+        : "/tmp/ns3-cosim-benchmark-" + std::to_string(getpid());   // Unix socket
+
+    int resultPipe[2];
+    if (pipe(resultPipe) == -1)
+    {
+        NS_FATAL_ERROR("ERROR: failed to create a pipe for the benchmark results");
+    }
+    std::cout.flush(); // the forked server must not repeat buffered output
+    pid_t server = fork();
+    if (server == -1)
+    {
+        NS_FATAL_ERROR("ERROR: failed to fork the server process");
+    }
+    if (server == 0)
+    {
+        close(resultPipe[0]);
+        RunServer(configuration, address, port, resultPipe[1]);
+        _exit(0);
+    }
+    close(resultPipe[1]);
+
+    // wait for the server to listen, so the gateway connects on the first attempt
+    char ready;
+    if (read(resultPipe[0], &ready, sizeof(ready)) != sizeof(ready))
+    {
+        int status;
+        waitpid(server, &status, 0);
+        NS_FATAL_ERROR("ERROR: the server failed to listen for " << configuration.transport << " "
+            << configuration.framing << " (see the server error above)");
+    }
+
+    double cpuStart = GetCpuSeconds();
+    auto wallStart = std::chrono::steady_clock::now();
+    {
+        BenchmarkGateway gateway(configuration.nodes, (configuration.framing == "binary") ? Gateway::FRAMING::BINARY
+                                                                                           : Gateway::FRAMING::TEXT);
+        if (configuration.transport == "shm")
+        {
+            Ptr<SharedMemoryTransport> transport = Create<SharedMemoryTransport>();
+            transport->Connect(address);
+            gateway.Connect(transport);
+        }
+        else if (configuration.transport == "unix")
+        {
+            Ptr<UnixTransport> transport = Create<UnixTransport>();
+            transport->Connect(address);
+            gateway.Connect(transport);
+        }
+        else
+        {
+            gateway.Connect("127.0.0.1", port);
+        }
+        Simulator::Run();
+        Simulator::Destroy();
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    double cpuSeconds = GetCpuSeconds() - cpuStart;
+
+    double percentiles[2];
+    bool complete = (read(resultPipe[0], percentiles, sizeof(percentiles)) == sizeof(percentiles));
+    close(resultPipe[0]);
+    int status;
+    waitpid(server, &status, 0);
+    if (!complete || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        NS_FATAL_ERROR("ERROR: the server failed for " << configuration.transport << " " << configuration.framing);
+    }
+
+    double stepsPerSecond = configuration.steps / wallSeconds;
+    if (json)
+    {
+        std::cout << "{\"transport\": \"" << configuration.transport << "\", \"framing\": \"" << configuration.framing
+                  << "\", \"fields\": " << configuration.fields << ", \"fieldSize\": " << configuration.fieldSize
+                  << ", \"nodes\": " << configuration.nodes << ", \"steps\": " << configuration.steps
+                  << ", \"stepsPerSecond\": " << stepsPerSecond << ", \"rttP50Us\": " << percentiles[0]
+                  << ", \"rttP99Us\": " << percentiles[1] << ", \"cpuSeconds\": " << cpuSeconds
+                  << ", \"wallSeconds\": " << wallSeconds << "}" << std::endl;
+    }
+    else
+    {
+        std::cout << configuration.transport << "," << configuration.framing << "," << configuration.fields << ","
+                  << configuration.fieldSize << "," << configuration.nodes << "," << configuration.steps << ","
+                  << stepsPerSecond << "," << percentiles[0] << "," << percentiles[1] << "," << cpuSeconds << ","
+                  << wallSeconds << std::endl;
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string transports  = "tcp,unix,shm";
+    std::string framings    = "text,binary";
+    std::string fields      = "10,1000";
+    std::string fieldSizes  = "8";
+    std::string nodes       = "10,1000";
+    std::string steps       = "1000";
+    std::string format      = "csv";
+    uint16_t serverPort     = 8000;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("transports", "Comma-separated transports to measure (tcp, unix, shm)", transports);
+    cmd.AddValue("framings", "Comma-separated message framings to measure (text, binary)", framings);
+    cmd.AddValue("fields", "Comma-separated numbers of fields in each server message", fields);
+    cmd.AddValue("fieldSizes", "Comma-separated sizes in bytes of each field", fieldSizes);
+    cmd.AddValue("nodes", "Comma-separated numbers of values in each gateway response", nodes);
+    cmd.AddValue("steps", "Comma-separated numbers of steps to run", steps);
+    cmd.AddValue("format", "Output format (csv or json)", format);
+    cmd.AddValue("serverPort", "Port number used by the TCP transport", serverPort);
+    cmd.Parse(argc, argv);
+
+    if (format != "csv" && format != "json")
+    {
+        NS_FATAL_ERROR("ERROR: --format must be csv or json");
+    }
+    Time::SetResolution(Time::NS);
+
+    std::vector<std::string> transportList = ParseNames("transports", transports, {"tcp", "unix", "shm"});
+    std::vector<std::string> framingList = ParseNames("framings", framings, {"text", "binary"});
+    std::vector<uint32_t> fieldList = ParseList("fields", fields);
+    std::vector<uint32_t> fieldSizeList = ParseList("fieldSizes", fieldSizes);
+    std::vector<uint32_t> nodeList = ParseList("nodes", nodes);
+    std::vector<uint32_t> stepList = ParseList("steps", steps);
+
+    if (format == "csv")
+    {
+        std::cout << "transport,framing,fields,fieldSize,nodes,steps,stepsPerSecond,rttP50Us,rttP99Us,cpuSeconds,"
+                  << "wallSeconds" << std::endl;
+    }
+    for (const std::string & transport : transportList)
+    {
+        for (const std::string & framing : framingList)
+        {
+            for (uint32_t fieldCount : fieldList)
+            {
+                for (uint32_t fieldSize : fieldSizeList)
+                {
+                    for (uint32_t nodeCount : nodeList)
+                    {
+                        for (uint32_t stepCount : stepList)
+                        {
+                            Run({transport, framing, fieldCount, fieldSize, nodeCount, stepCount}, serverPort,
+                                format == "json");
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <chrono>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+
+#include "ns3/core-module.h"
+
+#include "ns3/spsc-queue.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("GatewayQueueBenchmark");
+
+/*
+ * A microbenchmark of the handoff of received messages from a socket thread to the ns-3 main thread.
+ *
+ * A producer thread passes a fixed number of messages to the main thread as fast as possible, while the main thread is
+ * paused by an event that reschedules itself (as Gateway::WaitForNextUpdate does). Two handoff methods are compared:
+ *  1) a std::queue protected by a std::mutex, with one Simulator::ScheduleWithContext call per message
+ *  2) a lock-free SpscQueue of recycled buffers, where Simulator::ScheduleWithContext is only called when no consumer
+ *     event is already scheduled, and each consumer event drains every available message
+ */
+
+// the handoff used by the gateway before the SpscQueue
+class MutexHandoff
+{
+    public:
+        void Produce(uint32_t count, const std::string & payload)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                {
+                    std::unique_lock lock(m_mutex);
+                    m_queue.push(payload);
+                }
+                Simulator::ScheduleWithContext(m_context, Time(0), MakeEvent(&MutexHandoff::Consume, this));
+            }
+        }
+
+        void Consume()
+        {
+            std::string message;
+            {
+                std::unique_lock lock(m_mutex);
+                message = m_queue.front();
+                m_queue.pop();
+            }
+            m_bytes += message.size();
+            m_received++;
+        }
+
+        uint32_t m_context = Simulator::GetContext();
+        uint32_t m_received = 0;
+        uint64_t m_bytes = 0;
+    private:
+        std::queue<std::string> m_queue;
+        std::mutex m_mutex;
+};
+
+// the handoff used by the gateway with the SpscQueue
+class SpscHandoff
+{
+    public:
+        SpscHandoff(uint32_t capacity):
+            m_queue(capacity),
+            m_scheduled(false)
+        {
+        }
+
+        void Produce(uint32_t count, const std::string & payload)
+        {
+            std::string message;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                message.assign(payload); // re-uses the buffer returned by Push
+                while (!m_queue.Push(message))
+                {
+                    // full: back off like Gateway::RunThread so the consumer can run
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+                if (!m_scheduled.exchange(true, std::memory_order_acq_rel))
+                {
+                    Simulator::ScheduleWithContext(m_context, Time(0), MakeEvent(&SpscHandoff::Consume, this));
+                }
+            }
+        }
+
+        void Consume()
+        {
+            m_scheduled.exchange(false, std::memory_order_acq_rel);
+            while (m_queue.Pop(m_message))
+            {
+                m_bytes += m_message.size();
+                m_received++;
+            }
+        }
+
+        uint32_t m_context = Simulator::GetContext();
+        uint32_t m_received = 0;
+        uint64_t m_bytes = 0;
+    private:
+        SpscQueue<std::string> m_queue;
+        std::atomic<bool> m_scheduled;
+        std::string m_message;
+};
+
+// pause the simulator until all messages are received
+template <typename HANDOFF>
+void
+Wait(HANDOFF * handoff, uint32_t count)
+{
+    if (handoff->m_received < count)
+    {
+        Simulator::ScheduleNow(&Wait<HANDOFF>, handoff, count);
+    }
+}
+
+// run the benchmark for one handoff method, and return the number of messages per second
+template <typename HANDOFF>
+double
+Run(HANDOFF & handoff, uint32_t count, const std::string & payload)
+{
+    Simulator::ScheduleNow(&Wait<HANDOFF>, &handoff, count);
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer(&HANDOFF::Produce, &handoff, count, payload);
+    Simulator::Run();
+    auto stop = std::chrono::steady_clock::now();
+
+    producer.join();
+    Simulator::Destroy();
+
+    if (handoff.m_received != count || handoff.m_bytes != uint64_t(count) * payload.size())
+    {
+        NS_FATAL_ERROR("ERROR: received " << handoff.m_received << " of " << count << " messages");
+    }
+    return count / std::chrono::duration<double>(stop - start).count();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t messageCount   = 1000000;
+    uint32_t messageSize    = 64;   // bytes
+    uint32_t queueCapacity  = 1024;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("messageCount", "Number of messages passed between the threads", messageCount);
+    cmd.AddValue("messageSize", "Size of each message in bytes", messageSize);
+    cmd.AddValue("queueCapacity", "Capacity of the lock-free queue", queueCapacity);
+    cmd.Parse(argc, argv);
+
+    LogComponentEnable("GatewayQueueBenchmark", LOG_LEVEL_INFO);
+
+    std::string payload(messageSize, 'x');
+
+    MutexHandoff mutexHandoff;
+    double mutexRate = Run(mutexHandoff, messageCount, payload);
+    NS_LOG_INFO("mutex queue:     " << mutexRate << " messages/s");
+
+    SpscHandoff spscHandoff(queueCapacity);
+    double spscRate = Run(spscHandoff, messageCount, payload);
+    NS_LOG_INFO("lock-free queue: " << spscRate << " messages/s (" << spscRate / mutexRate << "x)");
+
+    return 0;
+}
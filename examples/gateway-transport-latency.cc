@@ -0,0 +1,160 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+#include "ns3/gateway-server.h"
+#include "ns3/gateway-transport.h"
+#include "ns3/shared-memory-transport.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("GatewayTransportLatency");
+
+/*
+ * A comparison of the round-trip latency of the gateway transports on one host.
+ *
+ * For each transport, a server thread echoes every message it receives, and the main thread measures the time from
+ * sending a message until the complete echo is received (one lock-step exchange between ns-3 and a server). Messages
+ * use the TEXT framing, and are sent and received with GatewayServer on both sides.
+ */
+
+// the server side of one transport, which echoes messages until the connection closes
+void
+Echo(Ptr<GatewayTransport> transport, std::function<void()> accept)
+{
+    accept();
+    GatewayServer server(transport);
+    std::string message;
+    while (server.Receive(message))
+    {
+        message += "\r\n";
+        server.Send(message);
+    }
+    server.Close();
+}
+
+// measure the round-trip latency of one transport, and log the median and 99th percentile
+void
+Run(const std::string & name,
+    Ptr<GatewayTransport> serverTransport, std::function<void()> listen, std::function<void()> accept,
+    Ptr<GatewayTransport> clientTransport, std::function<void()> connect,
+    uint32_t count, const std::string & payload)
+{
+    listen(); // the client can connect as soon as the server is listening
+    std::thread server(&Echo, serverTransport, accept);
+    connect();
+
+    GatewayServer client(clientTransport);
+    std::string message = payload + "\r\n";
+    std::string response;
+    std::vector<double> latency(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (!client.Send(message) || !client.Receive(response) || response != payload)
+        {
+            NS_FATAL_ERROR("ERROR: " << name << " failed to echo message " << i);
+        }
+        latency[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+    client.Close();
+    server.join();
+
+    std::sort(latency.begin(), latency.end());
+    NS_LOG_INFO(name << " round trip: median " << latency[count / 2] << " us, 99th percentile "
+        << latency[std::min<size_t>(count - 1, count * 0.99)] << " us"
+    );
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t messageCount   = 10000;
+    uint32_t messageSize    = 256;  // bytes
+    uint16_t serverPort     = 8000;
+    bool ipv6               = true;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("messageCount", "Number of messages exchanged with each transport", messageCount);
+    cmd.AddValue("messageSize", "Size of each message in bytes", messageSize);
+    cmd.AddValue("serverPort", "Port number used by the TCP transports", serverPort);
+    cmd.AddValue("ipv6", "Include TCP over the IPv6 loopback address", ipv6);
+    cmd.Parse(argc, argv);
+
+    LogComponentEnable("GatewayTransportLatency", LOG_LEVEL_INFO);
+
+    if (messageCount == 0)
+    {
+        NS_FATAL_ERROR("ERROR: messageCount must be greater than 0");
+    }
+    std::string payload(messageSize, 'x');
+    std::string path = "/tmp/ns3-cosim-latency-" + std::to_string(getpid());   // Unix socket
+    std::string name = "/ns3-cosim-latency-" + std::to_string(getpid());       // shared memory object
+
+    {
+        Ptr<TcpTransport> server = Create<TcpTransport>();
+        Ptr<TcpTransport> client = Create<TcpTransport>();
+        Run("TCP (127.0.0.1)", server, [=] { server->Listen(serverPort); }, [=] { server->Accept(); },
+            client, [=] { client->Connect("127.0.0.1", serverPort); }, messageCount, payload);
+    }
+    if (ipv6)
+    {
+        Ptr<TcpTransport> server = Create<TcpTransport>();
+        Ptr<TcpTransport> client = Create<TcpTransport>();
+        Run("TCP (::1)", server, [=] { server->Listen(serverPort); }, [=] { server->Accept(); },
+            client, [=] { client->Connect("::1", serverPort); }, messageCount, payload);
+    }
+    {
+        Ptr<UnixTransport> server = Create<UnixTransport>();
+        Ptr<UnixTransport> client = Create<UnixTransport>();
+        Run("Unix socket", server, [=] { server->Listen(path); }, [=] { server->Accept(); },
+            client, [=] { client->Connect(path); }, messageCount, payload);
+    }
+    {
+        Ptr<SharedMemoryTransport> server = Create<SharedMemoryTransport>();
+        Ptr<SharedMemoryTransport> client = Create<SharedMemoryTransport>();
+        Run("Shared memory", server, [=] { server->Listen(name); }, [=] { server->Accept(); },
+            client, [=] { client->Connect(name); }, messageCount, payload);
+    }
+
+    return 0;
+}
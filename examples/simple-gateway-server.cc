@@ -30,18 +30,19 @@
  * Author: Thomas Roth <thomas.roth@nist.gov>
 */
 
-#include <arpa/inet.h>
-#include <netinet/in.h>
-#include <sys/socket.h>
-#include <unistd.h>
-
+#include <chrono>
 #include <cstdlib>
 #include <ctime>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "ns3/core-module.h"
 
+#include "ns3/binary-codec.h"
+#include "ns3/gateway-server.h"
+#include "ns3/shared-memory-transport.h"
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("SimpleGatewayServer");
@@ -50,23 +51,45 @@ int
 main(int argc, char* argv[])
 {
     bool verboseLogs        = false;
+    bool binaryFraming      = false;
+    bool deltaResponse      = false;
+    bool responseHeader     = false;
     uint32_t timeStart      = 0;    // s
     uint32_t timeDelta      = 1;    // s
     uint32_t iterations     = 20;
+    uint32_t stepDelay      = 0;    // ms
+    uint32_t lookahead      = 0;    // ms
+    uint32_t pipeline       = 1;
     uint16_t numberOfNodes  = 3;
     uint16_t positionDeltaX = 25;   // m
     uint16_t serverPort     = 8000;
+    std::string sharedMemory = "";
+    std::string unixSocket  = "";
 
     CommandLine cmd(__FILE__);
     cmd.AddValue("verbose", "Enable/disable detailed log output", verboseLogs);
+    cmd.AddValue("binary", "Exchange binary messages (instead of strings) with the client", binaryFraming);
+    cmd.AddValue("deltaResponse", "Expect responses that only contain changed values", deltaResponse);
+    cmd.AddValue("responseHeader", "Expect responses that begin with their timestamp and sequence number",
+                 responseHeader);
     cmd.AddValue("timeStart", "Starting simulation time in seconds", timeStart);
     cmd.AddValue("timeDelta", "Simulation step size in seconds", timeDelta);
     cmd.AddValue("iterations", "Number of time steps to simulate", iterations);
+    cmd.AddValue("stepDelay", "Wall clock time in milliseconds to spend computing each time step", stepDelay);
+    cmd.AddValue("lookahead", "Lookahead in milliseconds to include in each message header (0 to omit)", lookahead);
+    cmd.AddValue("pipeline", "Number of steps sent before the response to the first of them is read", pipeline);
     cmd.AddValue("numberOfNodes", "Number of vehicle nodes to simulate", numberOfNodes);
     cmd.AddValue("positionDeltaX", "Maximum increase per time step to a node's x-coordinate", positionDeltaX);
     cmd.AddValue("serverPort", "Port number of the UDP Server", serverPort);
+    cmd.AddValue("sharedMemory", "Name of a shared memory transport to create (instead of TCP)", sharedMemory);
+    cmd.AddValue("unixSocket", "Path of a Unix domain socket to listen on (instead of TCP)", unixSocket);
     cmd.Parse(argc, argv);
 
+    if (pipeline == 0)
+    {
+        NS_FATAL_ERROR("ERROR: at least one step must be in flight");
+    }
+
     std::srand(std::time(NULL));
 
     if (verboseLogs)
@@ -78,116 +101,148 @@ main(int argc, char* argv[])
         LogComponentEnable("SimpleGatewayServer", LOG_LEVEL_INFO);
     }
 
-    // create the server socket
-    int serverSocket = socket(AF_INET, SOCK_STREAM, 0);
-    if (serverSocket == -1)
+    // wait for the gateway to connect (the rest of the server is the same for every transport)
+    Ptr<GatewayTransport> transport;
+    if (!sharedMemory.empty())
     {
-        NS_FATAL_ERROR("ERROR: failed to create the socket");
+        Ptr<SharedMemoryTransport> sharedMemoryTransport = Create<SharedMemoryTransport>();
+        NS_LOG_INFO("Started server on shared memory " << sharedMemory);
+        sharedMemoryTransport->Accept(sharedMemory);
+        transport = sharedMemoryTransport;
     }
-    int reuse = 1;
-    if (setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) == -1)
+    else if (!unixSocket.empty())
     {
-        NS_FATAL_ERROR("ERROR: failed to set the socket options");
+        Ptr<UnixTransport> unixTransport = Create<UnixTransport>();
+        NS_LOG_INFO("Started server on Unix socket " << unixSocket);
+        unixTransport->Accept(unixSocket);
+        transport = unixTransport;
     }
-
-    // set the server address
-    struct sockaddr_in serverAddress;
-    serverAddress.sin_family = AF_INET;
-    serverAddress.sin_port = htons(serverPort);
-    serverAddress.sin_addr.s_addr = INADDR_ANY;
-
-    // bind the socket to the server address
-    if (bind(serverSocket, (struct sockaddr *)&serverAddress, sizeof(serverAddress)) == -1)
-    {
-        NS_FATAL_ERROR("ERROR: failed to bind the socket to port " << serverPort);
-    }
-    
-    // listen for client connections
-    if (listen(serverSocket, 1) == -1)
-    {
-        NS_FATAL_ERROR("ERROR: failed to listen for client connections");
-    }
-    NS_LOG_INFO("Started server on Port " << serverPort);
-
-    // accept a client connection
-    int clientSocket = accept(serverSocket, NULL, NULL);
-    if (clientSocket == -1)
+    else
     {
-        NS_FATAL_ERROR("ERROR: failed to accept the client connection");
+        Ptr<TcpTransport> tcpTransport = Create<TcpTransport>();
+        NS_LOG_INFO("Started server on Port " << serverPort);
+        tcpTransport->Accept(serverPort);
+        transport = tcpTransport;
     }
     NS_LOG_INFO("Accepted a client connection");
 
+    GatewayServer server(transport, binaryFraming ? Gateway::FRAMING::BINARY : Gateway::FRAMING::TEXT);
+    server.SetResponseMode(deltaResponse ? Gateway::RESPONSE_MODE::DELTA : Gateway::RESPONSE_MODE::FULL);
+    server.SetResponseHeader(responseHeader);
+
     /* ========== START MESSAGE PROTOCOL =====================================*/
 
-    const size_t BUFFER_SIZE = 4096;
-    char recvBuffer[BUFFER_SIZE];
+    BinaryEncoder encoder;
 
     std::vector<uint16_t> xVelocity(numberOfNodes, 0);
     std::vector<uint16_t> xPosition(numberOfNodes, 0);
     std::vector<uint16_t> broadcast(numberOfNodes, 0);
+    std::vector<std::string> response;
     
-    for (uint32_t i = 0; i < iterations; i++)
+    uint32_t received = 0;  // the number of responses received
+    bool connected = true;
+    for (uint32_t i = 0; i < iterations && connected; i++)
     {
         uint32_t timeNow = timeStart + timeDelta * i;
         NS_LOG_INFO("t = " << timeNow);
 
+        // represent the time a real server would spend computing the step (ns-3 is waiting during this time)
+        std::this_thread::sleep_for(std::chrono::milliseconds(stepDelay));
+
         // create the next message
-        std::string message = std::to_string(timeNow) + " 0";                               // timestamp header
-        for (uint16_t n = 0; n < numberOfNodes; n++)
+        std::string message;
+        if (binaryFraming)
+        {
+            encoder.Clear();
+            if (lookahead > 0)
+            {
+                encoder.AddInt64(int64_t(lookahead) * 1000000);                                // lookahead (ns)
+            }
+            for (uint16_t n = 0; n < numberOfNodes; n++)
+            {
+                encoder.AddInt32(xPosition[n]);     // position vector
+                encoder.AddInt32(n);
+                encoder.AddInt32(0);
+                encoder.AddInt32(xVelocity[n]);     // velocity vector
+                encoder.AddInt32(0);
+                encoder.AddInt32(0);
+                encoder.AddInt32(broadcast[n]);     // broadcast bool
+            }
+            message = encoder.Finish(timeNow, 0);   // timestamp header
+        }
+        else
         {
-            message += " " + std::to_string(xPosition[n]) + " " + std::to_string(n) + " 0"; // position vector
-            message += " " + std::to_string(xVelocity[n]) + " 0 0";                         // velocity vector
-            message += " " + std::to_string(broadcast[n]);                                  // broadcast bool
+            message = std::to_string(timeNow) + " 0";                                           // timestamp header
+            if (lookahead > 0)
+            {
+                message += " " + std::to_string(uint64_t(lookahead) * 1000000);                 // lookahead (ns)
+            }
+            for (uint16_t n = 0; n < numberOfNodes; n++)
+            {
+                message += " " + std::to_string(xPosition[n]) + " " + std::to_string(n) + " 0"; // position vector
+                message += " " + std::to_string(xVelocity[n]) + " 0 0";                         // velocity vector
+                message += " " + std::to_string(broadcast[n]);                                  // broadcast bool
+            }
+            NS_LOG_DEBUG("next message: " << message);
+            message += "\r\n";                                                                  // end of message
         }
-        NS_LOG_DEBUG("next message: " << message);
-        message += "\r\n";                                                                  // end of message
 
         // send the next message
-        if (send(clientSocket, message.c_str(), message.size(), 0) == -1)
+        if (!server.Send(message))
         {
             NS_FATAL_ERROR("ERROR: failed to send a message");
         }
 
-        // receive client response
-        int bytesReceived = recv(clientSocket, recvBuffer, BUFFER_SIZE - 1, 0);
-        if (bytesReceived == -1)
-        {
-            NS_FATAL_ERROR("ERROR: failed to receive response");
-        }
-        else if (bytesReceived == 0)
-        {
-            NS_LOG_WARN("WARNING: client socket terminated connection");
-            break;
-        }
-        else
+        // simulate node movement (the next message never depends on a response, so steps can be pipelined)
+        for (uint16_t n = 0; n < numberOfNodes; n++)
         {
-            recvBuffer[bytesReceived] = '\0'; // bytesReceived < BUFFER_SIZE
-            NS_LOG_DEBUG("received message: " << recvBuffer);
+            xVelocity[n] = std::rand() % positionDeltaX + 1;
+            xPosition[n] = xPosition[n] + xVelocity[n];
+            broadcast[n] = (i % 5 == 0) && (std::rand() % 2 == 0); // on multiples of 5, 50 % chance
         }
 
-        if (i == iterations - 1) // last iteration
+        // receive client responses until fewer than pipeline steps are in flight (or all of them after the last step)
+        // a delta response only updates the values that changed
+        while (connected && (received + pipeline <= i + 1 || (i == iterations - 1 && received < iterations)))
         {
-            message = "-1 0\r\n"; // terminate message
-            if (send(clientSocket, message.c_str(), message.size(), 0) == -1)
+            if (!server.ReceiveValues(response))
             {
-                NS_FATAL_ERROR("ERROR: failed to send a message");
+                NS_LOG_WARN("WARNING: client terminated connection");
+                connected = false;
+                break;
             }
-            NS_LOG_INFO("Sent terminate message");
-        }
-        else
-        {
-            // simulate node movement
-            for (uint16_t n = 0; n < numberOfNodes; n++)
+            std::string values;
+            for (const std::string & value : response)
+            {
+                values += value + " ";
+            }
+            NS_LOG_DEBUG("received values: " << values);
+            if (responseHeader)
+            {
+                NS_LOG_DEBUG("response to step " << server.GetResponseSequence() << " at "
+                    << server.GetResponseTime().As(Time::S));
+            }
+            if (responseHeader && server.GetResponseSequence() != received)
             {
-                xVelocity[n] = std::rand() % positionDeltaX + 1;
-                xPosition[n] = xPosition[n] + xVelocity[n];
-                broadcast[n] = (i % 5 == 0) && (std::rand() % 2 == 0); // on multiples of 5, 50 % chance
+                NS_FATAL_ERROR("ERROR: received the response to step " << server.GetResponseSequence()
+                    << " instead of step " << received);
             }
+            received++;
+        }
+    }
+
+    if (connected)
+    {
+        encoder.Clear();
+        std::string message = binaryFraming ? encoder.Finish(-1, 0) : "-1 0\r\n"; // terminate message
+        if (!server.Send(message))
+        {
+            NS_FATAL_ERROR("ERROR: failed to send a message");
         }
+        NS_LOG_INFO("Sent terminate message");
     }
 
-    close(clientSocket);
-    close(serverSocket);
+    server.Close();
 
     return 0;
 }
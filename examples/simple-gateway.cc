@@ -30,8 +30,10 @@
  * Author: Thomas Roth <thomas.roth@nist.gov>
 */
 
+#include <chrono>
+#include <ctime>
+#include <sstream>
 #include <string>
-#include <vector>
 
 #include "ns3/applications-module.h"
 #include "ns3/core-module.h"
@@ -40,11 +42,16 @@
 #include "ns3/mobility-module.h"
 #include "ns3/network-module.h"
 
+#include "ns3/external-mobility-fleet.h"
 #include "ns3/external-mobility-model.h"
 #include "ns3/triggered-send-application.h"
 #include "ns3/triggered-send-helper.h"
 
 #include "ns3/gateway.h"
+#include "ns3/gateway-reactor.h"
+#include "ns3/typed-gateway.h"
+#include "ns3/replay-transport.h"
+#include "ns3/shared-memory-transport.h"
 
 using namespace ns3;
 
@@ -66,85 +73,89 @@ NS_LOG_COMPONENT_DEFINE("SimpleGateway");
  *  recvCount_i is the number of times vehicle i has received a broadcast
  *
  * A response is sent each time data is received.
+ *
+ * Both formats are declared as records (see TypedGateway), so each message is decoded into one record per vehicle.
  */
-class SimpleGateway : public Gateway
+class SimpleGateway : public TypedGateway<Record<Vector, Vector, bool>, Response<uint16_t>>
 {
     public:
         // initialize a simple gateway where n = vehicles.GetN()
-        SimpleGateway(NodeContainer vehicles);
+        SimpleGateway(NodeContainer vehicles, Gateway::FRAMING framing);
 
         // this function handles receiving broadcast messages from ns-3 (not the remote server)
         //  id indicates the vehicle index that received the message; the other arguments are ignored
         void HandleReceive(std::string id, Ptr<const Packet> packet, const Address &clientAddress);
     private:
         // this function handles processing the first message received from the remote server
-        //  the simple gateway doesn't require any initialization, so this just calls DoUpdate
-        virtual void DoInitialize(const std::vector<std::string> & data);
+        //  the simple gateway doesn't require any initialization, so this just calls DoUpdateRecords
+        void DoInitializeRecords(const std::vector<RecordType> & records) override;
 
-        // this function handles processing messages received from the remote server
-        virtual void DoUpdate(const std::vector<std::string> & data);
+        // this function handles processing messages received from the remote server (one record per vehicle)
+        void DoUpdateRecords(const std::vector<RecordType> & records) override;
 
-        NodeContainer m_vehicles;       // the nodes representing vehicles that are managed by the gateway
-        std::vector<uint16_t> m_count;  // the number of times each vehicle has received a broadcast
+        NodeContainer m_vehicles;           // the nodes representing vehicles that are managed by the gateway
+        ExternalMobilityFleet m_fleet;      // the mobility models of the vehicles
+        std::vector<ResponseType> m_count;  // the number of times each vehicle has received a broadcast
 };
 
-SimpleGateway::SimpleGateway(NodeContainer vehicles):
-    Gateway(vehicles.GetN()),
+SimpleGateway::SimpleGateway(NodeContainer vehicles, Gateway::FRAMING framing):
+    TypedGateway(vehicles.GetN(), framing),
     m_vehicles(vehicles),
-    m_count(vehicles.GetN(), 0)
+    m_fleet(vehicles),
+    m_count(vehicles.GetN(), ResponseType(0))
 {
-    // do nothing
+    SetIgnoreTrailingFields(true); // only the fields of the first vehicles.GetN() records are used
 }
 
 void
 SimpleGateway::HandleReceive(std::string id, Ptr<const Packet> packet, const Address &clientAddress)
 {
     NS_LOG_INFO("At time " << Simulator::Now().As(Time::S) << ", Node " << id << " received a broadcast");
-    m_count.at(std::stoi(id)) += 1;
+    std::get<0>(m_count.at(std::stoi(id))) += 1;
 }
 
 void
-SimpleGateway::DoInitialize(const std::vector<std::string> & data)
+SimpleGateway::DoInitializeRecords(const std::vector<RecordType> & records)
 {
-    DoUpdate(data);
+    DoUpdateRecords(records);
 }
 
 void
-SimpleGateway::DoUpdate(const std::vector<std::string> & data)
+SimpleGateway::DoUpdateRecords(const std::vector<RecordType> & records)
 {
-    NS_LOG_FUNCTION(this << data);
+    NS_LOG_FUNCTION(this << records.size());
+
+    if (records.size() < m_vehicles.GetN())
+    {
+        NS_FATAL_ERROR("ERROR: received data has insufficient size");
+    }
 
-    static const uint32_t ELEMENTS_PER_VEHICLE = 7; // Position_{x,y,z} + Velocity_{x,y,z} + SendFlag
-    
     for (uint32_t i = 0; i < m_vehicles.GetN(); i++)
     {
         Ptr<Node> vehicle = m_vehicles.Get(i);
-        uint32_t dataIndex = i * ELEMENTS_PER_VEHICLE;
-        
-        if (dataIndex + ELEMENTS_PER_VEHICLE > data.size())
+        const auto & [position, velocity, sendFlag] = records[i];
+
+        // update the vehicle position and velocity
+        Ptr<ExternalMobilityModel> mobility = m_fleet.Get(i);
+        if (mobility->GetDeadReckoning())
         {
-            NS_FATAL_ERROR("ERROR: received data has insufficient size");
+            m_fleet.Update(i, position, velocity); // one course change when the extrapolation is corrected
+        }
+        else
+        {
+            mobility->SetPosition(position); // only a velocity change reports a course change
+            mobility->SetVelocity(velocity);
         }
-
-        // update the vehicle position
-        Vector position(std::stoi(data[dataIndex]), std::stoi(data[dataIndex+1]), std::stoi(data[dataIndex+2]));
-        vehicle->GetObject<ExternalMobilityModel>()->SetPosition(position);
-
-        // update the vehicle velocity
-        Vector velocity(std::stoi(data[dataIndex+3]), std::stoi(data[dataIndex+4]), std::stoi(data[dataIndex+5]));
-        vehicle->GetObject<ExternalMobilityModel>()->SetVelocity(velocity);
         
         // handle the send flag
-        if (std::stoi(data[dataIndex+6]))
+        if (sendFlag)
         {
             // the index '0' here is because the TriggeredSendApplication is the first application installed in main
             DynamicCast<TriggeredSendApplication>(vehicle->GetApplication(0))->Send(3); // broadcast 3 packets
             NS_LOG_INFO("At time " << Simulator::Now().As(Time::S) << ", Node " << i << " sent a broadcast");
         }
-
-        SetValue(i, std::to_string(m_count[i])); // update the received broadcast count
     }
-    SendResponse(); // format and send a response based on the most recent SetValue
+    SendResponse(m_count); // set each response value to the received broadcast count and send the response
 }
 
 void
@@ -160,15 +171,56 @@ int
 main(int argc, char* argv[])
 {
     bool verboseLogs            = false;
+    bool blockingWait           = false;
+    bool binaryFraming          = false;
+    bool deltaResponse          = false;
+    bool responseHeader         = false;
+    bool asyncSend              = false;
+    bool timingSummary          = false;
     uint16_t numberOfNodes      = 3;
+    bool deadReckoning          = false;
     uint16_t serverPort         = 8000;
     std::string serverAddress   = "127.0.0.1";
+    std::string sharedMemory    = "";
+    std::string unixSocket      = "";
+    uint32_t lookahead          = 0;    // ms
+    bool lookaheadHeader        = false;
+    double pacing               = 0;
+    std::string record          = "";
+    std::string recordResponses = "";
+    std::string replay          = "";
+    std::string replayResponses = "";
+    bool replayPaced            = false;
+    uint32_t reactorThreads     = 0;
 
     CommandLine cmd(__FILE__);
     cmd.AddValue("verbose", "Enable/disable detailed log output", verboseLogs);
+    cmd.AddValue("blockingWait", "Block the simulator thread (instead of spinning) while waiting for the server",
+                 blockingWait);
+    cmd.AddValue("binary", "Exchange binary messages (instead of strings) with the server", binaryFraming);
+    cmd.AddValue("deltaResponse", "Only send the response values that changed since the last response", deltaResponse);
+    cmd.AddValue("responseHeader", "Begin each response with its timestamp and sequence number", responseHeader);
+    cmd.AddValue("asyncSend", "Send responses from a writer thread instead of the simulator thread", asyncSend);
+    cmd.AddValue("timingSummary", "Report the time spent in each stage of the co-simulation steps", timingSummary);
+    cmd.AddValue("reactorThreads", "Receive with this many shared reactor threads (0 for a gateway thread)",
+                 reactorThreads);
     cmd.AddValue("numberOfNodes", "Number of vehicle nodes to simulate", numberOfNodes);
+    cmd.AddValue("deadReckoning", "Extrapolate the vehicle positions between server updates", deadReckoning);
     cmd.AddValue("serverPort", "Port number of the UDP Server", serverPort);
     cmd.AddValue("serverAddress", "Address of the UDP Server", serverAddress);
+    cmd.AddValue("sharedMemory", "Name of the server's shared memory transport (instead of TCP)", sharedMemory);
+    cmd.AddValue("unixSocket", "Path of the server's Unix domain socket (instead of TCP)", unixSocket);
+    cmd.AddValue("lookahead", "Time in milliseconds ns-3 may run ahead of each received timestamp", lookahead);
+    cmd.AddValue("lookaheadHeader", "Read the lookahead from each received message header", lookaheadHeader);
+    cmd.AddValue("pacing", "Simulation seconds per wall clock second that ns-3 must not exceed (0 for no pacing)",
+                 pacing);
+    cmd.AddValue("record", "Record the messages received from the server to this file", record);
+    cmd.AddValue("recordResponses", "Record the responses sent to the server to this file", recordResponses);
+    cmd.AddValue("replay", "Replay the messages recorded in this file (instead of connecting to a server)", replay);
+    cmd.AddValue("replayResponses", "Compare the replayed responses with the responses recorded in this file",
+                 replayResponses);
+    cmd.AddValue("replayPaced", "Replay the messages at their recorded times (instead of as fast as possible)",
+                 replayPaced);
     cmd.Parse(argc, argv);
 
     Time::SetResolution(Time::NS); // timestamp has nanosecond resolution
@@ -197,7 +249,7 @@ main(int argc, char* argv[])
 
     // install the external mobility model
     MobilityHelper mobility;
-    mobility.SetMobilityModel("ns3::ExternalMobilityModel");
+    mobility.SetMobilityModel("ns3::ExternalMobilityModel", "DeadReckoning", BooleanValue(deadReckoning));
     mobility.SetPositionAllocator(positionAllocator);
     mobility.Install(vehicles);
 
@@ -217,7 +269,7 @@ main(int argc, char* argv[])
 
     const Ipv4Address broadcastAddress("192.168.1.255");
     const uint16_t applicationPort = 8000;
-    SimpleGateway gateway(vehicles);
+    SimpleGateway gateway(vehicles, binaryFraming ? Gateway::FRAMING::BINARY : Gateway::FRAMING::TEXT);
 
     // install the applications
     for (uint32_t i = 0; i < vehicles.GetN(); i++)
@@ -241,10 +293,90 @@ main(int argc, char* argv[])
         serverApps.Start(Time(0));
     }
 
-    gateway.Connect(serverAddress, serverPort); // server must be running before this line (or error)
+    gateway.SetIdleMode(blockingWait ? Gateway::IDLE_MODE::BLOCK : Gateway::IDLE_MODE::SPIN);
+    gateway.SetResponseMode(deltaResponse ? Gateway::RESPONSE_MODE::DELTA : Gateway::RESPONSE_MODE::FULL);
+    gateway.SetLookahead(MilliSeconds(lookahead));
+    gateway.SetLookaheadHeader(lookaheadHeader);
+    gateway.SetResponseHeader(responseHeader);
+    gateway.SetPacing(pacing);
+    gateway.SetAsyncSend(asyncSend);
+    gateway.SetTimingHistograms(timingSummary);
+    if (reactorThreads > 0)
+    {
+        Ptr<GatewayReactor> reactor = GatewayReactor::GetInstance();
+        reactor->SetThreadCount(reactorThreads);
+        gateway.SetReactor(reactor);
+    }
+    if (!record.empty())
+    {
+        gateway.SetRecordFile(record, recordResponses);
+    }
+    Ptr<ReplayTransport> replayTransport;
+    if (!replay.empty())
+    {
+        replayTransport = Create<ReplayTransport>();
+        replayTransport->Open(replay, replayPaced ? ReplayTransport::PACING::WALL_CLOCK
+                                                  : ReplayTransport::PACING::AS_FAST_AS_POSSIBLE);
+        if (!replayResponses.empty())
+        {
+            replayTransport->SetResponseLog(replayResponses);
+        }
+        gateway.Connect(replayTransport);
+    }
+    else if (!sharedMemory.empty())
+    {
+        Ptr<SharedMemoryTransport> transport = Create<SharedMemoryTransport>();
+        transport->Connect(sharedMemory);       // server must be running before this line (or error)
+        gateway.Connect(transport);
+    }
+    else if (!unixSocket.empty())
+    {
+        Ptr<UnixTransport> transport = Create<UnixTransport>();
+        transport->Connect(unixSocket);         // server must be running before this line (or error)
+        gateway.Connect(transport);
+    }
+    else
+    {
+        gateway.Connect(serverAddress, serverPort); // server must be running before this line (or error)
+    }
+
+    // measure the processor time used by ns-3, most of which is spent waiting for the server
+    std::clock_t cpuStart = std::clock();
+    auto wallStart = std::chrono::steady_clock::now();
 
     Simulator::Run();
     Simulator::Destroy();
 
+    double cpuSeconds = double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    NS_LOG_INFO("Used " << cpuSeconds << " s of processor time in " << wallSeconds << " s of wall time ("
+        << (blockingWait ? "blocking" : "spinning") << " wait)");
+
+    Gateway::SendStatistics sendStatistics = gateway.GetSendStatistics();
+    NS_LOG_INFO("Sent " << sendStatistics.sentResponses << " responses (" << sendStatistics.sentBytes
+        << " bytes) with a mean latency of " << sendStatistics.meanLatency.As(Time::US) << " and a maximum latency of "
+        << sendStatistics.maxLatency.As(Time::US));
+
+    if (pacing > 0)
+    {
+        Gateway::PacingStatistics pacingStatistics = gateway.GetPacingStatistics();
+        NS_LOG_INFO("Missed " << pacingStatistics.misses << " of " << pacingStatistics.deadlines
+            << " wall clock deadlines with a minimum slack of " << pacingStatistics.minSlack.As(Time::MS)
+            << " and a maximum wake-up jitter of " << pacingStatistics.maxJitter.As(Time::US));
+    }
+
+    if (replayTransport && !replayResponses.empty())
+    {
+        NS_LOG_INFO("Replayed " << replayTransport->GetResponseCount() << " responses, of which "
+            << replayTransport->GetMismatchCount() << " did not match the recorded responses");
+    }
+
+    if (timingSummary)
+    {
+        std::ostringstream summary;
+        gateway.PrintTimingSummary(summary);
+        NS_LOG_INFO("Time spent in each stage of a step:\n" << summary.str());
+    }
+
     return 0;
 }
@@ -0,0 +1,297 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <cstring>
+
+#include "binary-codec.h"
+
+namespace ns3
+{
+
+namespace
+{
+
+// little-endian helper functions (independent of the host byte order)
+
+void
+AppendLittleEndian(std::string & buffer, uint64_t value, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+void
+WriteLittleEndian(char * data, uint64_t value, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        data[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+uint64_t
+ReadLittleEndian(const char * data, size_t size)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+/* ========== BINARY ENCODER ================================================ */
+
+BinaryEncoder::BinaryEncoder():
+    m_message(HEADER_SIZE, '\0')
+{
+    // do nothing
+}
+
+void
+BinaryEncoder::Clear()
+{
+    m_message.resize(HEADER_SIZE);
+}
+
+void
+BinaryEncoder::AddInt32(int32_t value)
+{
+    AppendInt32(m_message, value);
+}
+
+void
+BinaryEncoder::AddInt64(int64_t value)
+{
+    AppendInt64(m_message, value);
+}
+
+void
+BinaryEncoder::AddDouble(double value)
+{
+    AppendDouble(m_message, value);
+}
+
+void
+BinaryEncoder::AddBytes(const std::string & value)
+{
+    AppendBytes(m_message, value.data(), value.size());
+}
+
+const std::string &
+BinaryEncoder::Finish(int32_t seconds, uint32_t nanoseconds)
+{
+    WriteHeader(m_message, seconds, nanoseconds);
+    return m_message;
+}
+
+void
+BinaryEncoder::AppendInt32(std::string & buffer, int32_t value)
+{
+    buffer.push_back(static_cast<char>(FIELD_TYPE::INT32));
+    AppendLittleEndian(buffer, static_cast<uint32_t>(value), 4);
+}
+
+void
+BinaryEncoder::AppendInt64(std::string & buffer, int64_t value)
+{
+    buffer.push_back(static_cast<char>(FIELD_TYPE::INT64));
+    AppendLittleEndian(buffer, static_cast<uint64_t>(value), 8);
+}
+
+void
+BinaryEncoder::AppendDouble(std::string & buffer, double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    buffer.push_back(static_cast<char>(FIELD_TYPE::DOUBLE));
+    AppendLittleEndian(buffer, bits, 8);
+}
+
+void
+BinaryEncoder::AppendBytes(std::string & buffer, const char * data, size_t size)
+{
+    buffer.push_back(static_cast<char>(FIELD_TYPE::BYTES));
+    AppendLittleEndian(buffer, static_cast<uint32_t>(size), 4);
+    buffer.append(data, size);
+}
+
+void
+BinaryEncoder::WriteHeader(std::string & message, int32_t seconds, uint32_t nanoseconds)
+{
+    WriteLittleEndian(&message[0], static_cast<uint32_t>(seconds), 4);
+    WriteLittleEndian(&message[4], nanoseconds, 4);
+    WriteLittleEndian(&message[8], static_cast<uint32_t>(message.size() - HEADER_SIZE), 4);
+}
+
+/* ========== BINARY DECODER ================================================ */
+
+BinaryDecoder::BinaryDecoder(const char * data, size_t size):
+    m_data(data),
+    m_size(size),
+    m_offset(0)
+{
+    // do nothing
+}
+
+BinaryDecoder::BinaryDecoder(const std::string & fields):
+    BinaryDecoder(fields.data(), fields.size())
+{
+    // do nothing
+}
+
+bool
+BinaryDecoder::IsEmpty() const
+{
+    return m_offset >= m_size;
+}
+
+bool
+BinaryDecoder::ReadInt32(int32_t & value)
+{
+    if (!CheckField(BinaryEncoder::FIELD_TYPE::INT32, 4))
+    {
+        return false;
+    }
+    value = static_cast<int32_t>(static_cast<uint32_t>(ReadLittleEndian(m_data + m_offset + 1, 4)));
+    m_offset += 5;
+    return true;
+}
+
+bool
+BinaryDecoder::ReadInt64(int64_t & value)
+{
+    if (!CheckField(BinaryEncoder::FIELD_TYPE::INT64, 8))
+    {
+        return false;
+    }
+    value = static_cast<int64_t>(ReadLittleEndian(m_data + m_offset + 1, 8));
+    m_offset += 9;
+    return true;
+}
+
+bool
+BinaryDecoder::ReadDouble(double & value)
+{
+    if (!CheckField(BinaryEncoder::FIELD_TYPE::DOUBLE, 8))
+    {
+        return false;
+    }
+    uint64_t bits = ReadLittleEndian(m_data + m_offset + 1, 8);
+    std::memcpy(&value, &bits, sizeof(value));
+    m_offset += 9;
+    return true;
+}
+
+bool
+BinaryDecoder::ReadBytes(std::string & value)
+{
+    const char * field;
+    size_t size;
+    size_t offset = m_offset;
+    if (!ReadField(field, size))
+    {
+        return false;
+    }
+    if (static_cast<uint8_t>(field[0]) != BinaryEncoder::FIELD_TYPE::BYTES)
+    {
+        m_offset = offset;
+        return false;
+    }
+    value.assign(field + 5, size - 5);
+    return true;
+}
+
+bool
+BinaryDecoder::ReadField(const char * & field, size_t & size)
+{
+    if (IsEmpty())
+    {
+        return false;
+    }
+
+    size_t fieldSize;
+    switch (static_cast<uint8_t>(m_data[m_offset]))
+    {
+        case BinaryEncoder::FIELD_TYPE::INT32:
+            fieldSize = 5;
+            break;
+        case BinaryEncoder::FIELD_TYPE::INT64:
+        case BinaryEncoder::FIELD_TYPE::DOUBLE:
+            fieldSize = 9;
+            break;
+        case BinaryEncoder::FIELD_TYPE::BYTES:
+            if (m_size - m_offset < 5)
+            {
+                return false;
+            }
+            fieldSize = 5 + ReadLittleEndian(m_data + m_offset + 1, 4);
+            break;
+        default:
+            return false; // unknown field type
+    }
+    if (m_size - m_offset < fieldSize)
+    {
+        return false;
+    }
+
+    field = m_data + m_offset;
+    size = fieldSize;
+    m_offset += fieldSize;
+    return true;
+}
+
+bool
+BinaryDecoder::ReadHeader(const char * data, size_t size,
+                          int32_t & seconds, uint32_t & nanoseconds, uint32_t & payloadSize)
+{
+    if (size < BinaryEncoder::HEADER_SIZE)
+    {
+        return false;
+    }
+    seconds = static_cast<int32_t>(static_cast<uint32_t>(ReadLittleEndian(data, 4)));
+    nanoseconds = static_cast<uint32_t>(ReadLittleEndian(data + 4, 4));
+    payloadSize = static_cast<uint32_t>(ReadLittleEndian(data + 8, 4));
+    return true;
+}
+
+bool
+BinaryDecoder::CheckField(BinaryEncoder::FIELD_TYPE type, size_t valueSize) const
+{
+    return (m_size - m_offset > valueSize) && (static_cast<uint8_t>(m_data[m_offset]) == type);
+}
+
+} // namespace ns3
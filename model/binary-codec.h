@@ -0,0 +1,205 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#ifndef BINARY_CODEC_H
+#define BINARY_CODEC_H
+
+#include <cstdint>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * Encodes messages for the binary framing of the gateway protocol (see Gateway::FRAMING).
+ *
+ * A binary message is a fixed 12 byte header followed by a payload of typed fields, all in little-endian byte order:
+ *  1) header: int32 seconds, uint32 nanoseconds, uint32 payload size (in bytes, excluding the header)
+ *  2) payload: zero or more fields, where each field is a one byte FIELD_TYPE followed by its value:
+ *      INT32   4 byte signed integer
+ *      INT64   8 byte signed integer
+ *      DOUBLE  8 byte IEEE 754 double precision floating point
+ *      BYTES   uint32 length followed by that many bytes of arbitrary data
+ *
+ * The encoder is intended for the server side of a co-simulation, and can be re-used for consecutive messages:
+ *
+ *      BinaryEncoder encoder;
+ *      encoder.AddInt32(5);
+ *      encoder.AddDouble(1.5);
+ *      const std::string & message = encoder.Finish(10, 0); // time (10 s, 0 ns)
+ *      send(socket, message.data(), message.size(), 0);
+ *      encoder.Clear();
+ */
+class BinaryEncoder
+{
+    public:
+        enum FIELD_TYPE : uint8_t  // the type code that precedes each field value
+        {
+            INT32   = 1,
+            INT64   = 2,
+            DOUBLE  = 3,
+            BYTES   = 4
+        };
+
+        static const size_t HEADER_SIZE = 12;   //!< size in bytes of the message header
+
+        /**
+         * @brief Create an encoder for an empty message.
+         */
+        BinaryEncoder();
+
+        /**
+         * @brief Remove all fields, keeping the allocated memory for the next message.
+         */
+        void Clear();
+
+        /**
+         * @brief Append a field to the message payload.
+         * @param value the value of the field
+         */
+        void AddInt32(int32_t value);
+        void AddInt64(int64_t value);
+        void AddDouble(double value);
+        void AddBytes(const std::string & value);
+
+        /**
+         * @brief Complete the message by writing its header.
+         *
+         * The returned message remains valid until the next call to a non-const member function.
+         *
+         * @param seconds the seconds component of the message timestamp
+         * @param nanoseconds the nanoseconds component of the message timestamp
+         * @return the encoded message, including the header
+         */
+        const std::string & Finish(int32_t seconds, uint32_t nanoseconds);
+
+        /**
+         * @brief Append one encoded field to the end of a buffer.
+         * @param buffer the buffer to modify
+         * @param value the value of the field
+         */
+        static void AppendInt32(std::string & buffer, int32_t value);
+        static void AppendInt64(std::string & buffer, int64_t value);
+        static void AppendDouble(std::string & buffer, double value);
+        static void AppendBytes(std::string & buffer, const char * data, size_t size);
+
+        /**
+         * @brief Write the header at the start of a message.
+         *
+         * The message must begin with HEADER_SIZE bytes reserved for the header, followed by the payload.
+         *
+         * @param message the message to modify
+         * @param seconds the seconds component of the message timestamp
+         * @param nanoseconds the nanoseconds component of the message timestamp
+         */
+        static void WriteHeader(std::string & message, int32_t seconds, uint32_t nanoseconds);
+    private:
+        std::string m_message;  //!< The message header (HEADER_SIZE bytes) followed by the encoded fields
+};
+
+/**
+ * Decodes messages and fields of the binary framing of the gateway protocol (see BinaryEncoder for the format).
+ *
+ * A decoder reads fields in order from the start of a payload. Each Read function returns false, without advancing,
+ * if the next field does not have the requested type or if the payload is truncated.
+ */
+class BinaryDecoder
+{
+    public:
+        /**
+         * @brief Create a decoder for a sequence of encoded fields.
+         *
+         * The data is not copied, and must remain valid for the lifetime of the decoder.
+         *
+         * @param data the first byte of the encoded fields
+         * @param size the number of bytes
+         */
+        BinaryDecoder(const char * data, size_t size);
+
+        /**
+         * @brief Create a decoder for a sequence of encoded fields (such as one value received by Gateway::DoUpdate).
+         * @param fields the encoded fields, which must remain valid for the lifetime of the decoder
+         */
+        explicit BinaryDecoder(const std::string & fields);
+
+        /**
+         * @brief Check if all fields have been read.
+         * @return true if there are no more fields
+         */
+        bool IsEmpty() const;
+
+        /**
+         * @brief Read the next field.
+         * @param value the decoded value (unchanged on failure)
+         * @return true if the field was read
+         */
+        bool ReadInt32(int32_t & value);
+        bool ReadInt64(int64_t & value);
+        bool ReadDouble(double & value);
+        bool ReadBytes(std::string & value);
+
+        /**
+         * @brief Read the next field without decoding its value.
+         * @param field the first byte of the encoded field (starting with its type code)
+         * @param size the size of the encoded field in bytes
+         * @return true if a complete field was read
+         */
+        bool ReadField(const char * & field, size_t & size);
+
+        /**
+         * @brief Decode a message header.
+         * @param data the first byte of the message
+         * @param size the number of bytes available, which must be at least BinaryEncoder::HEADER_SIZE
+         * @param seconds the decoded seconds component of the message timestamp
+         * @param nanoseconds the decoded nanoseconds component of the message timestamp
+         * @param payloadSize the decoded size of the message payload
+         * @return true if the header was decoded
+         */
+        static bool ReadHeader(const char * data, size_t size,
+                               int32_t & seconds, uint32_t & nanoseconds, uint32_t & payloadSize);
+    private:
+        /**
+         * @brief Check the type of the next field and that its value is not truncated.
+         * @param type the expected type
+         * @param valueSize the expected size of the value in bytes
+         * @return true if the next field has the expected type and size
+         */
+        bool CheckField(BinaryEncoder::FIELD_TYPE type, size_t valueSize) const;
+
+        const char * m_data;    //!< The first byte of the encoded fields
+        size_t m_size;          //!< The number of bytes in m_data
+        size_t m_offset;        //!< The offset of the next field to read
+};
+
+} // namespace ns3
+
+#endif /* BINARY_CODEC_H */
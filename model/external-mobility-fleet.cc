@@ -0,0 +1,154 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include "external-mobility-fleet.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ExternalMobilityFleet");
+
+ExternalMobilityFleet::ExternalMobilityFleet()
+{
+    // do nothing
+}
+
+ExternalMobilityFleet::ExternalMobilityFleet(const NodeContainer & nodes)
+{
+    Add(nodes);
+}
+
+void
+ExternalMobilityFleet::Add(const NodeContainer & nodes)
+{
+    NS_LOG_FUNCTION(this << nodes.GetN());
+
+    m_models.reserve(m_models.size() + nodes.GetN());
+    m_positions.reserve(m_positions.size() + nodes.GetN());
+    m_velocities.reserve(m_velocities.size() + nodes.GetN());
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        Ptr<ExternalMobilityModel> model = nodes.Get(i)->GetObject<ExternalMobilityModel>();
+        if (!model)
+        {
+            NS_FATAL_ERROR("ERROR: node " << nodes.Get(i)->GetId() << " does not have an ExternalMobilityModel");
+        }
+        m_models.push_back(model);
+        m_positions.push_back(model->GetPosition());
+        m_velocities.push_back(model->GetVelocity());
+    }
+}
+
+uint32_t
+ExternalMobilityFleet::GetN() const
+{
+    return m_models.size();
+}
+
+Ptr<ExternalMobilityModel>
+ExternalMobilityFleet::Get(uint32_t index) const
+{
+    return m_models.at(index);
+}
+
+bool
+ExternalMobilityFleet::Update(uint32_t index, const Vector & position, const Vector & velocity)
+{
+    if (index >= m_models.size())
+    {
+        NS_FATAL_ERROR("ERROR: ExternalMobilityFleet::Update called with i=" << index << " for a fleet of "
+            << m_models.size() << " nodes");
+    }
+    return Apply(index, position, velocity);
+}
+
+uint32_t
+ExternalMobilityFleet::Update(const std::vector<Vector> & positions, const std::vector<Vector> & velocities)
+{
+    NS_LOG_FUNCTION(this);
+
+    CheckSize(positions, velocities);
+    uint32_t changed = 0;
+    for (uint32_t i = 0; i < m_models.size(); i++)
+    {
+        changed += Apply(i, positions[i], velocities[i]);
+    }
+    NS_LOG_LOGIC("updated " << changed << " of " << m_models.size() << " nodes");
+    return changed;
+}
+
+uint32_t
+ExternalMobilityFleet::Update(const std::vector<uint32_t> & indices,
+                              const std::vector<Vector> & positions,
+                              const std::vector<Vector> & velocities)
+{
+    NS_LOG_FUNCTION(this << indices.size());
+
+    CheckSize(positions, velocities);
+    uint32_t changed = 0;
+    for (uint32_t i : indices)
+    {
+        if (i >= m_models.size())
+        {
+            NS_FATAL_ERROR("ERROR: ExternalMobilityFleet::Update called with i=" << i << " for a fleet of "
+                << m_models.size() << " nodes");
+        }
+        changed += Apply(i, positions[i], velocities[i]);
+    }
+    NS_LOG_LOGIC("updated " << changed << " of " << indices.size() << " nodes");
+    return changed;
+}
+
+bool
+ExternalMobilityFleet::Apply(uint32_t index, const Vector & position, const Vector & velocity)
+{
+    // compare with the copies first, so that the model is only queried for an unchanged node
+    if (position == m_positions[index] && velocity == m_velocities[index] && !m_models[index]->GetDeadReckoning())
+    {
+        return false;
+    }
+    m_positions[index] = position;
+    m_velocities[index] = velocity;
+    return m_models[index]->SetPositionAndVelocity(position, velocity);
+}
+
+void
+ExternalMobilityFleet::CheckSize(const std::vector<Vector> & positions, const std::vector<Vector> & velocities) const
+{
+    if (positions.size() != m_models.size() || velocities.size() != m_models.size())
+    {
+        NS_FATAL_ERROR("ERROR: ExternalMobilityFleet::Update called with " << positions.size() << " positions and "
+            << velocities.size() << " velocities for a fleet of " << m_models.size() << " nodes");
+    }
+}
+
+} // namespace ns3
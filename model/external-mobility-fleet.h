@@ -0,0 +1,169 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#ifndef EXTERNAL_MOBILITY_FLEET_H
+#define EXTERNAL_MOBILITY_FLEET_H
+
+#include <cstdint>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/node-container.h"
+
+#include "external-mobility-model.h"
+
+namespace ns3
+{
+
+/**
+ * Applies mobility updates from an external process to the ExternalMobilityModel of many nodes at once.
+ *
+ * The fleet looks up the mobility model of each node once, when the node is added, and keeps the models in a flat
+ * array indexed in the order the nodes were added. Updates are then applied from contiguous arrays of positions and
+ * velocities (one element per node) without Object::GetObject lookups. The fleet also keeps a copy of the last
+ * position and velocity applied to each node, so that unchanged nodes are skipped without updating their models, and
+ * only the nodes that changed cause a CourseChange trace callback (see ExternalMobilityModel::SetPositionAndVelocity).
+ *
+ * Nodes whose model currently uses dead reckoning (see the ExternalMobilityModel DeadReckoning attribute) are never
+ * skipped, since an unchanged update still corrects the extrapolated position; their model decides whether to cause a
+ * CourseChange callback.
+ *
+ * The copies are only updated by the fleet. A value set directly on a model (for example, with
+ * MobilityModel::SetPosition) is not detected, so a later update by the fleet to the previously applied value is
+ * skipped.
+ */
+class ExternalMobilityFleet
+{
+    public:
+        /**
+         * @brief Create an empty fleet.
+         */
+        ExternalMobilityFleet();
+
+        /**
+         * @brief Create a fleet containing nodes (see ExternalMobilityFleet::Add).
+         * @param nodes the nodes to add
+         */
+        explicit ExternalMobilityFleet(const NodeContainer & nodes);
+
+        /**
+         * @brief Add nodes to the fleet, after any nodes already added.
+         *
+         * Exceptions:
+         *  1) each node must have an aggregated ExternalMobilityModel.
+         *
+         * @param nodes the nodes to add
+         */
+        void Add(const NodeContainer & nodes);
+
+        /**
+         * @brief Get the number of nodes in the fleet.
+         * @return the number of nodes
+         */
+        uint32_t GetN() const;
+
+        /**
+         * @brief Get the mobility model of one node.
+         * @param index the index of the node, which must be less than GetN
+         * @return the mobility model
+         */
+        Ptr<ExternalMobilityModel> Get(uint32_t index) const;
+
+        /**
+         * @brief Set the position and velocity of one node, if either changed.
+         *
+         * Exceptions:
+         *  1) the index must be less than GetN.
+         *
+         * @param index the index of the node
+         * @param position the position to set
+         * @param velocity the velocity to set
+         * @return true if the node reported a course change
+         */
+        bool Update(uint32_t index, const Vector & position, const Vector & velocity);
+
+        /**
+         * @brief Set the position and velocity of every node, skipping the nodes that did not change.
+         *
+         * Exceptions:
+         *  1) both arrays must contain GetN elements.
+         *
+         * @param positions the position of each node
+         * @param velocities the velocity of each node
+         * @return the number of nodes that reported a course change
+         */
+        uint32_t Update(const std::vector<Vector> & positions, const std::vector<Vector> & velocities);
+
+        /**
+         * @brief Set the position and velocity of some nodes, skipping the nodes that did not change.
+         *
+         * Only the nodes in indices are updated, using their elements of the position and velocity arrays. This suits
+         * arrays that persist between updates, such as the records of a SparseRecord layout together with
+         * TypedGateway::GetUpdatedRecords.
+         *
+         * Exceptions:
+         *  1) both arrays must contain GetN elements.
+         *  2) each index must be less than GetN.
+         *
+         * @param indices the indices of the nodes to update
+         * @param positions the position of each node
+         * @param velocities the velocity of each node
+         * @return the number of nodes that reported a course change
+         */
+        uint32_t Update(const std::vector<uint32_t> & indices,
+                        const std::vector<Vector> & positions,
+                        const std::vector<Vector> & velocities);
+    private:
+        /**
+         * @brief Set the position and velocity of one node without bounds checking, if either changed.
+         * @param index the index of the node
+         * @param position the position to set
+         * @param velocity the velocity to set
+         * @return true if the node reported a course change
+         */
+        bool Apply(uint32_t index, const Vector & position, const Vector & velocity);
+
+        /**
+         * @brief Check that arrays contain one element per node (fatal error otherwise).
+         * @param positions the position array
+         * @param velocities the velocity array
+         */
+        void CheckSize(const std::vector<Vector> & positions, const std::vector<Vector> & velocities) const;
+
+        std::vector<Ptr<ExternalMobilityModel>> m_models;   //!< The mobility model of each node
+        std::vector<Vector> m_positions;    //!< The last position applied to each node
+        std::vector<Vector> m_velocities;   //!< The last velocity applied to each node
+};
+
+} // namespace ns3
+
+#endif /* EXTERNAL_MOBILITY_FLEET_H */
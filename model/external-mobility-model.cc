@@ -32,9 +32,26 @@
 
 #include "external-mobility-model.h"
 
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+
 namespace ns3
 {
 
+namespace
+{
+
+const double VELOCITY_TOLERANCE = 1e-9; // the velocity error (in m/s) below which a velocity is unchanged
+
+bool
+IsVelocityChanged(const Vector& velocity, const Vector& current)
+{
+    return CalculateDistance(velocity, current) > VELOCITY_TOLERANCE;
+}
+
+} // namespace
+
 NS_OBJECT_ENSURE_REGISTERED(ExternalMobilityModel);
 
 TypeId
@@ -44,11 +61,26 @@ ExternalMobilityModel::GetTypeId()
         TypeId("ns3::ExternalMobilityModel")
             .SetParent<MobilityModel>()
             .SetGroupName("Mobility")
-            .AddConstructor<ExternalMobilityModel>();
+            .AddConstructor<ExternalMobilityModel>()
+            .AddAttribute(
+                "DeadReckoning",
+                "Extrapolate the position between updates using the velocity and acceleration.",
+                BooleanValue(false),
+                MakeBooleanAccessor(&ExternalMobilityModel::m_deadReckoning),
+                MakeBooleanChecker())
+            .AddAttribute(
+                "ResyncThreshold",
+                "The distance (in meters) between an updated position and the current position that causes a "
+                "CourseChange callback.",
+                DoubleValue(0),
+                MakeDoubleAccessor(&ExternalMobilityModel::m_resyncThreshold),
+                MakeDoubleChecker<double>(0));
     return tid;
 }
 
-ExternalMobilityModel::ExternalMobilityModel()
+ExternalMobilityModel::ExternalMobilityModel():
+    m_deadReckoning(false),
+    m_resyncThreshold(0)
 {
     // do nothing
 }
@@ -61,32 +93,107 @@ ExternalMobilityModel::~ExternalMobilityModel()
 void
 ExternalMobilityModel::SetVelocity(const Vector& velocity)
 {
-    if (velocity != m_velocity)
+    Rebase();
+    bool resync = IsVelocityChanged(velocity, m_velocity);
+    m_velocity = velocity;
+    if (resync)
     {
-        m_velocity = velocity;
         NotifyCourseChange();
     }
 }
 
+bool
+ExternalMobilityModel::SetPositionAndVelocity(const Vector& position, const Vector& velocity)
+{
+    Rebase();
+    bool resync = CalculateDistance(position, m_position) > m_resyncThreshold
+        || IsVelocityChanged(velocity, m_velocity);
+    m_position = position;
+    m_velocity = velocity;
+    if (resync)
+    {
+        NotifyCourseChange();
+    }
+    return resync;
+}
+
+void
+ExternalMobilityModel::SetAcceleration(const Vector& acceleration)
+{
+    Rebase();
+    if (acceleration != m_acceleration)
+    {
+        m_acceleration = acceleration;
+        if (m_deadReckoning)
+        {
+            NotifyCourseChange();
+        }
+    }
+}
+
+Vector
+ExternalMobilityModel::GetAcceleration() const
+{
+    return m_acceleration;
+}
+
+bool
+ExternalMobilityModel::GetDeadReckoning() const
+{
+    return m_deadReckoning;
+}
+
+void
+ExternalMobilityModel::Rebase()
+{
+    Time now = Simulator::Now();
+    if (m_deadReckoning && now != m_lastUpdate)
+    {
+        Vector position = DoGetPosition();
+        m_velocity = DoGetVelocity();
+        m_position = position;
+    }
+    m_lastUpdate = now;
+}
+
 void
 ExternalMobilityModel::DoSetPosition(const Vector& position)
 {
-    if (position != m_position)
+    Rebase();
+    // a change to only the position is not reported, unless it corrects an extrapolated position (see the class)
+    bool resync = m_deadReckoning && CalculateDistance(position, m_position) > m_resyncThreshold;
+    m_position = position;
+    if (resync)
     {
-        m_position = position; // this should check for a course change
+        NotifyCourseChange();
     }
 }
 
 Vector
 ExternalMobilityModel::DoGetPosition() const
 {
-    return m_position;
+    if (!m_deadReckoning)
+    {
+        return m_position;
+    }
+    double t = (Simulator::Now() - m_lastUpdate).GetSeconds();
+    double half = 0.5 * t * t;
+    return Vector(m_position.x + m_velocity.x * t + m_acceleration.x * half,
+                  m_position.y + m_velocity.y * t + m_acceleration.y * half,
+                  m_position.z + m_velocity.z * t + m_acceleration.z * half);
 }
 
 Vector
 ExternalMobilityModel::DoGetVelocity() const
 {
-    return m_velocity;
+    if (!m_deadReckoning)
+    {
+        return m_velocity;
+    }
+    double t = (Simulator::Now() - m_lastUpdate).GetSeconds();
+    return Vector(m_velocity.x + m_acceleration.x * t,
+                  m_velocity.y + m_acceleration.y * t,
+                  m_velocity.z + m_acceleration.z * t);
 }
 
 } // namespace ns3
@@ -34,6 +34,7 @@
 #define EXTERNAL_MOBILITY_MODEL_H
 
 #include "ns3/mobility-model.h"
+#include "ns3/nstime.h"
 
 namespace ns3
 {
@@ -43,10 +44,20 @@ namespace ns3
  * As the external process updates the node mobility (including any and all changes to position), explicit calls to
  * MobilityModel::SetPosition and ExternalMobilityModel::SetVelocity are required to reflect the values in this model.
  *
- * Due to a limitation of the current implementation, only ExternalMobilityModel::SetVelocity can cause a CourseChange 
- * trace callback (position updates are ignored). Therefore, the recommended call order for mobility updates is to set
- * the position first and then update the velocity. This will result in at most one CourseChange callback, during which
- * both position and velocity will have consistent values.
+ * Due to a limitation of the current implementation, MobilityModel::SetPosition does not cause a CourseChange trace
+ * callback without dead reckoning (only ExternalMobilityModel::SetVelocity does). Therefore, the recommended call order
+ * for separate updates is to set the position first and then update the velocity. This will result in at most one
+ * CourseChange callback, during which both position and velocity will have consistent values. Alternatively,
+ * ExternalMobilityModel::SetPositionAndVelocity sets both values, and also causes a CourseChange callback when only the
+ * position changed. A velocity is only considered changed when it differs by more than 1e-9 m/s.
+ *
+ * By default, the position is constant between updates. When the DeadReckoning attribute is enabled, the position is
+ * instead extrapolated from the last update using the velocity and acceleration (see SetAcceleration), so nodes keep
+ * moving between updates from the external process. Each update then replaces the extrapolated values. Every setter
+ * only causes a CourseChange callback when the new position differs from the extrapolated position by more than the
+ * ResyncThreshold attribute, or when the new velocity differs from the extrapolated velocity (so rounding errors of
+ * the extrapolation are not reported). Setting the position and then the velocity may then cause two callbacks, so
+ * ExternalMobilityModel::SetPositionAndVelocity is recommended instead.
  */
 class ExternalMobilityModel : public MobilityModel
 {
@@ -69,15 +80,58 @@ class ExternalMobilityModel : public MobilityModel
          * @param velocity the value to set
          */
         void SetVelocity(const Vector& velocity);
+
+        /**
+         * @brief Set the position and velocity together, with at most one CourseChange trace callback.
+         *
+         * Unlike MobilityModel::SetPosition without dead reckoning, a change to only the position also causes a
+         * CourseChange callback, if the change is larger than the ResyncThreshold attribute.
+         *
+         * @param position the position to set
+         * @param velocity the velocity to set
+         * @return true if a CourseChange callback occurred
+         */
+        bool SetPositionAndVelocity(const Vector& position, const Vector& velocity);
+
+        /**
+         * @brief Set the 3-dimensional acceleration used to extrapolate the position and velocity.
+         *
+         * The acceleration is only used when the DeadReckoning attribute is enabled.
+         *
+         * @param acceleration the value to set
+         */
+        void SetAcceleration(const Vector& acceleration);
+
+        /**
+         * @brief Get the 3-dimensional acceleration.
+         * @return the acceleration
+         */
+        Vector GetAcceleration() const;
+
+        /**
+         * @brief Check if the position is extrapolated between updates (see the DeadReckoning attribute).
+         * @return true if dead reckoning is enabled
+         */
+        bool GetDeadReckoning() const;
     private:
+        /**
+         * @brief Move the last update to the current time, replacing the position and velocity with their
+         * extrapolated values when dead reckoning is enabled.
+         */
+        void Rebase();
+
         void DoSetPosition(const Vector& position) override;
 
         Vector DoGetPosition() const override;
 
         Vector DoGetVelocity() const override;
 
-        Vector m_position;  //!< the 3-dimensional cartesian coordinates
-        Vector m_velocity;  //!< the 3-dimensional velocity
+        Vector m_position;          //!< the 3-dimensional cartesian coordinates
+        Vector m_velocity;          //!< the 3-dimensional velocity
+        Vector m_acceleration;      //!< the 3-dimensional acceleration
+        Time m_lastUpdate;          //!< the simulation time of the last update
+        bool m_deadReckoning;       //!< whether the position is extrapolated between updates
+        double m_resyncThreshold;   //!< the position error (in meters) that causes a CourseChange callback
 };
 
 } // namespace ns3
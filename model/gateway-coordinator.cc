@@ -0,0 +1,210 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include "gateway-coordinator.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("GatewayCoordinator");
+
+GatewayCoordinator::GatewayCoordinator():
+    m_idleMode(Gateway::IDLE_MODE::SPIN),
+    m_timePause(Time::Max()),
+    m_timeStop(Seconds(0)),
+    m_terminated(false),
+    m_idleEventCount(0),
+    m_idleWaitEventCount(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+GatewayCoordinator::~GatewayCoordinator()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+GatewayCoordinator::Add(Gateway & gateway)
+{
+    NS_LOG_FUNCTION(this << &gateway);
+
+    if (gateway.m_state != Gateway::STATE::CREATED)
+    {
+        NS_FATAL_ERROR("ERROR: GatewayCoordinator::Add must be called before Gateway::Connect");
+    }
+    if (gateway.m_coordinator != nullptr)
+    {
+        NS_FATAL_ERROR("ERROR: GatewayCoordinator::Add called for a gateway that is already coordinated");
+    }
+    gateway.m_coordinator = this;
+    m_federates.push_back({&gateway, false});
+}
+
+void
+GatewayCoordinator::SetIdleMode(Gateway::IDLE_MODE mode)
+{
+    NS_LOG_FUNCTION(this << mode);
+
+    m_idleMode = mode;
+}
+
+Time
+GatewayCoordinator::GetGrantedTime() const
+{
+    Time granted = Time::Max();
+    for (const Federate & federate : m_federates)
+    {
+        if (federate.active && federate.gateway->m_timePause < granted)
+        {
+            granted = federate.gateway->m_timePause;
+        }
+    }
+    return granted;
+}
+
+uint32_t
+GatewayCoordinator::GetActiveCount() const
+{
+    uint32_t count = 0;
+    for (const Federate & federate : m_federates)
+    {
+        count += federate.active;
+    }
+    return count;
+}
+
+void
+GatewayCoordinator::Activate(Gateway * gateway)
+{
+    NS_LOG_FUNCTION(this << gateway);
+
+    Find(gateway)->active = true;
+    UpdateGrant();
+}
+
+void
+GatewayCoordinator::UpdateGrant()
+{
+    Time granted = GetGrantedTime();
+    if (granted == m_timePause && m_eventWait.IsPending())
+    {
+        return; // another federate still holds back ns-3 at the same time
+    }
+
+    if (m_eventWait.IsPending())
+    {
+        m_eventWait.Cancel();
+    }
+    m_timePause = granted;
+    if (granted != Time::Max()) // otherwise, no federate holds back ns-3
+    {
+        NS_LOG_LOGIC("pausing at " << granted);
+        m_eventWait = Simulator::Schedule(granted - Simulator::Now(), &GatewayCoordinator::WaitForNextUpdate, this);
+    }
+}
+
+void
+GatewayCoordinator::Terminate(Gateway * gateway)
+{
+    NS_LOG_FUNCTION(this << gateway);
+
+    Find(gateway)->active = false;
+    m_terminated = true;
+    m_timeStop = Max(m_timeStop, gateway->m_timePause);
+    UpdateGrant();
+
+    if (GetActiveCount() == 0)
+    {
+        NS_LOG_INFO("GatewayCoordinator stopping the simulation at " << m_timeStop << " (every federate terminated)");
+        Simulator::Stop(Max(m_timeStop, Simulator::Now()) - Simulator::Now());
+    }
+}
+
+void
+GatewayCoordinator::Remove(Gateway * gateway)
+{
+    NS_LOG_FUNCTION(this << gateway);
+
+    Federate * federate = Find(gateway);
+    if (federate->active)
+    {
+        federate->active = false;
+        UpdateGrant();
+    }
+}
+
+void
+GatewayCoordinator::WaitForNextUpdate() // do not add log output to this function
+{
+    // each federate paused at this time starts measuring its server wait (see Gateway::StepTiming)
+    for (Federate & federate : m_federates)
+    {
+        Gateway * gateway = federate.gateway;
+        if (federate.active && !gateway->m_paused && gateway->m_timePause == m_timePause
+            && gateway->IsTimingEnabled())
+        {
+            gateway->m_paused = true;
+            gateway->m_pausedAt = std::chrono::steady_clock::now();
+        }
+    }
+    if (m_idleMode == Gateway::IDLE_MODE::BLOCK)
+    {
+        BlockUntilReceive();
+    }
+    // pause Simulator time progression until this event is cancelled
+    m_eventWait = Simulator::ScheduleNow(&GatewayCoordinator::WaitForNextUpdate, this);
+}
+
+void
+GatewayCoordinator::BlockUntilReceive() // do not add log output to this function
+{
+    if (Gateway::IsOnlyWaiting(m_idleEventCount, m_idleWaitEventCount))
+    {
+        Gateway::WaitForAnyReceive(nullptr); // woken by any gateway, including the federates
+    }
+}
+
+GatewayCoordinator::Federate *
+GatewayCoordinator::Find(Gateway * gateway)
+{
+    for (Federate & federate : m_federates)
+    {
+        if (federate.gateway == gateway)
+        {
+            return &federate;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace ns3
@@ -0,0 +1,174 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#ifndef GATEWAY_COORDINATOR_H
+#define GATEWAY_COORDINATOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+#include "gateway.h"
+
+namespace ns3
+{
+
+/**
+ * Couples ns-3 to several servers (federates) at once, each through its own gateway.
+ *
+ * Each gateway keeps its own connection, message framing, and Gateway::DoUpdate handler, and sends its own responses.
+ * Instead of pausing ns-3 at its own granted time, each coordinated gateway reports its granted time to the
+ * coordinator, which lets ns-3 advance only to the minimum granted time across every connected federate. A federate
+ * that steps less often (or grants a larger lookahead) therefore never holds back ns-3 beyond its granted time, and a
+ * faster federate is only held back by the slower federate's granted time. The coordinator only reschedules its pause
+ * when a step changes the minimum granted time.
+ *
+ * The first message of each federate is its reference time, so every federate starts at ns-3 time 0. A federate that
+ * sends the terminate message no longer holds back ns-3, and the simulation stops at the largest last granted time
+ * once every federate has terminated. A federate whose connection closes without the terminate message also stops
+ * holding back ns-3.
+ *
+ * The coordinator must exist until Simulator::Destroy, like the gateways it coordinates.
+ */
+class GatewayCoordinator
+{
+    public:
+        GatewayCoordinator();
+        ~GatewayCoordinator();
+
+        GatewayCoordinator(const GatewayCoordinator &) = delete;
+        GatewayCoordinator & operator=(const GatewayCoordinator &) = delete;
+
+        /**
+         * @brief Coordinate the time progression of a gateway with the other federates.
+         *
+         * The gateway holds back ns-3 once it is connected (see Gateway::Connect).
+         *
+         * Exceptions:
+         *  1) this function must be called before Gateway::Connect.
+         *  2) a gateway can only be added to one coordinator, once.
+         *
+         * @param gateway the gateway of one federate
+         */
+        void Add(Gateway & gateway);
+
+        /**
+         * @brief Set how the main simulator thread waits while time progression is paused.
+         *
+         * This replaces the idle mode of each coordinated gateway (see Gateway::SetIdleMode). In the BLOCK mode, the
+         * main thread is woken by a message from any federate.
+         *
+         * @param mode the idle mode to use (default: SPIN)
+         */
+        void SetIdleMode(Gateway::IDLE_MODE mode);
+
+        /**
+         * @brief Get the time up to which ns-3 may advance.
+         * @return the minimum granted time across the connected federates, or Time::Max() if there are none
+         */
+        Time GetGrantedTime() const;
+
+        /**
+         * @brief Get the number of federates that still hold back ns-3.
+         * @return the number of connected federates that have not terminated or closed
+         */
+        uint32_t GetActiveCount() const;
+    private:
+        friend class Gateway;
+
+        struct Federate     // the coordination state of one gateway
+        {
+            Gateway * gateway;  //!< The gateway of the federate
+            bool active;        //!< True while the federate holds back ns-3
+        };
+
+        /**
+         * @brief Start holding back ns-3 with a connected gateway (called by Gateway::Connect).
+         * @param gateway the connected gateway
+         */
+        void Activate(Gateway * gateway);
+
+        /**
+         * @brief Move the pause to the new minimum granted time (called by Gateway::GrantTime).
+         */
+        void UpdateGrant();
+
+        /**
+         * @brief Stop holding back ns-3 with a gateway that received the terminate message.
+         *
+         * Once no federate is active, Simulator::Stop is scheduled for the largest granted time of the terminated
+         * federates.
+         *
+         * @param gateway the gateway that received the terminate message
+         */
+        void Terminate(Gateway * gateway);
+
+        /**
+         * @brief Stop holding back ns-3 with a gateway that stopped (called by Gateway::Stop).
+         * @param gateway the stopped gateway
+         */
+        void Remove(Gateway * gateway);
+
+        /**
+         * @brief Pause the simulation by scheduling events to execute now until the granted time changes.
+         */
+        void WaitForNextUpdate();
+
+        /**
+         * @brief Block the main thread until any gateway receives a message or its connection closes.
+         *
+         * This only blocks if no event other than a wait event was executed since the previous call (see
+         * Gateway::BlockUntilReceive).
+         */
+        void BlockUntilReceive();
+
+        /**
+         * @brief Find the federate of a gateway.
+         * @param gateway the gateway
+         * @return the federate, or nullptr if the gateway was not added
+         */
+        Federate * Find(Gateway * gateway);
+
+        std::vector<Federate> m_federates;  //!< The coordinated gateways, in the order they were added
+        Gateway::IDLE_MODE m_idleMode;      //!< How Gateway::WaitForNextUpdate pauses ns-3 time progression
+        EventId m_eventWait;                //!< If IsPending, an event to call WaitForNextUpdate in an infinite loop
+        Time m_timePause;                   //!< The time at which m_eventWait pauses ns-3 time progression
+        Time m_timeStop;                    //!< The largest granted time of the terminated federates
+        bool m_terminated;                  //!< True once a federate received the terminate message
+        uint64_t m_idleEventCount;          //!< Simulator event count when WaitForNextUpdate last executed
+        uint64_t m_idleWaitEventCount;      //!< Shared wait event count when WaitForNextUpdate last executed
+};
+
+} // namespace ns3
+
+#endif /* GATEWAY_COORDINATOR_H */
@@ -0,0 +1,293 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include "gateway-message.h"
+
+#include "binary-codec.h"
+
+#include "ns3/fatal-error.h"
+
+namespace ns3
+{
+
+GatewayMessage::GatewayMessage():
+    m_first(0),
+    m_binary(false)
+{
+    // do nothing
+}
+
+void
+GatewayMessage::Assign(std::string & data)
+{
+    m_buffer.swap(data);
+    m_fields.clear();
+    m_first = 0;
+}
+
+void
+GatewayMessage::SplitText(const std::string & delimiter)
+{
+    m_binary = false;
+
+    // a single pass over the buffer, recording the location of each field
+    size_t begin = 0;
+    size_t end;
+    while ((end = m_buffer.find(delimiter, begin)) != std::string::npos)
+    {
+        m_fields.push_back({static_cast<uint32_t>(begin), static_cast<uint32_t>(end - begin)});
+        begin = end + delimiter.size();
+    }
+    m_fields.push_back({static_cast<uint32_t>(begin), static_cast<uint32_t>(m_buffer.size() - begin)});
+}
+
+bool
+GatewayMessage::SplitBinary(size_t offset)
+{
+    m_binary = true;
+    if (offset > m_buffer.size())
+    {
+        return false;
+    }
+
+    BinaryDecoder decoder(m_buffer.data() + offset, m_buffer.size() - offset);
+    const char * field;
+    size_t size;
+    while (decoder.ReadField(field, size))
+    {
+        m_fields.push_back({static_cast<uint32_t>(field - m_buffer.data()), static_cast<uint32_t>(size)});
+    }
+    return decoder.IsEmpty();
+}
+
+void
+GatewayMessage::RemoveFront(uint32_t count)
+{
+    if (count > GetSize())
+    {
+        NS_FATAL_ERROR("ERROR: GatewayMessage::RemoveFront called with " << count << " for a size of " << GetSize());
+    }
+    m_first += count;
+}
+
+uint32_t
+GatewayMessage::GetSize() const
+{
+    return m_fields.size() - m_first;
+}
+
+std::string_view
+GatewayMessage::Get(uint32_t index) const
+{
+    if (index >= GetSize())
+    {
+        NS_FATAL_ERROR("ERROR: GatewayMessage::Get called with i=" << index << " for a size of " << GetSize());
+    }
+    return (*this)[index];
+}
+
+std::string_view
+GatewayMessage::operator[](uint32_t index) const
+{
+    const Field & field = m_fields[m_first + index];
+    return std::string_view(m_buffer.data() + field.offset, field.size);
+}
+
+bool
+GatewayMessage::GetInt(uint32_t index, int32_t & value) const
+{
+    int64_t result;
+    if (!GetInt(index, result)
+        || result < std::numeric_limits<int32_t>::min() || result > std::numeric_limits<int32_t>::max())
+    {
+        return false;
+    }
+    value = static_cast<int32_t>(result);
+    return true;
+}
+
+bool
+GatewayMessage::GetInt(uint32_t index, int64_t & value) const
+{
+    if (index >= GetSize())
+    {
+        return false;
+    }
+
+    std::string_view field = (*this)[index];
+    if (m_binary)
+    {
+        BinaryDecoder decoder(field.data(), field.size());
+        int32_t value32;
+        if (decoder.ReadInt32(value32))
+        {
+            value = value32;
+            return true;
+        }
+        return decoder.ReadInt64(value);
+    }
+
+    int64_t result;
+    std::from_chars_result parsed = std::from_chars(field.data(), field.data() + field.size(), result);
+    if (parsed.ec != std::errc() || parsed.ptr != field.data() + field.size())
+    {
+        return false;
+    }
+    value = result;
+    return true;
+}
+
+bool
+GatewayMessage::GetDouble(uint32_t index, double & value) const
+{
+    return (index < GetSize()) && ToDouble((*this)[index], value);
+}
+
+bool
+GatewayMessage::GetVector(uint32_t index, Vector & value) const
+{
+    double values[3];
+    if (!ParseDoubles(index, values, 3))
+    {
+        return false;
+    }
+    value = Vector(values[0], values[1], values[2]);
+    return true;
+}
+
+bool
+GatewayMessage::ParseDoubles(uint32_t index, double * values, uint32_t count) const
+{
+    if (index > GetSize() || count > GetSize() - index)
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (!ToDouble((*this)[index + i], values[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+GatewayMessage::ToDouble(std::string_view field, double & value) const
+{
+    if (m_binary)
+    {
+        BinaryDecoder decoder(field.data(), field.size());
+        int32_t value32;
+        int64_t value64;
+        if (decoder.ReadDouble(value))
+        {
+            return true;
+        }
+        else if (decoder.ReadInt32(value32))
+        {
+            value = value32;
+            return true;
+        }
+        else if (decoder.ReadInt64(value64))
+        {
+            value = static_cast<double>(value64);
+            return true;
+        }
+        return false;
+    }
+
+    double result;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    std::from_chars_result parsed = std::from_chars(field.data(), field.data() + field.size(), result);
+    if (parsed.ec != std::errc() || parsed.ptr != field.data() + field.size())
+    {
+        return false;
+    }
+#else
+    // without floating point std::from_chars, copy the field to add the terminator required by strtod
+    char buffer[64];
+    if (field.empty() || field.size() >= sizeof(buffer))
+    {
+        return false;
+    }
+    std::memcpy(buffer, field.data(), field.size());
+    buffer[field.size()] = '\0';
+    char * end;
+    result = std::strtod(buffer, &end);
+    if (end != buffer + field.size())
+    {
+        return false;
+    }
+#endif
+    value = result;
+    return true;
+}
+
+std::vector<std::string>
+GatewayMessage::ToVector() const
+{
+    std::vector<std::string> values;
+    values.reserve(GetSize());
+    for (uint32_t i = 0; i < GetSize(); i++)
+    {
+        values.emplace_back((*this)[i]);
+    }
+    return values;
+}
+
+const std::string &
+GatewayMessage::GetBuffer() const
+{
+    return m_buffer;
+}
+
+std::ostream &
+operator<<(std::ostream & os, const GatewayMessage & message)
+{
+    for (uint32_t i = 0; i < message.GetSize(); i++)
+    {
+        if (i != 0)
+        {
+            os << " ";
+        }
+        os << message[i];
+    }
+    return os;
+}
+
+} // namespace ns3
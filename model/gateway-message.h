@@ -0,0 +1,209 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#ifndef GATEWAY_MESSAGE_H
+#define GATEWAY_MESSAGE_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ns3/vector.h"
+
+namespace ns3
+{
+
+/**
+ * One message received by a Gateway, split into fields without copying them.
+ *
+ * The message owns a single buffer containing the received data, and records the offset and size of each field within
+ * that buffer. The fields are accessed as std::string_view objects that remain valid while the message is unchanged.
+ * A message (including its buffers) can be re-used for consecutive received messages to avoid memory allocations.
+ *
+ * With the TEXT framing, each field is one delimiter-separated string. With the BINARY framing, each field is one
+ * encoded field (including its type code) that can be read using BinaryDecoder.
+ *
+ * The typed accessors (GetInt, GetDouble, GetVector, and ParseDoubles) convert fields of either framing without
+ * allocating memory or throwing exceptions: TEXT fields are parsed with std::from_chars, and BINARY fields are decoded
+ * from INT32, INT64, or DOUBLE fields. Each accessor returns false if a field is missing or cannot be converted.
+ */
+class GatewayMessage
+{
+    public:
+        /**
+         * @brief Create an empty message.
+         */
+        GatewayMessage();
+
+        /**
+         * @brief Replace the message content by swapping buffers (no data is copied).
+         *
+         * Any previous fields are removed. After this call, the argument contains the previous message buffer.
+         *
+         * @param data the received message data
+         */
+        void Assign(std::string & data);
+
+        /**
+         * @brief Split the message content into fields separated by a delimiter (TEXT framing).
+         * @param delimiter the non-empty character sequence that separates fields
+         */
+        void SplitText(const std::string & delimiter);
+
+        /**
+         * @brief Split the message content into encoded fields (BINARY framing).
+         * @param offset the offset of the first field (the size of the message header)
+         * @return false if the message contains an unknown or truncated field
+         */
+        bool SplitBinary(size_t offset);
+
+        /**
+         * @brief Remove fields from the front of the message (such as the message header).
+         *
+         * Exceptions:
+         *  1) the message must contain at least count fields.
+         *
+         * @param count the number of fields to remove
+         */
+        void RemoveFront(uint32_t count);
+
+        /**
+         * @brief Get the number of fields.
+         * @return the number of fields
+         */
+        uint32_t GetSize() const;
+
+        /**
+         * @brief Get one field.
+         *
+         * Exceptions:
+         *  1) the index must be less than GetSize.
+         *
+         * @param index the index of the field
+         * @return a view of the field content
+         */
+        std::string_view Get(uint32_t index) const;
+
+        /**
+         * @brief Get one field without bounds checking.
+         * @param index the index of the field, which must be less than GetSize
+         * @return a view of the field content
+         */
+        std::string_view operator[](uint32_t index) const;
+
+        /**
+         * @brief Convert one field to an integer.
+         *
+         * TEXT fields must contain a complete decimal integer. BINARY fields must be INT32 or INT64 fields whose value
+         * fits in the requested type.
+         *
+         * @param index the index of the field
+         * @param value the converted value (unchanged on failure)
+         * @return true if the field exists and was converted
+         */
+        bool GetInt(uint32_t index, int32_t & value) const;
+        bool GetInt(uint32_t index, int64_t & value) const;
+
+        /**
+         * @brief Convert one field to a floating point value.
+         *
+         * TEXT fields must contain a complete decimal or scientific number. BINARY fields can be DOUBLE, INT32, or
+         * INT64 fields.
+         *
+         * @param index the index of the field
+         * @param value the converted value (unchanged on failure)
+         * @return true if the field exists and was converted
+         */
+        bool GetDouble(uint32_t index, double & value) const;
+
+        /**
+         * @brief Convert three consecutive fields (x, y, z) to a vector.
+         * @param index the index of the first field
+         * @param value the converted value (unchanged on failure)
+         * @return true if all three fields exist and were converted
+         */
+        bool GetVector(uint32_t index, Vector & value) const;
+
+        /**
+         * @brief Convert consecutive fields to floating point values (see GetDouble).
+         * @param index the index of the first field
+         * @param values the first of count values to write (the content is unspecified on failure)
+         * @param count the number of fields to convert
+         * @return true if all count fields exist and were converted
+         */
+        bool ParseDoubles(uint32_t index, double * values, uint32_t count) const;
+
+        /**
+         * @brief Copy the fields into separate strings (for compatibility with the std::vector<std::string> API).
+         * @return a copy of the fields
+         */
+        std::vector<std::string> ToVector() const;
+
+        /**
+         * @brief Get the message content.
+         * @return the buffer containing the complete received message
+         */
+        const std::string & GetBuffer() const;
+    private:
+        struct Field
+        {
+            uint32_t offset;    //!< Offset of the first byte of the field within m_buffer
+            uint32_t size;      //!< Size of the field in bytes
+        };
+
+        /**
+         * @brief Convert one field to a floating point value without bounds checking.
+         * @param field the field content
+         * @param value the converted value (unchanged on failure)
+         * @return true if the field was converted
+         */
+        bool ToDouble(std::string_view field, double & value) const;
+
+        std::string m_buffer;       //!< The received message content
+        std::vector<Field> m_fields; //!< The location of each field within m_buffer
+        uint32_t m_first;           //!< The index within m_fields of the first field (after RemoveFront)
+        bool m_binary;              //!< True if the fields were split using SplitBinary
+};
+
+/**
+ * @brief Output the fields of a message, separated by spaces.
+ * @param os the output stream
+ * @param message the message to output
+ * @return the output stream
+ */
+std::ostream & operator<<(std::ostream & os, const GatewayMessage & message);
+
+} // namespace ns3
+
+#endif /* GATEWAY_MESSAGE_H */
@@ -0,0 +1,366 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+#include <cerrno>
+
+#include "gateway-reactor.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("GatewayReactor");
+
+GatewayReactor::GatewayReactor():
+    m_threadCount(1),
+    m_nextWorker(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+GatewayReactor::~GatewayReactor()
+{
+    NS_LOG_FUNCTION(this);
+
+    for (std::unique_ptr<Worker> & worker : m_workers)
+    {
+        worker->stopping = true;
+        uint64_t value = 1;
+        if (write(worker->wakeup, &value, sizeof(value)) != sizeof(value))
+        {
+            NS_LOG_WARN("WARNING: GatewayReactor failed to signal a reactor thread to stop");
+        }
+        worker->thread.join();
+        close(worker->wakeup);
+        close(worker->epoll);
+    }
+}
+
+Ptr<GatewayReactor>
+GatewayReactor::GetInstance()
+{
+    static Ptr<GatewayReactor> instance = Create<GatewayReactor>();
+    return instance;
+}
+
+bool
+GatewayReactor::IsSupported()
+{
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+void
+GatewayReactor::SetThreadCount(uint32_t count)
+{
+    NS_LOG_FUNCTION(this << count);
+
+    std::unique_lock lock(m_mutex);
+    if (!m_workers.empty())
+    {
+        NS_FATAL_ERROR("ERROR: GatewayReactor::SetThreadCount must be called before GatewayReactor::Add");
+    }
+    if (count == 0)
+    {
+        NS_FATAL_ERROR("ERROR: GatewayReactor::SetThreadCount requires at least one thread");
+    }
+    m_threadCount = count;
+}
+
+void
+GatewayReactor::SetCpuAffinity(const std::vector<uint32_t> & cpus)
+{
+    NS_LOG_FUNCTION(this);
+
+    std::unique_lock lock(m_mutex);
+    if (!m_workers.empty())
+    {
+        NS_FATAL_ERROR("ERROR: GatewayReactor::SetCpuAffinity must be called before GatewayReactor::Add");
+    }
+    m_cpus = cpus;
+}
+
+bool
+GatewayReactor::Add(int descriptor, Callback<bool> handler)
+{
+    NS_LOG_FUNCTION(this << descriptor);
+
+#ifdef __linux__
+    Worker * worker;
+    {   // critical section start
+        std::unique_lock lock(m_mutex);
+        if (m_workers.empty())
+        {
+            Start();
+        }
+        worker = m_workers[m_nextWorker].get();
+        m_nextWorker = (m_nextWorker + 1) % m_workers.size();
+        m_assigned[descriptor] = worker;
+    }   // critical section end
+
+    bool added = false;
+    int flags = fcntl(descriptor, F_GETFL);
+    if (flags == -1 || fcntl(descriptor, F_SETFL, flags | O_NONBLOCK) == -1)
+    {
+        NS_LOG_WARN("WARNING: GatewayReactor failed to set descriptor " << descriptor << " to non-blocking mode");
+    }
+    else
+    {
+        std::unique_lock lock(worker->mutex);
+        worker->handlers[descriptor] = handler;
+        struct epoll_event event = {};
+        event.events = EPOLLIN; // level-triggered, so a handler only needs to receive once for each call
+        event.data.fd = descriptor;
+        added = (epoll_ctl(worker->epoll, EPOLL_CTL_ADD, descriptor, &event) != -1);
+        if (!added)
+        {
+            NS_LOG_WARN("WARNING: GatewayReactor failed to add descriptor " << descriptor);
+            worker->handlers.erase(descriptor);
+        }
+    }
+
+    if (!added)
+    {
+        std::unique_lock lock(m_mutex);
+        m_assigned.erase(descriptor);
+        return false;
+    }
+    NS_LOG_INFO("GatewayReactor added descriptor " << descriptor);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void
+GatewayReactor::Remove(int descriptor)
+{
+    NS_LOG_FUNCTION(this << descriptor);
+
+#ifdef __linux__
+    Worker * worker;
+    {   // critical section start
+        std::unique_lock lock(m_mutex);
+        auto assigned = m_assigned.find(descriptor);
+        if (assigned == m_assigned.end())
+        {
+            return;
+        }
+        worker = assigned->second;
+        m_assigned.erase(assigned);
+    }   // critical section end
+
+    std::unique_lock lock(worker->mutex); // waits for an executing handler to return
+    if (worker->handlers.erase(descriptor) > 0)
+    {
+        epoll_ctl(worker->epoll, EPOLL_CTL_DEL, descriptor, nullptr);
+        NS_LOG_INFO("GatewayReactor removed descriptor " << descriptor);
+    }
+#endif
+}
+
+void
+GatewayReactor::Pause(int descriptor)
+{
+    NS_LOG_FUNCTION(this << descriptor);
+
+#ifdef __linux__
+    Worker * worker = GetWorker(descriptor);
+    if (worker != nullptr)
+    {
+        epoll_ctl(worker->epoll, EPOLL_CTL_DEL, descriptor, nullptr); // fails if already paused
+    }
+#endif
+}
+
+void
+GatewayReactor::Resume(int descriptor)
+{
+    NS_LOG_FUNCTION(this << descriptor);
+
+#ifdef __linux__
+    Worker * worker = GetWorker(descriptor);
+    if (worker == nullptr)
+    {
+        return;
+    }
+    {   // critical section start
+        std::unique_lock lock(worker->resumeMutex);
+        worker->resumed.push_back(descriptor);
+    }   // critical section end
+
+    // the reactor thread re-adds the descriptor, so it is never added while its handler executes on another thread
+    uint64_t value = 1;
+    if (write(worker->wakeup, &value, sizeof(value)) != sizeof(value))
+    {
+        NS_LOG_WARN("WARNING: GatewayReactor failed to signal a reactor thread to resume descriptor " << descriptor);
+    }
+#endif
+}
+
+GatewayReactor::Worker *
+GatewayReactor::GetWorker(int descriptor)
+{
+    std::unique_lock lock(m_mutex);
+    auto assigned = m_assigned.find(descriptor);
+    return (assigned != m_assigned.end()) ? assigned->second : nullptr;
+}
+
+void
+GatewayReactor::Start()
+{
+    NS_LOG_FUNCTION(this);
+
+#ifdef __linux__
+    for (uint32_t i = 0; i < m_threadCount; i++)
+    {
+        std::unique_ptr<Worker> worker = std::make_unique<Worker>();
+        worker->epoll = epoll_create1(EPOLL_CLOEXEC);
+        worker->wakeup = eventfd(0, EFD_CLOEXEC);
+        worker->stopping = false;
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = worker->wakeup;
+        if (worker->epoll == -1 || worker->wakeup == -1
+            || epoll_ctl(worker->epoll, EPOLL_CTL_ADD, worker->wakeup, &event) == -1)
+        {
+            NS_FATAL_ERROR("ERROR: GatewayReactor failed to create an epoll instance");
+        }
+        worker->thread = std::thread(&GatewayReactor::Run, this, worker.get());
+
+        if (!m_cpus.empty())
+        {
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            CPU_SET(m_cpus[i % m_cpus.size()], &cpuSet);
+            if (pthread_setaffinity_np(worker->thread.native_handle(), sizeof(cpuSet), &cpuSet) != 0)
+            {
+                NS_LOG_WARN("WARNING: GatewayReactor failed to set the affinity of thread " << i << " to processor "
+                    << m_cpus[i % m_cpus.size()]
+                );
+            }
+        }
+        m_workers.push_back(std::move(worker));
+    }
+    NS_LOG_INFO("GatewayReactor started " << m_threadCount << " threads");
+#endif
+}
+
+void
+GatewayReactor::Run(Worker * worker)
+{
+    NS_LOG_FUNCTION(this);
+
+#ifdef __linux__
+    const int EVENT_CAPACITY = 64;
+    struct epoll_event events[EVENT_CAPACITY];
+    std::vector<int> resumed;
+    while (true)
+    {
+        int eventCount = epoll_wait(worker->epoll, events, EVENT_CAPACITY, -1);
+        if (eventCount == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            NS_FATAL_ERROR("ERROR: GatewayReactor failed to wait for data");
+        }
+
+        std::unique_lock lock(worker->mutex);
+        for (int i = 0; i < eventCount; i++)
+        {
+            int descriptor = events[i].data.fd;
+            if (descriptor != worker->wakeup)
+            {
+                CallHandler(worker, descriptor);
+                continue;
+            }
+            if (worker->stopping)
+            {
+                return; // the reactor is being destroyed
+            }
+
+            // wait for data on the resumed descriptors again, and let each handler process the data it already has
+            uint64_t value;
+            if (read(worker->wakeup, &value, sizeof(value)) != sizeof(value))
+            {
+                NS_LOG_WARN("WARNING: GatewayReactor failed to reset the signal of a reactor thread");
+            }
+            {   // critical section start
+                std::unique_lock resumeLock(worker->resumeMutex);
+                resumed.swap(worker->resumed);
+            }   // critical section end
+            for (int resumedDescriptor : resumed)
+            {
+                if (worker->handlers.count(resumedDescriptor) > 0)
+                {
+                    struct epoll_event event = {};
+                    event.events = EPOLLIN;
+                    event.data.fd = resumedDescriptor;
+                    epoll_ctl(worker->epoll, EPOLL_CTL_ADD, resumedDescriptor, &event); // fails if not paused
+                    CallHandler(worker, resumedDescriptor);
+                }
+            }
+            resumed.clear();
+        }
+    }
+#endif
+}
+
+void
+GatewayReactor::CallHandler(Worker * worker, int descriptor)
+{
+#ifdef __linux__
+    // the handler was removed if Remove executed after epoll_wait returned
+    auto handler = worker->handlers.find(descriptor);
+    if (handler != worker->handlers.end() && !handler->second())
+    {
+        worker->handlers.erase(handler);
+        epoll_ctl(worker->epoll, EPOLL_CTL_DEL, descriptor, nullptr);
+    }
+#endif
+}
+
+} // namespace ns3
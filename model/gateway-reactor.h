@@ -0,0 +1,191 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#ifndef GATEWAY_REACTOR_H
+#define GATEWAY_REACTOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+namespace ns3
+{
+
+/**
+ * An I/O reactor that waits for data on the transports of many gateways with a small number of threads, instead of
+ * one receiving thread per gateway (see Gateway::SetReactor).
+ *
+ * Each registered descriptor is assigned to one reactor thread (in turn), which waits for it with epoll and calls its
+ * handler whenever data is available. Handlers of different descriptors on the same thread execute one at a time, so
+ * a handler must not block. A handler that cannot accept more data pauses its descriptor instead (see
+ * GatewayReactor::Pause), and whichever thread makes room resumes it. Reactor threads are started when the first
+ * descriptor is added, and stopped when the reactor is destroyed. The reactor requires epoll, so it is only available
+ * on Linux.
+ */
+class GatewayReactor : public SimpleRefCount<GatewayReactor>
+{
+    public:
+        GatewayReactor();
+        ~GatewayReactor();
+
+        /**
+         * @brief Get the process-wide reactor, which is created by the first call.
+         * @return the shared reactor
+         */
+        static Ptr<GatewayReactor> GetInstance();
+
+        /**
+         * @brief Check if reactors are supported on this platform.
+         * @return true if epoll is available
+         */
+        static bool IsSupported();
+
+        /**
+         * @brief Set the number of reactor threads.
+         *
+         * Exceptions:
+         *  1) this function must be called before the first descriptor is added.
+         *  2) the count must be greater than 0.
+         *
+         * @param count the number of threads (default: 1)
+         */
+        void SetThreadCount(uint32_t count);
+
+        /**
+         * @brief Restrict each reactor thread to one processor core.
+         *
+         * Reactor thread i executes on processor cpus[i % cpus.size()]. Failing to set the affinity of a thread is
+         * reported with a warning.
+         *
+         * Exceptions:
+         *  1) this function must be called before the first descriptor is added.
+         *
+         * @param cpus the processor numbers, or an empty vector for no restriction (default: empty)
+         */
+        void SetCpuAffinity(const std::vector<uint32_t> & cpus);
+
+        /**
+         * @brief Call a handler from a reactor thread whenever a descriptor has data to receive.
+         *
+         * The descriptor is set to non-blocking mode, so its handler can receive until no more data is available. The
+         * handler returns false to remove the descriptor from the reactor (for example, once the connection closed).
+         *
+         * @param descriptor the file descriptor to wait for
+         * @param handler the function to call when data is available
+         * @return false if reactors are not supported on this platform, or the descriptor could not be added
+         */
+        bool Add(int descriptor, Callback<bool> handler);
+
+        /**
+         * @brief Stop calling the handler of a descriptor. Once this function returns, the handler is not executing.
+         *
+         * This function must not be called from a handler. Removing a descriptor that is not registered does nothing.
+         *
+         * @param descriptor the file descriptor to remove
+         */
+        void Remove(int descriptor);
+
+        /**
+         * @brief Stop waiting for data on a descriptor until GatewayReactor::Resume is called, without removing it.
+         *
+         * This function can be called from the handler of the descriptor, for example when the handler cannot accept
+         * more data without blocking. Pausing a descriptor that is not registered does nothing.
+         *
+         * @param descriptor the file descriptor to pause
+         */
+        void Pause(int descriptor);
+
+        /**
+         * @brief Wait for data on a paused descriptor again.
+         *
+         * The handler is called once by the reactor thread even if no data is available, so that it can process the
+         * data it received before it paused. This function can be called from any thread, including a handler.
+         * Resuming a descriptor that is not registered does nothing.
+         *
+         * @param descriptor the file descriptor to resume
+         */
+        void Resume(int descriptor);
+    private:
+        struct Worker   // one reactor thread and the descriptors assigned to it
+        {
+            int epoll;                              //!< The epoll instance of the thread
+            int wakeup;                             //!< An eventfd signalled to resume descriptors or stop the thread
+            std::atomic<bool> stopping;             //!< True once the reactor is being destroyed
+            std::thread thread;                     //!< The reactor thread
+            std::mutex mutex;                       //!< Held while handlers execute, and while handlers change
+            std::map<int, Callback<bool>> handlers; //!< The handler of each assigned descriptor
+            std::mutex resumeMutex;                 //!< Guards resumed
+            std::vector<int> resumed;               //!< Descriptors passed to Resume, and not yet resumed
+        };
+
+        /**
+         * @brief Get the reactor thread assigned to a descriptor.
+         * @param descriptor the file descriptor
+         * @return the reactor thread, or nullptr if the descriptor is not registered
+         */
+        Worker * GetWorker(int descriptor);
+
+        /**
+         * @brief Call a handler, and remove its descriptor if the handler returns false (reactor thread only).
+         * @param worker the state of this reactor thread, whose mutex is held
+         * @param descriptor the file descriptor
+         */
+        void CallHandler(Worker * worker, int descriptor);
+
+        /**
+         * @brief Create the epoll instances and start the reactor threads.
+         */
+        void Start();
+
+        /**
+         * @brief Wait for data and call handlers until the reactor is destroyed.
+         * @param worker the state of this reactor thread
+         */
+        void Run(Worker * worker);
+
+        uint32_t m_threadCount;                         //!< The number of reactor threads
+        std::vector<uint32_t> m_cpus;                   //!< The processor of each reactor thread (see SetCpuAffinity)
+        std::mutex m_mutex;                             //!< Guards starting the threads and assigning descriptors
+        std::vector<std::unique_ptr<Worker>> m_workers; //!< The reactor threads (empty until the first Add)
+        std::map<int, Worker *> m_assigned;             //!< The reactor thread assigned to each descriptor
+        uint32_t m_nextWorker;                          //!< The reactor thread assigned to the next descriptor
+};
+
+} // namespace ns3
+
+#endif /* GATEWAY_REACTOR_H */
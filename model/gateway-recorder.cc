@@ -0,0 +1,220 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <cstring>
+
+#include "gateway-recorder.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("GatewayRecorder");
+
+namespace
+{
+
+const char SIGNATURE[] = "NS3CREC1";                    // the first bytes of every recording file
+const size_t SIGNATURE_SIZE = sizeof(SIGNATURE) - 1;    // excluding the null terminator
+const size_t RECORD_HEADER_SIZE = 12;                   // INT64 time and UINT32 size
+
+// little-endian helper functions (independent of the host byte order)
+
+void
+WriteLittleEndian(char * data, uint64_t value, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        data[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+uint64_t
+ReadLittleEndian(const char * data, size_t size)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+/* ========== GATEWAY RECORDER ============================================== */
+
+GatewayRecorder::GatewayRecorder():
+    m_file(nullptr)
+{
+    // do nothing
+}
+
+GatewayRecorder::~GatewayRecorder()
+{
+    Close();
+}
+
+void
+GatewayRecorder::Open(const std::string & path)
+{
+    NS_LOG_FUNCTION(this << path);
+
+    if (m_file != nullptr)
+    {
+        NS_FATAL_ERROR("ERROR: GatewayRecorder::Open called for an open recorder");
+    }
+    m_file = std::fopen(path.c_str(), "wb");
+    if (m_file == nullptr || std::fwrite(SIGNATURE, 1, SIGNATURE_SIZE, m_file) != SIGNATURE_SIZE)
+    {
+        NS_FATAL_ERROR("ERROR: GatewayRecorder::Open failed to create the recording " << path);
+    }
+    m_start = std::chrono::steady_clock::now();
+    NS_LOG_INFO("GatewayRecorder recording to " << path);
+}
+
+bool
+GatewayRecorder::IsOpen() const
+{
+    return m_file != nullptr;
+}
+
+void
+GatewayRecorder::Record(std::chrono::steady_clock::time_point time, std::string_view data, std::string_view trailer)
+{
+    if (m_file == nullptr)
+    {
+        return;
+    }
+
+    char header[RECORD_HEADER_SIZE];
+    int64_t offset = std::chrono::duration_cast<std::chrono::nanoseconds>(time - m_start).count();
+    WriteLittleEndian(header, static_cast<uint64_t>(offset), 8);
+    WriteLittleEndian(header + 8, data.size() + trailer.size(), 4);
+    if (std::fwrite(header, 1, RECORD_HEADER_SIZE, m_file) != RECORD_HEADER_SIZE
+        || std::fwrite(data.data(), 1, data.size(), m_file) != data.size()
+        || std::fwrite(trailer.data(), 1, trailer.size(), m_file) != trailer.size())
+    {
+        NS_LOG_WARN("WARNING: GatewayRecorder failed to write to the recording, which is now closed");
+        Close();
+    }
+}
+
+void
+GatewayRecorder::Close()
+{
+    if (m_file != nullptr)
+    {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+/* ========== GATEWAY RECORD READER ========================================= */
+
+GatewayRecordReader::GatewayRecordReader():
+    m_file(nullptr)
+{
+    // do nothing
+}
+
+GatewayRecordReader::~GatewayRecordReader()
+{
+    Close();
+}
+
+void
+GatewayRecordReader::Open(const std::string & path)
+{
+    NS_LOG_FUNCTION(this << path);
+
+    if (m_file != nullptr)
+    {
+        NS_FATAL_ERROR("ERROR: GatewayRecordReader::Open called for an open reader");
+    }
+    m_file = std::fopen(path.c_str(), "rb");
+    if (m_file == nullptr)
+    {
+        NS_FATAL_ERROR("ERROR: GatewayRecordReader::Open failed to open the recording " << path);
+    }
+    char signature[SIGNATURE_SIZE];
+    if (std::fread(signature, 1, SIGNATURE_SIZE, m_file) != SIGNATURE_SIZE
+        || std::memcmp(signature, SIGNATURE, SIGNATURE_SIZE) != 0)
+    {
+        NS_FATAL_ERROR("ERROR: GatewayRecordReader::Open found that " << path << " is not a recording");
+    }
+    m_path = path;
+}
+
+bool
+GatewayRecordReader::IsOpen() const
+{
+    return m_file != nullptr;
+}
+
+bool
+GatewayRecordReader::Read(std::string & data, Time & time)
+{
+    if (m_file == nullptr)
+    {
+        return false;
+    }
+
+    char header[RECORD_HEADER_SIZE];
+    size_t headerSize = std::fread(header, 1, RECORD_HEADER_SIZE, m_file);
+    if (headerSize == 0 && std::feof(m_file))
+    {
+        return false; // the end of the recording
+    }
+    if (headerSize == RECORD_HEADER_SIZE)
+    {
+        time = NanoSeconds(static_cast<int64_t>(ReadLittleEndian(header, 8)));
+        data.resize(ReadLittleEndian(header + 8, 4));
+        if (std::fread(&data[0], 1, data.size(), m_file) == data.size())
+        {
+            return true;
+        }
+    }
+    NS_LOG_WARN("WARNING: the recording " << m_path << " ends with a truncated message");
+    return false;
+}
+
+void
+GatewayRecordReader::Close()
+{
+    if (m_file != nullptr)
+    {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,154 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#ifndef GATEWAY_RECORDER_H
+#define GATEWAY_RECORDER_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "ns3/core-module.h"
+
+namespace ns3
+{
+
+/**
+ * Writes a stream of messages to a recording file, with the time at which each message was recorded.
+ *
+ * A recording file begins with the 8 byte signature "NS3CREC1". Each message follows in the order in which it was
+ * recorded, as an INT64 number of nanoseconds since GatewayRecorder::Open, a UINT32 message size, and the message
+ * bytes. Integers are little-endian. The messages are stored exactly as they were exchanged (including the framing),
+ * so a recording can be replayed with any transport framing (see ReplayTransport).
+ */
+class GatewayRecorder
+{
+    public:
+        GatewayRecorder();
+        ~GatewayRecorder();
+
+        GatewayRecorder(const GatewayRecorder &) = delete;
+        GatewayRecorder & operator=(const GatewayRecorder &) = delete;
+
+        /**
+         * @brief Create (or replace) a recording file, and start the recording clock.
+         *
+         * Exceptions:
+         *  1) the recorder must not already be open.
+         *  2) failing to create the file will cause a fatal error.
+         *
+         * @param path the file system path of the recording
+         */
+        void Open(const std::string & path);
+
+        /**
+         * @brief Check if the recorder is open.
+         * @return true if GatewayRecorder::Open was called and GatewayRecorder::Close was not
+         */
+        bool IsOpen() const;
+
+        /**
+         * @brief Append one message to the recording. The message is the concatenation of data and trailer.
+         *
+         * Writes are buffered, so this function does not usually make a system call. If a write fails, a warning is
+         * output and the recorder is closed.
+         *
+         * @param time the time at which the message was received or sent
+         * @param data the message content
+         * @param trailer bytes that follow the message content (for example, the message delimiter)
+         */
+        void Record(std::chrono::steady_clock::time_point time, std::string_view data, std::string_view trailer = {});
+
+        /**
+         * @brief Flush and close the recording file. This function is safe to call any number of times.
+         */
+        void Close();
+    private:
+        std::FILE * m_file;                             //!< The recording file, or nullptr
+        std::chrono::steady_clock::time_point m_start;  //!< The time at which the recording was opened
+};
+
+/**
+ * Reads the messages of a recording file created by GatewayRecorder, in order.
+ */
+class GatewayRecordReader
+{
+    public:
+        GatewayRecordReader();
+        ~GatewayRecordReader();
+
+        GatewayRecordReader(const GatewayRecordReader &) = delete;
+        GatewayRecordReader & operator=(const GatewayRecordReader &) = delete;
+
+        /**
+         * @brief Open a recording file.
+         *
+         * Exceptions:
+         *  1) the reader must not already be open.
+         *  2) a file that does not exist or is not a recording will cause a fatal error.
+         *
+         * @param path the file system path of the recording
+         */
+        void Open(const std::string & path);
+
+        /**
+         * @brief Check if the reader is open.
+         * @return true if GatewayRecordReader::Open was called and GatewayRecordReader::Close was not
+         */
+        bool IsOpen() const;
+
+        /**
+         * @brief Read the next message of the recording.
+         *
+         * A truncated final message (for example, from a recording that was not closed) is reported with a warning,
+         * and is treated as the end of the recording.
+         *
+         * @param data the message, which re-uses the capacity of the string
+         * @param time the time of the message relative to the start of the recording
+         * @return false at the end of the recording
+         */
+        bool Read(std::string & data, Time & time);
+
+        /**
+         * @brief Close the recording file. This function is safe to call any number of times.
+         */
+        void Close();
+    private:
+        std::FILE * m_file; //!< The recording file, or nullptr
+        std::string m_path; //!< The file system path of the recording
+};
+
+} // namespace ns3
+
+#endif /* GATEWAY_RECORDER_H */
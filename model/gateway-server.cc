@@ -0,0 +1,392 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <charconv>
+#include <cstdio>
+
+#include "gateway-server.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("GatewayServer");
+
+GatewayServer::GatewayServer(Ptr<GatewayTransport> transport,
+                             const std::string & delimiterField,
+                             const std::string & delimiterMessage):
+    m_transport(transport),
+    m_framing(Gateway::FRAMING::TEXT),
+    m_responseMode(Gateway::RESPONSE_MODE::FULL),
+    m_responseHeader(false),
+    m_responseTime(-1),
+    m_responseSequence(0),
+    m_nextEventReport(false),
+    m_nextEventTime(-1),
+    m_delimiterField(delimiterField),
+    m_delimiterMessage(delimiterMessage)
+{
+    NS_LOG_FUNCTION(this);
+
+    if (delimiterField.empty())
+    {
+        NS_FATAL_ERROR("ERROR: gateway server field delimiter cannot be empty");
+    }
+    if (delimiterMessage.empty())
+    {
+        NS_FATAL_ERROR("ERROR: gateway server message delimiter cannot be empty");
+    }
+}
+
+GatewayServer::GatewayServer(Ptr<GatewayTransport> transport, Gateway::FRAMING framing):
+    GatewayServer(transport)
+{
+    NS_LOG_FUNCTION(this << framing);
+
+    m_framing = framing;
+}
+
+bool
+GatewayServer::Send(const std::string & message)
+{
+    NS_LOG_FUNCTION(this << message.size());
+
+    return m_transport->Send(message.data(), message.size());
+}
+
+bool
+GatewayServer::Receive(std::string & message)
+{
+    NS_LOG_FUNCTION(this);
+
+    while (true)
+    {
+        // check for a complete message
+        if (m_framing == Gateway::FRAMING::BINARY)
+        {
+            char header[BinaryEncoder::HEADER_SIZE];
+            int32_t seconds;
+            uint32_t nanoseconds;
+            uint32_t payloadSize;
+            if (m_receiveBuffer.GetSize() >= BinaryEncoder::HEADER_SIZE)
+            {
+                m_receiveBuffer.Peek(header, BinaryEncoder::HEADER_SIZE);
+                BinaryDecoder::ReadHeader(header, BinaryEncoder::HEADER_SIZE, seconds, nanoseconds, payloadSize);
+                if (m_receiveBuffer.GetSize() - BinaryEncoder::HEADER_SIZE >= payloadSize)
+                {
+                    m_receiveBuffer.Read(BinaryEncoder::HEADER_SIZE + payloadSize, message);
+                    return true;
+                }
+            }
+        }
+        else
+        {
+            size_t messageSize;
+            if (m_receiveBuffer.Find(m_delimiterMessage, messageSize))
+            {
+                m_receiveBuffer.Read(messageSize, message);
+                m_receiveBuffer.Consume(m_delimiterMessage.size());
+                return true;
+            }
+        }
+
+        // receive more data
+        size_t writableSize;
+        char * writable = m_receiveBuffer.GetWritable(65536, writableSize);
+        ssize_t bytesReceived = m_transport->Receive(writable, writableSize);
+        if (bytesReceived <= 0)
+        {
+            if (bytesReceived == -1)
+            {
+                NS_LOG_ERROR("ERROR: gateway server connection error");
+            }
+            return false;
+        }
+        m_receiveBuffer.Commit(bytesReceived);
+    }
+}
+
+void
+GatewayServer::SetResponseMode(Gateway::RESPONSE_MODE mode)
+{
+    NS_LOG_FUNCTION(this << mode);
+
+    m_responseMode = mode;
+}
+
+void
+GatewayServer::SetResponseHeader(bool enabled)
+{
+    NS_LOG_FUNCTION(this << enabled);
+
+    m_responseHeader = enabled;
+}
+
+Time
+GatewayServer::GetResponseTime() const
+{
+    return m_responseTime;
+}
+
+uint64_t
+GatewayServer::GetResponseSequence() const
+{
+    return m_responseSequence;
+}
+
+void
+GatewayServer::SetNextEventReport(bool enabled)
+{
+    NS_LOG_FUNCTION(this << enabled);
+
+    m_nextEventReport = enabled;
+}
+
+Time
+GatewayServer::GetNextEventTime() const
+{
+    return m_nextEventTime;
+}
+
+bool
+GatewayServer::ReceiveValues(std::vector<std::string> & values)
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!Receive(m_buffer))
+    {
+        return false;
+    }
+    m_response.Assign(m_buffer);
+    if (m_framing == Gateway::FRAMING::BINARY)
+    {
+        if (!m_response.SplitBinary(BinaryEncoder::HEADER_SIZE))
+        {
+            NS_FATAL_ERROR("ERROR: GatewayServer received a response with invalid fields");
+        }
+    }
+    else
+    {
+        m_response.SplitText(m_delimiterField);
+    }
+
+    // read the response header (see Gateway::SetResponseHeader)
+    uint32_t first = 0;
+    if (m_framing == Gateway::FRAMING::BINARY)
+    {
+        int32_t seconds;
+        uint32_t nanoseconds;
+        uint32_t payloadSize;
+        const std::string & buffer = m_response.GetBuffer();
+        BinaryDecoder::ReadHeader(buffer.data(), buffer.size(), seconds, nanoseconds, payloadSize);
+        m_responseTime = Seconds(seconds) + NanoSeconds(nanoseconds);
+    }
+    if (m_responseHeader)
+    {
+        int64_t seconds = 0;
+        int64_t nanoseconds = 0;
+        int64_t sequence;
+        if (m_framing == Gateway::FRAMING::TEXT
+            && (!ReadInt64(first++, seconds) || !ReadInt64(first++, nanoseconds) || nanoseconds < 0))
+        {
+            NS_FATAL_ERROR("ERROR: GatewayServer received a response without a valid timestamp");
+        }
+        if (!ReadInt64(first++, sequence) || sequence < 0)
+        {
+            NS_FATAL_ERROR("ERROR: GatewayServer received a response without a valid sequence number");
+        }
+        if (m_framing == Gateway::FRAMING::TEXT)
+        {
+            m_responseTime = Seconds(seconds) + NanoSeconds(nanoseconds);
+        }
+        m_responseSequence = sequence;
+    }
+
+    // read the next event time (see Gateway::SetNextEventReport)
+    if (m_nextEventReport)
+    {
+        int64_t nanoseconds;
+        if (!ReadInt64(first++, nanoseconds))
+        {
+            NS_FATAL_ERROR("ERROR: GatewayServer received a response without a next event time");
+        }
+        m_nextEventTime = NanoSeconds(nanoseconds);
+    }
+
+    // check the marker of the DELTA response mode
+    bool isDelta = false;
+    if (m_responseMode == Gateway::RESPONSE_MODE::DELTA)
+    {
+        std::string marker;
+        if (!ReadValue(first, marker) || (marker != "K" && marker != "D"))
+        {
+            NS_FATAL_ERROR("ERROR: GatewayServer received a response without a keyframe or delta marker");
+        }
+        isDelta = (marker == "D");
+        first++;
+    }
+
+    if (isDelta) // (index, value) pairs
+    {
+        if ((m_response.GetSize() - first) % 2 != 0)
+        {
+            NS_FATAL_ERROR("ERROR: GatewayServer received a delta with an incomplete (index, value) pair");
+        }
+        for (uint32_t i = first; i < m_response.GetSize(); i += 2)
+        {
+            uint32_t index;
+            if (!ReadIndex(i, index) || index >= values.size() || !ReadValue(i + 1, values[index]))
+            {
+                NS_FATAL_ERROR("ERROR: GatewayServer received a delta with an invalid (index, value) pair");
+            }
+        }
+    }
+    else // every value
+    {
+        values.resize(m_response.GetSize() - first);
+        for (uint32_t i = 0; i < values.size(); i++)
+        {
+            if (!ReadValue(first + i, values[i]))
+            {
+                NS_FATAL_ERROR("ERROR: GatewayServer received a response with an invalid value");
+            }
+        }
+    }
+    return true;
+}
+
+void
+GatewayServer::Close()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_transport->Close();
+}
+
+bool
+GatewayServer::ReadValue(uint32_t i, std::string & value) const
+{
+    if (i >= m_response.GetSize())
+    {
+        return false;
+    }
+    std::string_view field = m_response[i];
+    if (m_framing == Gateway::FRAMING::TEXT)
+    {
+        value.assign(field.data(), field.size());
+        return true;
+    }
+
+    // decode the field by its type, formatting numbers as they would be formatted by Gateway::SetValue with TEXT
+    BinaryDecoder decoder(field.data(), field.size());
+    char number[64];
+    size_t size;
+    switch (field.empty() ? 0 : static_cast<uint8_t>(field[0]))
+    {
+        case BinaryEncoder::FIELD_TYPE::INT32: {
+            int32_t integer;
+            if (!decoder.ReadInt32(integer))
+            {
+                return false;
+            }
+            size = std::to_chars(number, number + sizeof(number), integer).ptr - number;
+            break;
+        }
+        case BinaryEncoder::FIELD_TYPE::INT64: {
+            int64_t integer;
+            if (!decoder.ReadInt64(integer))
+            {
+                return false;
+            }
+            size = std::to_chars(number, number + sizeof(number), integer).ptr - number;
+            break;
+        }
+        case BinaryEncoder::FIELD_TYPE::DOUBLE: {
+            double real;
+            if (!decoder.ReadDouble(real))
+            {
+                return false;
+            }
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+            size = std::to_chars(number, number + sizeof(number), real).ptr - number;
+#else
+            size = std::snprintf(number, sizeof(number), "%.17g", real);
+#endif
+            break;
+        }
+        case BinaryEncoder::FIELD_TYPE::BYTES:
+            return decoder.ReadBytes(value);
+        default:
+            return false;
+    }
+    value.assign(number, size);
+    return true;
+}
+
+bool
+GatewayServer::ReadIndex(uint32_t i, uint32_t & value) const
+{
+    if (i >= m_response.GetSize())
+    {
+        return false;
+    }
+    std::string_view field = m_response[i];
+    if (m_framing == Gateway::FRAMING::BINARY)
+    {
+        int32_t index;
+        if (!BinaryDecoder(field.data(), field.size()).ReadInt32(index) || index < 0)
+        {
+            return false;
+        }
+        value = index;
+        return true;
+    }
+    auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec == std::errc() && result.ptr == field.data() + field.size();
+}
+
+bool
+GatewayServer::ReadInt64(uint32_t i, int64_t & value) const
+{
+    if (i >= m_response.GetSize())
+    {
+        return false;
+    }
+    std::string_view field = m_response[i];
+    if (m_framing == Gateway::FRAMING::BINARY)
+    {
+        return BinaryDecoder(field.data(), field.size()).ReadInt64(value);
+    }
+    auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec == std::errc() && result.ptr == field.data() + field.size();
+}
+
+} // namespace ns3
@@ -0,0 +1,196 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#ifndef GATEWAY_SERVER_H
+#define GATEWAY_SERVER_H
+
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+#include "gateway.h"
+#include "gateway-message.h"
+#include "gateway-transport.h"
+#include "receive-buffer.h"
+
+namespace ns3
+{
+
+/**
+ * The server side of a gateway connection, for programs (such as simple-gateway-server) that control an ns-3 gateway.
+ *
+ * The server exchanges complete messages with the gateway over any GatewayTransport, so switching between transports
+ * only changes how the transport is created. Refer to Gateway for the message formats.
+ */
+class GatewayServer
+{
+    public:
+        /**
+         * @brief Construct a server for the TEXT framing.
+         *
+         * @param transport a connected transport
+         * @param delimiterField the delimiter used between values within one message (default: " ")
+         * @param delimiterMessage the delimiter used to indicate the end of a message (default: "\r\n")
+         */
+        GatewayServer(Ptr<GatewayTransport> transport,
+                      const std::string & delimiterField = " ",
+                      const std::string & delimiterMessage = "\r\n");
+
+        /**
+         * @brief Construct a server for the specified message framing.
+         *
+         * @param transport a connected transport
+         * @param framing the format of the messages exchanged with the gateway
+         */
+        GatewayServer(Ptr<GatewayTransport> transport, Gateway::FRAMING framing);
+
+        /**
+         * @brief Send a complete message to the gateway.
+         *
+         * The message is sent as-is, so it must already include its timestamp header and, for the TEXT framing, the
+         * message delimiter.
+         *
+         * @param message the message to send
+         * @return true if the message was sent
+         */
+        bool Send(const std::string & message);
+
+        /**
+         * @brief Block until a complete message is received from the gateway.
+         *
+         * For the TEXT framing, the message delimiter is removed. For the BINARY framing, the message includes its
+         * header (see BinaryDecoder::ReadHeader).
+         *
+         * @param message the received message
+         * @return false if the connection closed before a complete message was received
+         */
+        bool Receive(std::string & message);
+
+        /**
+         * @brief Set the response mode used by the gateway (see Gateway::SetResponseMode).
+         *
+         * @param mode the response mode (default: FULL)
+         */
+        void SetResponseMode(Gateway::RESPONSE_MODE mode);
+
+        /**
+         * @brief Expect the response header at the front of each response (see Gateway::SetResponseHeader).
+         *
+         * @param enabled true if the gateway sends the response header (default: false)
+         */
+        void SetResponseHeader(bool enabled);
+
+        /**
+         * @brief Get the timestamp of the response most recently received by GatewayServer::ReceiveValues.
+         *
+         * With the BINARY framing, the timestamp is always available from the message header. With the TEXT framing,
+         * it is only available if the response header is enabled (and is otherwise negative).
+         *
+         * @return the server time of the step that the response belongs to
+         */
+        Time GetResponseTime() const;
+
+        /**
+         * @brief Get the sequence number of the response most recently received by GatewayServer::ReceiveValues.
+         * @return the index of the message that the response belongs to (0 if the response header is disabled)
+         */
+        uint64_t GetResponseSequence() const;
+
+        /**
+         * @brief Expect the time of the next watched event at the front of each response (see
+         * Gateway::SetNextEventReport).
+         *
+         * @param enabled true if the gateway reports the next event time (default: false)
+         */
+        void SetNextEventReport(bool enabled);
+
+        /**
+         * @brief Get the next event time reported with the response most recently received by
+         * GatewayServer::ReceiveValues.
+         *
+         * @return the server time of the next watched event, or a negative time if no watched event is pending
+         */
+        Time GetNextEventTime() const;
+
+        /**
+         * @brief Block until a complete response is received from the gateway, and apply it to a set of values.
+         *
+         * A FULL response or a keyframe replaces every value, and a delta only replaces the values that it contains.
+         * The values must therefore be retained between calls. With the BINARY framing, each value is decoded by its
+         * field type: a BYTES field is its content, and a numeric field is formatted in decimal (a DOUBLE with the
+         * shortest representation that converts back to the same value).
+         *
+         * Exceptions:
+         *  1) a response that cannot be decoded, or a delta with an index outside of the values, is a fatal error.
+         *  2) a response without a valid response header or next event time is a fatal error, if it was enabled.
+         *
+         * @param values the values sent by the gateway
+         * @return false if the connection closed before a complete response was received
+         */
+        bool ReceiveValues(std::vector<std::string> & values);
+
+        /**
+         * @brief Close the transport.
+         */
+        void Close();
+    private:
+        /**
+         * @brief Decode one field of m_response as a value (of any field type), an index, or an integer (such as a time
+         * in nanoseconds).
+         *
+         * @param i the index of the field in m_response
+         * @param value the decoded value
+         * @return true if the field was decoded
+         */
+        bool ReadValue(uint32_t i, std::string & value) const;
+        bool ReadIndex(uint32_t i, uint32_t & value) const;
+        bool ReadInt64(uint32_t i, int64_t & value) const;
+
+        Ptr<GatewayTransport> m_transport;  //!< The connection to the gateway
+        Gateway::FRAMING m_framing;         //!< The format of the messages exchanged with the gateway
+        Gateway::RESPONSE_MODE m_responseMode;  //!< The response mode used by the gateway
+        bool m_responseHeader;              //!< True if each response begins with its timestamp and sequence
+        Time m_responseTime;                //!< The timestamp of the most recent response
+        uint64_t m_responseSequence;        //!< The sequence number of the most recent response
+        bool m_nextEventReport;             //!< True if each response includes the next event time
+        Time m_nextEventTime;               //!< The next event time reported with the most recent response
+        std::string m_delimiterField;       //!< The character sequence that separates values within a TEXT message
+        std::string m_delimiterMessage;     //!< The character sequence that indicates the end of a TEXT message
+        ReceiveBuffer m_receiveBuffer;      //!< Data received from the transport that is not yet a complete message
+        std::string m_buffer;               //!< The buffer of the response received by GatewayServer::ReceiveValues
+        GatewayMessage m_response;          //!< The fields of the response received by GatewayServer::ReceiveValues
+};
+
+} // namespace ns3
+
+#endif /* GATEWAY_SERVER_H */
@@ -0,0 +1,456 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "gateway-transport.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // platforms without MSG_NOSIGNAL report a closed connection through SIGPIPE
+#endif
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("GatewayTransport");
+
+namespace
+{
+
+/**
+ * @brief Remove a socket file, without removing a file of any other type.
+ * @return false if the path exists and is not a socket
+ */
+bool
+UnlinkSocket(const std::string & path)
+{
+    struct stat status;
+    if (lstat(path.c_str(), &status) == -1)
+    {
+        return true; // nothing to remove
+    }
+    if (!S_ISSOCK(status.st_mode))
+    {
+        return false;
+    }
+    unlink(path.c_str());
+    return true;
+}
+
+} // namespace
+
+/* ========== GatewayTransport ============================================== */
+
+GatewayTransport::~GatewayTransport()
+{
+}
+
+void
+GatewayTransport::Shutdown()
+{
+}
+
+int
+GatewayTransport::GetDescriptor() const
+{
+    return -1;
+}
+
+/* ========== SocketTransport =============================================== */
+
+SocketTransport::SocketTransport():
+    m_socket(-1),
+    m_serverSocket(-1)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SocketTransport::~SocketTransport()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+ssize_t
+SocketTransport::Receive(char * data, size_t size)
+{
+    ssize_t bytesReceived;
+    do
+    {
+        bytesReceived = recv(m_socket, data, size, 0);
+    } while (bytesReceived == -1 && errno == EINTR);
+    return bytesReceived;
+}
+
+bool
+SocketTransport::Send(const char * data, size_t size)
+{
+    while (size > 0) // send can accept fewer bytes than requested
+    {
+        ssize_t bytesSent = send(m_socket, data, size, MSG_NOSIGNAL);
+        if (bytesSent == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                // a non-blocking socket's send buffer is full: wait until it can accept more data
+                pollfd writable = {m_socket, POLLOUT, 0};
+                if (poll(&writable, 1, -1) == -1 && errno != EINTR)
+                {
+                    return false;
+                }
+                continue;
+            }
+            return false;
+        }
+        data += bytesSent;
+        size -= bytesSent;
+    }
+    return true;
+}
+
+void
+SocketTransport::Close()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_socket != -1)
+    {
+        close(m_socket);
+        m_socket = -1;
+    }
+    if (m_serverSocket != -1)
+    {
+        close(m_serverSocket);
+        m_serverSocket = -1;
+    }
+}
+
+void
+SocketTransport::Shutdown()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_socket != -1)
+    {
+        shutdown(m_socket, SHUT_RDWR); // a blocked recv returns 0, but the descriptor stays valid until Close
+    }
+}
+
+int
+SocketTransport::GetDescriptor() const
+{
+    return m_socket;
+}
+
+/* ========== TcpTransport ================================================== */
+
+void
+TcpTransport::Connect(const std::string & serverAddress, uint16_t serverPort)
+{
+    NS_LOG_FUNCTION(this << serverAddress << serverPort);
+
+    if (m_socket != -1)
+    {
+        NS_FATAL_ERROR("ERROR: TcpTransport::Connect called for a connected transport");
+    }
+
+    // resolve the server address (IPv4 or IPv6)
+    struct addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo * addresses;
+    int error = getaddrinfo(serverAddress.c_str(), std::to_string(serverPort).c_str(), &hints, &addresses);
+    if (error != 0)
+    {
+        NS_FATAL_ERROR("ERROR: TcpTransport::Connect failed to resolve the address " << serverAddress
+            << " (" << gai_strerror(error) << ")"
+        );
+    }
+
+    // connect to the first address that accepts the connection
+    for (struct addrinfo * address = addresses; address != NULL && m_socket == -1; address = address->ai_next)
+    {
+        m_socket = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (m_socket != -1 && connect(m_socket, address->ai_addr, address->ai_addrlen) == -1)
+        {
+            close(m_socket);
+            m_socket = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (m_socket == -1)
+    {
+        NS_FATAL_ERROR("ERROR: TcpTransport::Connect failed to connect to "
+            << serverAddress << ":" << serverPort << " (check if the server is running)"
+        );
+    }
+    SetNoDelay();
+    NS_LOG_INFO("TcpTransport connected to " << serverAddress << ":" << serverPort);
+}
+
+void
+TcpTransport::Accept(uint16_t serverPort)
+{
+    Listen(serverPort);
+    Accept();
+}
+
+void
+TcpTransport::Listen(uint16_t serverPort)
+{
+    NS_LOG_FUNCTION(this << serverPort);
+
+    if (m_socket != -1 || m_serverSocket != -1)
+    {
+        NS_FATAL_ERROR("ERROR: TcpTransport::Listen called for a connected transport");
+    }
+
+    // create the server socket, preferring a dual-stack IPv6 socket
+    struct sockaddr_storage serverAddress;
+    socklen_t serverAddressSize;
+    std::memset(&serverAddress, 0, sizeof(serverAddress));
+    int serverSocket = socket(AF_INET6, SOCK_STREAM, 0);
+    if (serverSocket != -1)
+    {
+        int v6only = 0; // also accept IPv4 clients
+        setsockopt(serverSocket, IPPROTO_IPV6, IPV6_V6ONLY, &v6only, sizeof(v6only));
+        struct sockaddr_in6 * address = (struct sockaddr_in6 *)&serverAddress;
+        address->sin6_family = AF_INET6;
+        address->sin6_port = htons(serverPort);
+        address->sin6_addr = in6addr_any;
+        serverAddressSize = sizeof(struct sockaddr_in6);
+    }
+    else
+    {
+        serverSocket = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in * address = (struct sockaddr_in *)&serverAddress;
+        address->sin_family = AF_INET;
+        address->sin_port = htons(serverPort);
+        address->sin_addr.s_addr = INADDR_ANY;
+        serverAddressSize = sizeof(struct sockaddr_in);
+    }
+    if (serverSocket == -1)
+    {
+        NS_FATAL_ERROR("ERROR: TcpTransport::Listen failed to create the socket");
+    }
+    int reuse = 1;
+    if (setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) == -1)
+    {
+        NS_FATAL_ERROR("ERROR: TcpTransport::Listen failed to set the socket options");
+    }
+
+    // bind the socket to the server address
+    if (bind(serverSocket, (struct sockaddr *)&serverAddress, serverAddressSize) == -1)
+    {
+        NS_FATAL_ERROR("ERROR: TcpTransport::Listen failed to bind the socket to port " << serverPort);
+    }
+
+    // listen for client connections
+    if (listen(serverSocket, 1) == -1)
+    {
+        NS_FATAL_ERROR("ERROR: TcpTransport::Listen failed to listen for client connections");
+    }
+    m_serverSocket = serverSocket;
+    NS_LOG_INFO("TcpTransport listening on port " << serverPort);
+}
+
+void
+TcpTransport::Accept()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_serverSocket == -1)
+    {
+        NS_FATAL_ERROR("ERROR: TcpTransport::Accept called before TcpTransport::Listen");
+    }
+
+    // accept a client connection
+    m_socket = accept(m_serverSocket, NULL, NULL);
+    if (m_socket == -1)
+    {
+        NS_FATAL_ERROR("ERROR: TcpTransport::Accept failed to accept the client connection");
+    }
+    close(m_serverSocket); // only one client is served
+    m_serverSocket = -1;
+    SetNoDelay();
+    NS_LOG_INFO("TcpTransport accepted a client connection");
+}
+
+void
+TcpTransport::SetNoDelay()
+{
+    int noDelay = 1;
+    if (setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay)) == -1)
+    {
+        NS_LOG_WARN("WARNING: TcpTransport failed to disable Nagle's algorithm");
+    }
+}
+
+/* ========== UnixTransport ================================================= */
+
+UnixTransport::~UnixTransport()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+void
+UnixTransport::Connect(const std::string & path)
+{
+    NS_LOG_FUNCTION(this << path);
+
+    if (m_socket != -1)
+    {
+        NS_FATAL_ERROR("ERROR: UnixTransport::Connect called for a connected transport");
+    }
+
+    struct sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+    {
+        NS_FATAL_ERROR("ERROR: UnixTransport::Connect called with an invalid path " << path);
+    }
+    path.copy(address.sun_path, path.size());
+
+    m_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_socket == -1)
+    {
+        NS_FATAL_ERROR("ERROR: UnixTransport::Connect failed to create a socket");
+    }
+    if (connect(m_socket, (struct sockaddr *)&address, sizeof(address)) == -1)
+    {
+        NS_FATAL_ERROR("ERROR: UnixTransport::Connect failed to connect to " << path
+            << " (check if the server is running)"
+        );
+    }
+    NS_LOG_INFO("UnixTransport connected to " << path);
+}
+
+void
+UnixTransport::Accept(const std::string & path)
+{
+    Listen(path);
+    Accept();
+}
+
+void
+UnixTransport::Listen(const std::string & path)
+{
+    NS_LOG_FUNCTION(this << path);
+
+    if (m_socket != -1 || m_serverSocket != -1)
+    {
+        NS_FATAL_ERROR("ERROR: UnixTransport::Listen called for a connected transport");
+    }
+
+    struct sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+    {
+        NS_FATAL_ERROR("ERROR: UnixTransport::Listen called with an invalid path " << path);
+    }
+    path.copy(address.sun_path, path.size());
+
+    int serverSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (serverSocket == -1)
+    {
+        NS_FATAL_ERROR("ERROR: UnixTransport::Listen failed to create the socket");
+    }
+    if (!UnlinkSocket(path)) // replace a socket file left by a server that did not exit normally
+    {
+        NS_FATAL_ERROR("ERROR: UnixTransport::Listen found " << path << " exists and is not a socket");
+    }
+    if (bind(serverSocket, (struct sockaddr *)&address, sizeof(address)) == -1)
+    {
+        NS_FATAL_ERROR("ERROR: UnixTransport::Listen failed to bind the socket to " << path);
+    }
+    if (listen(serverSocket, 1) == -1)
+    {
+        NS_FATAL_ERROR("ERROR: UnixTransport::Listen failed to listen for client connections");
+    }
+    m_serverSocket = serverSocket;
+    m_path = path;
+    NS_LOG_INFO("UnixTransport listening on " << path);
+}
+
+void
+UnixTransport::Accept()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_serverSocket == -1)
+    {
+        NS_FATAL_ERROR("ERROR: UnixTransport::Accept called before UnixTransport::Listen");
+    }
+
+    m_socket = accept(m_serverSocket, NULL, NULL);
+    if (m_socket == -1)
+    {
+        NS_FATAL_ERROR("ERROR: UnixTransport::Accept failed to accept the client connection");
+    }
+    close(m_serverSocket); // only one client is served
+    m_serverSocket = -1;
+    UnlinkSocket(m_path);
+    NS_LOG_INFO("UnixTransport accepted a client connection");
+}
+
+void
+UnixTransport::Close()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_serverSocket != -1)
+    {
+        UnlinkSocket(m_path); // closed before a client connected
+    }
+    SocketTransport::Close();
+}
+
+} // namespace ns3
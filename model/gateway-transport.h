@@ -0,0 +1,235 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#ifndef GATEWAY_TRANSPORT_H
+#define GATEWAY_TRANSPORT_H
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "ns3/core-module.h"
+
+namespace ns3
+{
+
+/**
+ * An abstract byte stream connection between a gateway and its server.
+ *
+ * The message framing (see Gateway::FRAMING) is independent of the transport, so a transport only delivers bytes in
+ * order. One thread may call GatewayTransport::Receive while another thread calls GatewayTransport::Send.
+ */
+class GatewayTransport : public SimpleRefCount<GatewayTransport>
+{
+    public:
+        virtual ~GatewayTransport();
+
+        /**
+         * @brief Block until data is available, and then receive it.
+         *
+         * @param data the destination of the received bytes
+         * @param size the maximum number of bytes to receive
+         * @return the number of bytes received, 0 if the connection closed, or -1 on error
+         */
+        virtual ssize_t Receive(char * data, size_t size) = 0;
+
+        /**
+         * @brief Send all of the bytes, blocking until they have been handed to the transport.
+         *
+         * @param data the bytes to send
+         * @param size the number of bytes to send
+         * @return true if every byte was sent
+         */
+        virtual bool Send(const char * data, size_t size) = 0;
+
+        /**
+         * @brief Close the connection. This function is safe to call any number of times.
+         */
+        virtual void Close() = 0;
+
+        /**
+         * @brief Wake the threads blocked in GatewayTransport::Receive or GatewayTransport::Send, which then return 0
+         * or false, and make every later call to these functions fail in the same way.
+         *
+         * Unlike GatewayTransport::Close, this function is safe to call while other threads are receiving or sending.
+         * The transport must still be closed after those threads stop. The default implementation does nothing, for a
+         * transport whose Receive and Send functions do not block.
+         */
+        virtual void Shutdown();
+
+        /**
+         * @brief Get a file descriptor that becomes readable when data can be received (see GatewayReactor).
+         * @return the descriptor, or -1 if the transport cannot be waited for with epoll (default: -1)
+         */
+        virtual int GetDescriptor() const;
+};
+
+/**
+ * A transport over a connected stream socket. Derived classes create the socket.
+ */
+class SocketTransport : public GatewayTransport
+{
+    public:
+        SocketTransport();
+        ~SocketTransport() override;
+
+        ssize_t Receive(char * data, size_t size) override;
+        bool Send(const char * data, size_t size) override;
+        void Close() override;
+        void Shutdown() override;
+        int GetDescriptor() const override;
+    protected:
+        int m_socket;       //!< The connected socket, or -1
+        int m_serverSocket; //!< The listening socket between Listen and Accept (server side), or -1
+};
+
+/**
+ * A transport over a TCP/IP socket, using either IPv4 or IPv6.
+ */
+class TcpTransport : public SocketTransport
+{
+    public:
+        /**
+         * @brief Connect to a server (client side).
+         *
+         * The address is resolved using getaddrinfo, and each resolved address is tried in order until one connects.
+         *
+         * Exceptions:
+         *  1) the transport must not already be connected.
+         *  2) an unresolved address, or a server that is not running, will cause a fatal error.
+         *
+         * @param serverAddress the host name, IPv4 address, or IPv6 address of the server
+         * @param serverPort the port number of the server
+         */
+        void Connect(const std::string & serverAddress, uint16_t serverPort);
+
+        /**
+         * @brief Listen on a port, and block until one client connects (server side).
+         *
+         * This is equivalent to TcpTransport::Listen followed by TcpTransport::Accept.
+         *
+         * @param serverPort the port number to listen on
+         */
+        void Accept(uint16_t serverPort);
+
+        /**
+         * @brief Listen on a port without waiting for a client (server side).
+         *
+         * A client can connect as soon as this function returns, so a server can report that it is ready before it
+         * blocks in TcpTransport::Accept. The server listens on both IPv6 and IPv4 if the system supports IPv6, and on
+         * IPv4 otherwise.
+         *
+         * Exceptions:
+         *  1) the transport must not already be connected or listening.
+         *  2) failing to listen on the port (for example, a port used by another server) will cause a fatal error.
+         *
+         * @param serverPort the port number to listen on
+         */
+        void Listen(uint16_t serverPort);
+
+        /**
+         * @brief Block until one client connects to the port passed to TcpTransport::Listen (server side).
+         *
+         * Exceptions:
+         *  1) TcpTransport::Listen must be called first.
+         *  2) failing to accept the connection will cause a fatal error.
+         */
+        void Accept();
+    private:
+        /**
+         * @brief Disable Nagle's algorithm, so each message is sent immediately.
+         */
+        void SetNoDelay();
+};
+
+/**
+ * A transport over a Unix domain stream socket, for a server that runs on the same host as ns-3.
+ */
+class UnixTransport : public SocketTransport
+{
+    public:
+        ~UnixTransport() override;
+
+        /**
+         * @brief Connect to a server (client side).
+         *
+         * Exceptions:
+         *  1) the transport must not already be connected.
+         *  2) a path that is too long, or a server that is not running, will cause a fatal error.
+         *
+         * @param path the file system path of the server socket
+         */
+        void Connect(const std::string & path);
+
+        /**
+         * @brief Listen on a path, and block until one client connects (server side).
+         *
+         * This is equivalent to UnixTransport::Listen followed by UnixTransport::Accept.
+         *
+         * @param path the file system path of the server socket
+         */
+        void Accept(const std::string & path);
+
+        /**
+         * @brief Listen on a path without waiting for a client (server side).
+         *
+         * An existing socket file at the path is replaced, and the file is removed once a client connects or the
+         * transport is closed.
+         *
+         * Exceptions:
+         *  1) the transport must not already be connected or listening.
+         *  2) an existing file at the path that is not a socket will cause a fatal error.
+         *  3) failing to listen on the path will cause a fatal error.
+         *
+         * @param path the file system path of the server socket
+         */
+        void Listen(const std::string & path);
+
+        /**
+         * @brief Block until one client connects to the path passed to UnixTransport::Listen (server side).
+         *
+         * Exceptions:
+         *  1) UnixTransport::Listen must be called first.
+         *  2) failing to accept the connection will cause a fatal error.
+         */
+        void Accept();
+
+        void Close() override;
+    private:
+        std::string m_path; //!< The path passed to UnixTransport::Listen
+};
+
+} // namespace ns3
+
+#endif /* GATEWAY_TRANSPORT_H */
@@ -32,27 +32,133 @@
  *  Benjamin Philipose
 */
 
-#include <arpa/inet.h>
-#include <sys/socket.h>
-#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 
 #include "gateway.h"
+#include "gateway-coordinator.h"
 
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("Gateway");
 
+NS_OBJECT_ENSURE_REGISTERED(Gateway);
+
+// every gateway wakes the blocked main thread through the same condition variable (see Gateway::WaitForAnyReceive)
+static std::mutex g_waitMutex;                  // guards g_wakingGateways, and prevents lost wakeups
+static std::condition_variable g_waitCondition; // signalled when any gateway schedules ForwardUp or HandleClose
+static std::vector<Gateway *> g_wakingGateways; // the connected gateways that can wake the main thread
+static uint64_t g_waitEventCount = 0;           // the BLOCK mode wait events executed so far (main thread only)
+
+namespace
+{
+
+// parse a timestamp element like std::stol: leading whitespace and a '+' sign are accepted, trailing characters ignored
+bool
+ParseTimestampElement(std::string_view element, int64_t & value)
+{
+    size_t first = 0;
+    while (first < element.size() && std::isspace(static_cast<unsigned char>(element[first])))
+    {
+        first++;
+    }
+    if (first + 1 < element.size() && element[first] == '+' && element[first + 1] != '-')
+    {
+        first++;
+    }
+    auto result = std::from_chars(element.data() + first, element.data() + element.size(), value);
+    return result.ec == std::errc();
+}
+
+} // namespace
+
 /* ========== PUBLIC MEMBER FUNCTIONS ======================================= */
 
+TypeId
+Gateway::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::Gateway")
+            .SetParent<ObjectBase>()
+            .SetGroupName("CoSim")
+            .AddTraceSource(
+                "Step",
+                "The wall clock time spent in each stage of a step, traced after the step's update executes.",
+                MakeTraceSourceAccessor(&Gateway::m_stepTrace),
+                "ns3::Gateway::StepTracedCallback")
+            .AddTraceSource(
+                "Pacing",
+                "The slack and wake-up jitter of each wall clock deadline, traced when ns-3 reaches the deadline.",
+                MakeTraceSourceAccessor(&Gateway::m_pacingTrace),
+                "ns3::Gateway::PacingTracedCallback");
+    return tid;
+}
+
+TypeId
+Gateway::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
 Gateway::Gateway(uint32_t dataSize, const std::string & delimiterField, const std::string & delimiterMessage):
     m_eventWait(),
     m_eventDestroy(),
+    m_idleMode(IDLE_MODE::SPIN),
+    m_idleEventCount(0),
+    m_idleWaitEventCount(0),
     m_timeStart(Seconds(-1)),
     m_timePause(Seconds(0)),
+    m_lookahead(Seconds(0)),
+    m_lookaheadHeader(false),
+    m_reactorRegistered(false),
+    m_coordinator(nullptr),
+    m_messageQueue(MESSAGE_QUEUE_CAPACITY),
+    m_forwardScheduled(false),
+    m_receivedPending(false),
+    m_receivedStaged(false),
+    m_receivePaused(false),
+    m_readThreadParsing(false),
+    m_threadExited(false),
+    m_terminated(false),
     m_delimiterField(delimiterField),
     m_delimiterMessage(delimiterMessage),
-    m_data(dataSize, "")
+    m_receiveSize(65536),
+    m_asyncSend(false),
+    m_sendQueue(MESSAGE_QUEUE_CAPACITY),
+    m_writerStopping(false),
+    m_writerExited(false),
+    m_queuedBytes(0),
+    m_sentResponses(0),
+    m_sentBytes(0),
+    m_sendLatencyTotal(0),
+    m_sendLatencyMax(0),
+    m_data(dataSize, ""),
+    m_precision(0),
+    m_responseMode(RESPONSE_MODE::FULL),
+    m_keyframeInterval(100),
+    m_responseCount(0),
+    m_nextEventReport(false),
+    m_responseHeader(false),
+    m_sequence(0),
+    m_changed(dataSize, false),
+    m_timingHistograms(false),
+    m_paused(false),
+    m_timingResponse(false),
+    m_responseDuration(0),
+    m_pacingSpeed(0),
+    m_pacedTime(Time::Max()),
+    m_pacingDeadlines(0),
+    m_pacingMisses(0),
+    m_pacingMinSlack(0),
+    m_pacingJitterTotal(0),
+    m_pacingJitterMax(0)
 {
     NS_LOG_FUNCTION(this << dataSize);
 
@@ -69,8 +175,30 @@ Gateway::Gateway(uint32_t dataSize, const std::string & delimiterField, const st
         NS_FATAL_ERROR("ERROR: gateway message delimiter cannot be a substring of the field delimiter");
     }
 
+    // a formatted number only contains digits, signs, decimal points, exponents, "inf", and "nan"
+    static const char * NUMBER_CHARACTERS = "0123456789+-.aefin";
+    m_checkNumbers = delimiterField.find_first_of(NUMBER_CHARACTERS) != std::string::npos
+                     || delimiterMessage.find_first_of(NUMBER_CHARACTERS) != std::string::npos;
+
     m_context = Simulator::GetContext();
     m_state   = STATE::CREATED;
+    m_framing = FRAMING::TEXT;
+}
+
+Gateway::Gateway(uint32_t dataSize, FRAMING framing):
+    Gateway(dataSize)
+{
+    NS_LOG_FUNCTION(this << dataSize << framing);
+
+    m_framing = framing;
+    if (m_framing == FRAMING::BINARY)
+    {
+        // each value is stored as its encoded field, which is initially an empty BYTES field
+        for (std::string & value : m_data)
+        {
+            BinaryEncoder::AppendBytes(value, "", 0);
+        }
+    }
 }
 
 void
@@ -83,295 +211,1380 @@ Gateway::Connect(const std::string & serverAddress, uint16_t serverPort)
         NS_FATAL_ERROR("ERROR: Gateway::Connect was called multiple times");
     }
 
-    // create the client socket
-    m_socket = socket(AF_INET, SOCK_STREAM, 0);
-    if (m_socket < 0)
+    Ptr<TcpTransport> transport = Create<TcpTransport>();
+    transport->Connect(serverAddress, serverPort);
+    Connect(transport);
+}
+
+void
+Gateway::Connect(Ptr<GatewayTransport> transport)
+{
+    NS_LOG_FUNCTION(this << transport);
+
+    if (m_state != STATE::CREATED) // prevent duplicate calls
     {
-        NS_FATAL_ERROR("ERROR: Gateway::Connect failed to create a socket");
+        NS_FATAL_ERROR("ERROR: Gateway::Connect was called multiple times");
     }
-
-    // set the server address
-    struct sockaddr_in socketAddress;
-    socketAddress.sin_family = AF_INET;
-    socketAddress.sin_port = htons(serverPort);
-    if (inet_pton(AF_INET, serverAddress.c_str(), &socketAddress.sin_addr) <= 0)
+    if (!transport)
     {
-        NS_FATAL_ERROR("ERROR: Gateway::Connect failed to resolve the address " << serverAddress);
+        NS_FATAL_ERROR("ERROR: Gateway::Connect called without a transport");
     }
+    m_transport = transport;
 
-    // connect to the server
-    if (connect(m_socket, (struct sockaddr *)&socketAddress, sizeof(socketAddress)) < 0)
+    if (!m_messageRecordPath.empty())
+    {
+        m_messageRecorder.Open(m_messageRecordPath);
+    }
+    if (!m_responseRecordPath.empty())
     {
-        NS_FATAL_ERROR("ERROR: Gateway::Connect failed to connect to "
-            << serverAddress << ":" << serverPort << " (check if the server is running)"
-        );
+        m_responseRecorder.Open(m_responseRecordPath);
     }
 
     m_state = STATE::CONNECTED; // this must be set before RunThread
-    NS_LOG_INFO("Gateway connected to " << serverAddress << ":" << serverPort);
+    NS_LOG_INFO("Gateway connected");
 
-    // schedule a function to stop the socket thread when ns-3 ends
+    // schedule a function to stop the transport thread when ns-3 ends
     m_eventDestroy = Simulator::ScheduleDestroy(&Gateway::Stop, this);
+    SetWaking(true);
 
-    // start a thread to handle the socket connection
-    m_thread = std::thread(&Gateway::RunThread, this);
+    // receive from the transport with the reactor if possible, and otherwise with a dedicated thread
+    if (m_reactor)
+    {
+        // m_reactorRegistered is set before the reactor can call Gateway::HandleReadable, which reads it
+        int descriptor = m_transport->GetDescriptor();
+        m_reactorRegistered = (descriptor != -1);
+        if (m_reactorRegistered && !m_reactor->Add(descriptor, MakeCallback(&Gateway::HandleReadable, this)))
+        {
+            m_reactorRegistered = false;
+        }
+        if (!m_reactorRegistered)
+        {
+            NS_LOG_WARN("WARNING: the transport cannot use the reactor, so the gateway creates its own thread");
+        }
+    }
+    if (!m_reactorRegistered)
+    {
+        m_thread = std::thread(&Gateway::RunThread, this);
+    }
+    if (m_asyncSend)
+    {
+        m_writerThread = std::thread(&Gateway::RunWriterThread, this);
+    }
 
     // wait until the thread forwards the next received message
     NS_LOG_LOGIC("waiting for next update...");
-    m_eventWait = Simulator::ScheduleNow(&Gateway::WaitForNextUpdate, this);
+    if (m_coordinator != nullptr)
+    {
+        m_coordinator->Activate(this); // the coordinator pauses ns-3 at the minimum granted time of every federate
+    }
+    else
+    {
+        m_eventWait = Simulator::ScheduleNow(&Gateway::WaitForNextUpdate, this);
+    }
 }
 
 void
-Gateway::SetValue(uint32_t index, const std::string & value)
+Gateway::SetIdleMode(IDLE_MODE mode)
 {
-    NS_LOG_FUNCTION(this << index << value);
+    NS_LOG_FUNCTION(this << mode);
 
-    if (index >= m_data.size())
+    if (m_state != STATE::CREATED)
     {
-        NS_FATAL_ERROR("ERROR: Gateway::SetValue called with i=" << index << " for a max size of " << m_data.size());
+        NS_FATAL_ERROR("ERROR: Gateway::SetIdleMode must be called before Gateway::Connect");
     }
-    if (value.find(m_delimiterField) != std::string::npos)
+    m_idleMode = mode;
+}
+
+void
+Gateway::SetLookahead(Time lookahead)
+{
+    NS_LOG_FUNCTION(this << lookahead);
+
+    if (m_state != STATE::CREATED)
     {
-        NS_FATAL_ERROR("ERROR: Gateway::SetValue called with a value containing the protocol field delimiter");
+        NS_FATAL_ERROR("ERROR: Gateway::SetLookahead must be called before Gateway::Connect");
     }
-    if (value.find(m_delimiterMessage) != std::string::npos)
+    if (lookahead.IsStrictlyNegative())
     {
-        NS_FATAL_ERROR("ERROR: Gateway::SetValue called with a value containing the protocol message delimiter");
+        NS_FATAL_ERROR("ERROR: Gateway::SetLookahead called with a negative lookahead");
     }
-    m_data[index] = value;
+    m_lookahead = lookahead;
 }
 
 void
-Gateway::SendResponse()
+Gateway::SetLookaheadHeader(bool enabled)
 {
-    NS_LOG_FUNCTION(this);
+    NS_LOG_FUNCTION(this << enabled);
 
-    if (m_state != STATE::CONNECTED)
+    if (m_state != STATE::CREATED)
     {
-        NS_FATAL_ERROR("ERROR: Gateway::SendResponse called without an active connection to the server");
+        NS_FATAL_ERROR("ERROR: Gateway::SetLookaheadHeader must be called before Gateway::Connect");
     }
+    m_lookaheadHeader = enabled;
+}
+
+void
+Gateway::SetResponseMode(RESPONSE_MODE mode, uint32_t keyframeInterval)
+{
+    NS_LOG_FUNCTION(this << mode << keyframeInterval);
 
-    std::string message = "";
-    for (uint32_t i = 0; i < m_data.size(); i++)
+    if (m_state != STATE::CREATED)
     {
-        if (i != 0)
-        {
-            message += m_delimiterField;
-        }
-        message += m_data[i];
+        NS_FATAL_ERROR("ERROR: Gateway::SetResponseMode must be called before Gateway::Connect");
+    }
+    if (keyframeInterval == 0)
+    {
+        NS_FATAL_ERROR("ERROR: Gateway::SetResponseMode called with a keyframe interval of 0");
     }
-    NS_LOG_DEBUG("Gateway sending the message: " << message);
-    message += m_delimiterMessage;
+    m_responseMode = mode;
+    m_keyframeInterval = keyframeInterval;
+}
+
+void
+Gateway::SetNextEventReport(bool enabled)
+{
+    NS_LOG_FUNCTION(this << enabled);
 
-    if (send(m_socket, message.c_str(), message.size(), 0) == -1)
+    if (m_state != STATE::CREATED)
     {
-        NS_LOG_WARN("WARNING: Gateway::SendResponse failed to send the message: " << message);
+        NS_FATAL_ERROR("ERROR: Gateway::SetNextEventReport must be called before Gateway::Connect");
     }
+    m_nextEventReport = enabled;
 }
 
-/* ========== PRIVATE MEMBER FUNCTIONS ====================================== */
+void
+Gateway::SetResponseHeader(bool enabled)
+{
+    NS_LOG_FUNCTION(this << enabled);
+
+    if (m_state != STATE::CREATED)
+    {
+        NS_FATAL_ERROR("ERROR: Gateway::SetResponseHeader must be called before Gateway::Connect");
+    }
+    m_responseHeader = enabled;
+}
 
 void
-Gateway::Stop() // how does this interact with NS_FATAL_ERROR ?
+Gateway::WatchEvent(const EventId & event)
 {
     NS_LOG_FUNCTION(this);
 
-    bool connected = (m_state == STATE::CONNECTED);
+    if (!event.IsExpired())
+    {
+        m_watchedEvents.push_back(event);
+    }
+}
 
-    m_state = STATE::STOPPING; // must set before m_thread.join() for the thread to exit
+void
+Gateway::SetReactor(Ptr<GatewayReactor> reactor)
+{
+    NS_LOG_FUNCTION(this << reactor);
 
-    if (connected)
+    if (m_state != STATE::CREATED)
     {
-        if (m_thread.joinable())
-        {
-            NS_LOG_LOGIC("waiting for the gateway thread to stop...");
-            m_thread.join(); // wait for the thread to stop
-            NS_LOG_LOGIC("...gateway thread stopped.");
-        }
-        close(m_socket);
+        NS_FATAL_ERROR("ERROR: Gateway::SetReactor must be called before Gateway::Connect");
     }
+    m_reactor = reactor;
+}
 
-    if (m_eventWait.IsPending())
+void
+Gateway::SetReceiveSize(uint32_t size)
+{
+    NS_LOG_FUNCTION(this << size);
+
+    if (m_state != STATE::CREATED)
     {
-        m_eventWait.Cancel();
-        NS_LOG_DEBUG("wait event cancelled");
+        NS_FATAL_ERROR("ERROR: Gateway::SetReceiveSize must be called before Gateway::Connect");
     }
-
-    if (m_eventDestroy.IsPending()) // if Gateway::Stop was called before Simulator::Stop
+    if (size == 0)
     {
-        m_eventDestroy.Cancel();
-        NS_LOG_DEBUG("destroy event cancelled");
+        NS_FATAL_ERROR("ERROR: Gateway::SetReceiveSize called with a size of 0");
     }
-
-    NS_LOG_INFO("Gateway stopped");
+    m_receiveSize = size;
 }
 
 void
-Gateway::RunThread()
+Gateway::SetReadThreadParsing(bool enabled)
 {
-    NS_LOG_FUNCTION(this);
+    NS_LOG_FUNCTION(this << enabled);
 
-    const size_t BUFFER_SIZE = 4096;
-    char recvBuffer[BUFFER_SIZE];   // buffer for recv call
-    std::string receivedData;       // received message content
-    size_t messageSize;             // received message size (excluding the message delimiter)
+    if (m_state != STATE::CREATED)
+    {
+        NS_FATAL_ERROR("ERROR: Gateway::SetReadThreadParsing must be called before Gateway::Connect");
+    }
+    m_readThreadParsing = enabled;
+}
 
-    while (m_state == STATE::CONNECTED)
+void
+Gateway::SetAsyncSend(bool enabled)
+{
+    NS_LOG_FUNCTION(this << enabled);
+
+    if (m_state != STATE::CREATED)
     {
-        receivedData = m_messageBuffer;  // recover any partially received message
+        NS_FATAL_ERROR("ERROR: Gateway::SetAsyncSend must be called before Gateway::Connect");
+    }
+    m_asyncSend = enabled;
+}
 
-        // this loop has the following possible outcomes:
-        //  messageSize = receivedData.size() - m_delimiterMessage.size()   [received one message]
-        //  messageSize < receivedData.size() - m_delimiterMessage.size()   [received more than one message]
-        //  messageSize = std::string::npos                                 [unable to receive messages]
-        while ((messageSize = receivedData.find(m_delimiterMessage)) == std::string::npos)
-        {
-            NS_LOG_LOGIC("\twaiting to receive data...");
-            int bytesReceived = recv(m_socket, &recvBuffer[0], BUFFER_SIZE, 0);
+void
+Gateway::SetRecordFile(const std::string & messagePath, const std::string & responsePath)
+{
+    NS_LOG_FUNCTION(this << messagePath << responsePath);
 
-            if (bytesReceived > 0)
-            {
-                NS_LOG_LOGIC("\t...data received");
-                receivedData.append(&recvBuffer[0], bytesReceived);
-            }
-            else if (bytesReceived == 0) // connection closed
-            {
-                NS_LOG_LOGIC("\t...connection closed");
-                if (!receivedData.empty())
-                {
-                    NS_LOG_WARN("WARNING: dropped partial message " << receivedData);
-                }
-                break; // messageSize = std::string::npos  
-            }
-            else
-            {
-                NS_LOG_ERROR("ERROR: gateway socket connection error");
-                break; // messageSize = std::string::npos  
-            }
-        }
+    if (m_state != STATE::CREATED)
+    {
+        NS_FATAL_ERROR("ERROR: Gateway::SetRecordFile must be called before Gateway::Connect");
+    }
+    m_messageRecordPath = messagePath;
+    m_responseRecordPath = responsePath;
+}
 
-        // RunThread needs the main thread to execute the next function (either Stop or ForwardUp)
-        // it schedules the function on behalf of the main thread's m_context to execute now
-        // Simulator::ScheduleWithContext is thread safe
-        if (messageSize == std::string::npos)
-        {
-            Simulator::ScheduleWithContext(m_context, Time(0), MakeEvent(&Gateway::Stop, this));
-            break; // prevent additional receive attempts
-        }
+Gateway::SendStatistics
+Gateway::GetSendStatistics() const
+{
+    SendStatistics statistics;
+    statistics.queuedBytes = m_queuedBytes.load();
+    statistics.sentResponses = m_sentResponses.load();
+    statistics.sentBytes = m_sentBytes.load();
+    statistics.meanLatency = NanoSeconds(statistics.sentResponses == 0 ? 0
+                                         : m_sendLatencyTotal.load() / int64_t(statistics.sentResponses));
+    statistics.maxLatency = NanoSeconds(m_sendLatencyMax.load());
+    return statistics;
+}
 
-        std::string receivedMessage = receivedData.substr(0, messageSize);
-        m_messageBuffer = receivedData.substr(messageSize + m_delimiterMessage.size());
+void
+Gateway::SetTimingHistograms(bool enabled)
+{
+    NS_LOG_FUNCTION(this << enabled);
 
-        NS_LOG_DEBUG("forwarding new message: " << receivedMessage);
-        {   // critical section start
-            std::unique_lock lock(m_messageQueueMutex);
-            m_messageQueue.push(receivedMessage);    
-        }   // critical section end
-        Simulator::ScheduleWithContext(m_context, Time(0), MakeEvent(&Gateway::ForwardUp, this));
+    m_timingHistograms = enabled;
+}
+
+const LatencyHistogram &
+Gateway::GetTimingHistogram(TIMING_STAGE stage) const
+{
+    if (stage >= TIMING_STAGE_COUNT)
+    {
+        NS_FATAL_ERROR("ERROR: Gateway::GetTimingHistogram called with an invalid stage " << stage);
     }
+    return m_histograms[stage];
 }
 
 void
-Gateway::WaitForNextUpdate() // do not add log output to this function
+Gateway::PrintTimingSummary(std::ostream & os) const
 {
-    if (m_state != STATE::STOPPING) // this probably isn't necessary
+    static const char * STAGE_NAMES[TIMING_STAGE_COUNT] = {"server wait", "queue", "parse", "events", "update",
+                                                           "response"};
+    for (uint32_t stage = 0; stage < TIMING_STAGE_COUNT; stage++)
     {
-        if (m_eventWait.IsPending())
-        {
-            NS_LOG_WARN("WARNING: Gateway::WaitForNextUpdate scheduled multiple times"); // except this one!
-            m_eventWait.Cancel();
-        }
-        // pause Simulator time progression until this event is cancelled
-        m_eventWait = Simulator::ScheduleNow(&Gateway::WaitForNextUpdate, this);
+        os << STAGE_NAMES[stage] << ": ";
+        m_histograms[stage].Print(os);
+        os << std::endl;
     }
 }
 
 void
-Gateway::ForwardUp()
+Gateway::SetPacing(double speed)
 {
-    NS_LOG_FUNCTION(this);
-
-    // get the message to process
-    std::string message;
-    {   // critical section start
-        std::unique_lock lock(m_messageQueueMutex);
-        if (m_messageQueue.empty())
-        {
-            NS_FATAL_ERROR("Gateway::ForwardUp called without any queued messages");
-        }
-        message = m_messageQueue.front();
-        m_messageQueue.pop();
-    }   // critical section end
-    NS_LOG_DEBUG("processing message: " << message);
+    NS_LOG_FUNCTION(this << speed);
 
-    // split the message into values
-    size_t index;
-    std::vector<std::string> values;
-    while ((index = message.find(m_delimiterField)) != std::string::npos)
+    if (m_state != STATE::CREATED)
     {
-        values.push_back(message.substr(0, index));
-        message.erase(0, index + m_delimiterField.size());
+        NS_FATAL_ERROR("ERROR: Gateway::SetPacing must be called before Gateway::Connect");
     }
-    values.push_back(message);
-
-    // remove the timestamp header
-    Time timestamp;
-    try
+    if (speed < 0)
     {
-        const std::string & seconds = values.at(0);     // int32 represented as string
-        const std::string & nanoseconds = values.at(1); // uint32 represented as string
-        timestamp = Seconds(std::stoi(seconds)) + NanoSeconds(std::stol(nanoseconds));
-        NS_LOG_DEBUG("received time: " << timestamp);
+        NS_FATAL_ERROR("ERROR: Gateway::SetPacing called with a negative speed");
     }
-    catch (std::exception & e)
+    m_pacingSpeed = speed;
+}
+
+Gateway::PacingStatistics
+Gateway::GetPacingStatistics() const
+{
+    PacingStatistics statistics;
+    statistics.deadlines = m_pacingDeadlines;
+    statistics.misses = m_pacingMisses;
+    statistics.minSlack = m_pacingMinSlack;
+    uint64_t waits = m_pacingDeadlines - m_pacingMisses;
+    statistics.meanJitter = (waits > 0) ? NanoSeconds(m_pacingJitterTotal.GetNanoSeconds() / int64_t(waits)) : Time(0);
+    statistics.maxJitter = m_pacingJitterMax;
+    return statistics;
+}
+
+void
+Gateway::SetValue(uint32_t index, const std::string & value)
+{
+    NS_LOG_FUNCTION(this << index << value);
+
+    SetFormattedValue(index, value.data(), value.size(), true);
+}
+
+void
+Gateway::SetValue(uint32_t index, const char * value)
+{
+    NS_LOG_FUNCTION(this << index << value);
+
+    SetFormattedValue(index, value, std::strlen(value), true);
+}
+
+void
+Gateway::SetValue(uint32_t index, double value)
+{
+    NS_LOG_FUNCTION(this << index << value);
+
+    if (m_framing == FRAMING::BINARY)
     {
-        NS_FATAL_ERROR("ERROR: received invalid message header");
+        m_encoded.clear();
+        BinaryEncoder::AppendDouble(m_encoded, value);
+        SetFieldValue(index, m_encoded.data(), m_encoded.size());
+        return;
     }
-    values.erase(values.begin(), values.begin()+2);
 
-    // process based on timestamp content
-    if (timestamp.IsStrictlyNegative()) // signal to terminate
+    char buffer[64];
+    size_t size;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    std::to_chars_result result = (m_precision == 0)
+        ? std::to_chars(buffer, buffer + sizeof(buffer), value)
+        : std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, m_precision);
+    size = result.ptr - buffer;
+#else
+    // without floating point std::to_chars, 17 significant digits always convert back to the same value
+    size = std::snprintf(buffer, sizeof(buffer), "%.*g", (m_precision == 0) ? 17 : int(m_precision), value);
+#endif
+    SetFormattedValue(index, buffer, size, m_checkNumbers);
+}
+
+void
+Gateway::SetPrecision(uint32_t precision)
+{
+    NS_LOG_FUNCTION(this << precision);
+
+    m_precision = std::min<uint32_t>(precision, 40); // 64 characters hold at most 40 significant digits
+}
+
+void
+Gateway::SendResponse()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_state != STATE::CONNECTED)
     {
-        NS_LOG_INFO("Gateway received the terminate message");
-        Simulator::Stop();
+        NS_FATAL_ERROR("ERROR: Gateway::SendResponse called without an active connection to the server");
     }
-    else if (m_timeStart.IsStrictlyNegative()) // first value received
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    bool isDelta = (m_responseMode == RESPONSE_MODE::DELTA);
+    bool isKeyframe = !isDelta || (m_responseCount % m_keyframeInterval == 0);
+
+    // the server time equivalent to the current simulation time
+    int64_t serverTime = (Simulator::Now() + Max(m_timeStart, Time(0))).GetNanoSeconds();
+
+    m_response.clear();
+    if (m_framing == FRAMING::BINARY)
     {
-        m_timeStart = timestamp;
-        NS_LOG_INFO("Gateway reference time set as " << timestamp);
-        Simulator::ScheduleNow(&Gateway::DoInitialize, this, values);
+        m_response.resize(BinaryEncoder::HEADER_SIZE);
+        if (m_responseHeader)
+        {
+            BinaryEncoder::AppendInt64(m_response, m_sequence);
+        }
+        if (m_nextEventReport)
+        {
+            BinaryEncoder::AppendInt64(m_response, GetNextEventTime());
+        }
+        if (isDelta)
+        {
+            BinaryEncoder::AppendBytes(m_response, isKeyframe ? "K" : "D", 1);
+        }
+        if (isKeyframe)
+        {
+            for (uint32_t i = 0; i < m_data.size(); i++)
+            {
+                m_response += m_data[i]; // already an encoded field
+            }
+        }
+        else
+        {
+            for (uint32_t index : m_changedIndices)
+            {
+                BinaryEncoder::AppendInt32(m_response, index);
+                m_response += m_data[index];
+            }
+        }
+        BinaryEncoder::WriteHeader(m_response, serverTime / 1000000000, serverTime % 1000000000);
+        NS_LOG_DEBUG("Gateway sending a binary message of " << m_response.size() << " bytes");
     }
-    else // normal message
+    else
     {
-        if (m_eventWait.IsPending())
+        // the fields that precede the values
+        char number[24];
+        auto appendNumber = [this, &number](int64_t value) {
+            if (!m_response.empty())
+            {
+                m_response += m_delimiterField;
+            }
+            m_response.append(number, std::to_chars(number, number + sizeof(number), value).ptr - number);
+        };
+        if (m_responseHeader)
         {
-            m_eventWait.Cancel();
+            appendNumber(serverTime / 1000000000);
+            appendNumber(serverTime % 1000000000);
+            appendNumber(m_sequence);
         }
-        NS_LOG_LOGIC("...update received for " << timestamp);
-
-        // calculate the time difference
-        m_timePause = timestamp - m_timeStart;
-        ns3::Time timeDelta = m_timePause - Simulator::Now();
-        if (timeDelta.IsStrictlyNegative()) // 0 allowed
+        if (m_nextEventReport)
+        {
+            appendNumber(GetNextEventTime());
+        }
+        if (isDelta)
+        {
+            if (!m_response.empty())
+            {
+                m_response += m_delimiterField;
+            }
+            m_response += isKeyframe ? "K" : "D";
+        }
+        bool hasPrefix = !m_response.empty();
+        if (isKeyframe)
+        {
+            for (uint32_t i = 0; i < m_data.size(); i++)
+            {
+                if (i != 0 || hasPrefix)
+                {
+                    m_response += m_delimiterField;
+                }
+                m_response += m_data[i];
+            }
+        }
+        else
         {
-            NS_FATAL_ERROR("ERROR: received timestamps were not increasing values");
+            char index[16];
+            for (uint32_t i : m_changedIndices)
+            {
+                m_response += m_delimiterField;
+                m_response.append(index, std::to_chars(index, index + sizeof(index), i).ptr - index);
+                m_response += m_delimiterField;
+                m_response += m_data[i];
+            }
         }
-        NS_LOG_INFO("advancing time from " << Simulator::Now() << " to " << m_timePause);
-        Simulator::Schedule(timeDelta, &Gateway::HandleUpdate, this, values);
+        NS_LOG_DEBUG("Gateway sending the message: " << m_response);
+        m_response += m_delimiterMessage;
     }
-}
 
-void
-Gateway::HandleUpdate(const std::vector<std::string> & data)
-{
-    NS_LOG_FUNCTION(this << data);
-
-    if (Simulator::Now() == m_timePause)
+    // the next response only includes values changed after this one
+    for (uint32_t index : m_changedIndices)
     {
-        NS_LOG_LOGIC("waiting for next update...");
-        m_eventWait = Simulator::ScheduleNow(&Gateway::WaitForNextUpdate, this);
+        m_changed[index] = false;
     }
-    DoUpdate(data);
+    m_changedIndices.clear();
+    m_responseCount++;
+
+    if (!m_asyncSend)
+    {
+        TransmitResponse(m_response, start);
+    }
+    else
+    {
+        // hand the response to the writer thread, receiving a buffer it has finished sending in exchange
+        TimedMessage pending;
+        pending.data.swap(m_response);
+        pending.time = start;
+        m_queuedBytes.fetch_add(pending.data.size());
+        while (!m_sendQueue.Push(pending))
+        {
+            // the queue is full, and the writer thread only empties it while the connection is open
+            if (m_threadExited || m_state != STATE::CONNECTED)
+            {
+                NS_LOG_WARN("WARNING: Gateway::SendResponse dropped a message of " << pending.data.size()
+                    << " bytes because the connection closed");
+                m_queuedBytes.fetch_sub(pending.data.size());
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        m_response.swap(pending.data);
+
+        {   // critical section start (prevents a lost wakeup in Gateway::RunWriterThread)
+            std::unique_lock lock(m_sendMutex);
+        }   // critical section end
+        m_sendCondition.notify_one();
+    }
+
+    if (m_timingResponse)
+    {
+        m_responseDuration += std::chrono::steady_clock::now() - start;
+    }
+}
+
+/* ========== PRIVATE MEMBER FUNCTIONS ====================================== */
+
+void
+Gateway::Stop() // how does this interact with NS_FATAL_ERROR ?
+{
+    NS_LOG_FUNCTION(this);
+
+    bool connected = (m_state == STATE::CONNECTED);
+
+    m_state = STATE::STOPPING; // must set before m_thread.join() for the thread to exit
+
+    if (connected)
+    {
+        if (m_writerThread.joinable())
+        {
+            std::unique_lock lock(m_sendMutex);
+            m_writerStopping = true;
+            m_sendCondition.notify_all();
+            NS_LOG_LOGIC("waiting for the writer thread to send queued responses...");
+            // a server that stopped reading would block the writer thread in GatewayTransport::Send forever
+            if (!m_sendCondition.wait_for(lock, WRITER_DRAIN_TIMEOUT, [this] { return m_writerExited; }))
+            {
+                NS_LOG_WARN("WARNING: Gateway::Stop dropped the queued responses that could not be sent within "
+                    << WRITER_DRAIN_TIMEOUT.count() << " ms");
+            }
+        }
+        if (m_reactorRegistered)
+        {
+            m_reactor->Remove(m_transport->GetDescriptor()); // waits for an executing Gateway::HandleReadable
+            m_reactorRegistered = false;
+        }
+        m_transport->Shutdown(); // the threads may be blocked in GatewayTransport::Receive or GatewayTransport::Send
+        if (m_writerThread.joinable())
+        {
+            m_writerThread.join();
+            NS_LOG_LOGIC("...writer thread stopped.");
+        }
+        if (m_thread.joinable())
+        {
+            NS_LOG_LOGIC("waiting for the gateway thread to stop...");
+            m_thread.join(); // wait for the thread to stop
+            NS_LOG_LOGIC("...gateway thread stopped.");
+        }
+        m_transport->Close();
+        SetWaking(false);
+        m_messageRecorder.Close();
+        m_responseRecorder.Close();
+    }
+
+    if (m_eventWait.IsPending())
+    {
+        m_eventWait.Cancel();
+        NS_LOG_DEBUG("wait event cancelled");
+    }
+    if (m_coordinator != nullptr)
+    {
+        m_coordinator->Remove(this);
+    }
+
+    if (m_eventDestroy.IsPending()) // if Gateway::Stop was called before Simulator::Stop
+    {
+        m_eventDestroy.Cancel();
+        NS_LOG_DEBUG("destroy event cancelled");
+    }
+
+    NS_LOG_INFO("Gateway stopped");
+}
+
+void
+Gateway::HandleClose()
+{
+    NS_LOG_FUNCTION(this);
+
+    // the gateway can no longer receive a message, so it must not prevent the main thread from blocking
+    SetWaking(false);
+
+    // after the terminate message, updates that were received before it may still be scheduled, and the simulator
+    // already stops at the last granted time (Gateway::Stop then executes when the simulator is destroyed)
+    if (!m_terminated)
+    {
+        Stop();
+    }
+}
+
+void
+Gateway::RunWriterThread()
+{
+    NS_LOG_FUNCTION(this);
+
+    while (true)
+    {
+        while (m_sendQueue.Pop(m_writerResponse)) // m_writerResponse's previous buffer is returned to SendResponse
+        {
+            m_queuedBytes.fetch_sub(m_writerResponse.data.size());
+            TransmitResponse(m_writerResponse.data, m_writerResponse.time);
+        }
+
+        // responses are always queued before Gateway::Stop sets m_writerStopping, so they are sent before exiting
+        std::unique_lock lock(m_sendMutex);
+        m_sendCondition.wait(lock, [this] { return m_writerStopping || !m_sendQueue.IsEmpty(); });
+        if (m_sendQueue.IsEmpty())
+        {
+            m_writerExited = true;
+            m_sendCondition.notify_all(); // wake Gateway::Stop
+            break;
+        }
+    }
+}
+
+void
+Gateway::TransmitResponse(const std::string & response, std::chrono::steady_clock::time_point queued)
+{
+    bool sent = m_transport->Send(response.data(), response.size());
+    if (m_responseRecorder.IsOpen())
+    {
+        m_responseRecorder.Record(std::chrono::steady_clock::now(), response);
+    }
+
+    int64_t latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - queued).count();
+    m_sentResponses.fetch_add(1);
+    m_sentBytes.fetch_add(response.size());
+    m_sendLatencyTotal.fetch_add(latency);
+    if (latency > m_sendLatencyMax.load()) // only one thread sends responses
+    {
+        m_sendLatencyMax.store(latency);
+    }
+
+    if (!sent)
+    {
+        NS_LOG_WARN("WARNING: Gateway::SendResponse failed to send a message of " << response.size() << " bytes");
+    }
+}
+
+void
+Gateway::RunThread()
+{
+    NS_LOG_FUNCTION(this);
+
+    while (m_state == STATE::CONNECTED)
+    {
+        NS_LOG_LOGIC("\twaiting to receive data...");
+        size_t writableSize;
+        char * writable = m_receiveBuffer.GetWritable(m_receiveSize, writableSize);
+        if (!HandleReceived(m_transport->Receive(writable, writableSize)))
+        {
+            break; // prevent additional receive attempts
+        }
+    }
+}
+
+bool
+Gateway::HandleReadable()
+{
+    if (m_state != STATE::CONNECTED)
+    {
+        return false;
+    }
+
+    // queue the messages received before the reactor paused the transport, and only receive more if they fit
+    if (!ForwardReceived())
+    {
+        return false;
+    }
+    if (m_receivePaused)
+    {
+        return true;
+    }
+
+    size_t writableSize;
+    char * writable = m_receiveBuffer.GetWritable(m_receiveSize, writableSize);
+    ssize_t bytesReceived = m_transport->Receive(writable, writableSize);
+    if (bytesReceived == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+    {
+        return true; // the data was already received
+    }
+    return HandleReceived(bytesReceived);
+}
+
+bool
+Gateway::HandleReceived(ssize_t bytesReceived)
+{
+    if (bytesReceived > 0)
+    {
+        NS_LOG_LOGIC("\t...data received");
+        m_receiveBuffer.Commit(bytesReceived);
+        return ForwardReceived();
+    }
+
+    if (m_state != STATE::CONNECTED)
+    {
+        m_threadExited = true; // Gateway::Stop shut down the transport, and is waiting for the thread to exit
+        return false;
+    }
+
+    if (bytesReceived == 0) // connection closed
+    {
+        NS_LOG_LOGIC("\t...connection closed");
+        if (m_receiveBuffer.GetSize() > 0)
+        {
+            NS_LOG_WARN("WARNING: dropped a partial message of " << m_receiveBuffer.GetSize() << " bytes");
+        }
+    }
+    else
+    {
+        NS_LOG_ERROR("ERROR: gateway transport connection error");
+    }
+
+    // the main thread needs to execute Gateway::HandleClose
+    // it is scheduled on behalf of the main thread's m_context to execute now
+    // Simulator::ScheduleWithContext is thread safe
+    Simulator::ScheduleWithContext(m_context, Time(0), MakeEvent(&Gateway::HandleClose, this));
+    m_threadExited = true;
+    WakeMainThread();
+    return false;
+}
+
+bool
+Gateway::ForwardReceived()
+{
+    size_t messageSize;             // received message size (excluding the message delimiter)
+    size_t trailerSize;             // received message delimiter size
+
+    while (m_state == STATE::CONNECTED)
+    {
+        if (!m_receivedPending)
+        {
+            if (!FindMessage(messageSize, trailerSize))
+            {
+                break;
+            }
+            m_receiveBuffer.Read(messageSize, m_receivedMessage.data); // the only copy of the received message content
+            m_receiveBuffer.Consume(trailerSize);
+            m_receivedMessage.time = std::chrono::steady_clock::now();
+            if (m_messageRecorder.IsOpen())
+            {
+                m_messageRecorder.Record(m_receivedMessage.time, m_receivedMessage.data,
+                    std::string_view(m_delimiterMessage).substr(0, trailerSize));
+            }
+
+            NS_LOG_DEBUG("forwarding new message of " << m_receivedMessage.data.size() << " bytes");
+
+            // decode the message here, so that the main thread only schedules it (see Gateway::SetReadThreadParsing)
+            m_receivedMessage.parsed = m_readThreadParsing;
+            m_receivedStaged = true;
+            if (m_readThreadParsing)
+            {
+                m_receivedMessage.message.Assign(m_receivedMessage.data);
+                ParseMessage(m_receivedMessage.message, m_receivedMessage.timestamp, m_receivedMessage.lookahead);
+                m_receivedStaged = m_receivedMessage.timestamp.IsStrictlyNegative(); // the terminate message
+            }
+            m_receivedPending = true;
+        }
+
+        if (!m_receivedStaged)
+        {
+            m_receivedStaged = DoStage(m_receivedMessage.message);
+        }
+        // on success, m_receivedMessage now holds a buffer released by ForwardUp
+        if (!m_receivedStaged || !m_messageQueue.Push(m_receivedMessage))
+        {
+            if (!m_reactorRegistered)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(100)); // wait for the main thread
+                continue;
+            }
+            if (m_receivePaused)
+            {
+                return true; // still full after pausing, so Gateway::ResumeReceiving calls this function again
+            }
+
+            // a reactor thread must not wait: stop receiving until the main thread releases space, and then check
+            // again, in case the space was released before m_receivePaused was set
+            m_receivePaused = true;
+            m_reactor->Pause(m_transport->GetDescriptor());
+            continue;
+        }
+        m_receivedPending = false;
+
+        // the space was released before Gateway::ResumeReceiving could see m_receivePaused
+        if (m_receivePaused.exchange(false))
+        {
+            m_reactor->Resume(m_transport->GetDescriptor());
+        }
+
+        // only schedule ForwardUp if the main thread is not already going to drain the queue
+        // Simulator::ScheduleWithContext is thread safe
+        if (!m_forwardScheduled.exchange(true, std::memory_order_acq_rel))
+        {
+            Simulator::ScheduleWithContext(m_context, Time(0), MakeEvent(&Gateway::ForwardUp, this));
+            WakeMainThread();
+        }
+    }
+    return m_state == STATE::CONNECTED;
+}
+
+bool
+Gateway::FindMessage(size_t & messageSize, size_t & trailerSize)
+{
+    messageSize = std::string::npos;
+    trailerSize = 0;
+
+    if (m_framing == FRAMING::BINARY)
+    {
+        char header[BinaryEncoder::HEADER_SIZE];
+        int32_t seconds;
+        uint32_t nanoseconds;
+        uint32_t payloadSize;
+        if (m_receiveBuffer.GetSize() < BinaryEncoder::HEADER_SIZE)
+        {
+            return false;
+        }
+        m_receiveBuffer.Peek(header, BinaryEncoder::HEADER_SIZE);
+        BinaryDecoder::ReadHeader(header, BinaryEncoder::HEADER_SIZE, seconds, nanoseconds, payloadSize);
+        if (m_receiveBuffer.GetSize() - BinaryEncoder::HEADER_SIZE < payloadSize)
+        {
+            return false;
+        }
+        messageSize = BinaryEncoder::HEADER_SIZE + payloadSize;
+        return true;
+    }
+
+    if (!m_receiveBuffer.Find(m_delimiterMessage, messageSize))
+    {
+        messageSize = std::string::npos;
+        return false;
+    }
+    trailerSize = m_delimiterMessage.size();
+    return true;
+}
+
+bool
+Gateway::ParseTextMessage(GatewayMessage & message, Time & timestamp) const
+{
+    message.SplitText(m_delimiterField);
+    if (message.GetSize() < 2)
+    {
+        return false;
+    }
+
+    // remove the timestamp header
+    int64_t secondsValue;       // int32 represented as string
+    int64_t nanosecondsValue;   // int64 represented as string
+    if (!ParseTimestampElement(message[0], secondsValue) || !ParseTimestampElement(message[1], nanosecondsValue)
+        || secondsValue < INT32_MIN || secondsValue > INT32_MAX)
+    {
+        return false;
+    }
+    timestamp = Seconds(secondsValue) + NanoSeconds(nanosecondsValue);
+    message.RemoveFront(2);
+    return true;
+}
+
+bool
+Gateway::ParseBinaryMessage(GatewayMessage & message, Time & timestamp) const
+{
+    const std::string & data = message.GetBuffer();
+    int32_t seconds;
+    uint32_t nanoseconds;
+    uint32_t payloadSize;
+    if (!BinaryDecoder::ReadHeader(data.data(), data.size(), seconds, nanoseconds, payloadSize)
+        || data.size() != BinaryEncoder::HEADER_SIZE + payloadSize)
+    {
+        return false;
+    }
+    timestamp = Seconds(seconds) + NanoSeconds(nanoseconds);
+
+    // split the payload into encoded fields
+    return message.SplitBinary(BinaryEncoder::HEADER_SIZE);
+}
+
+bool
+Gateway::ParseLookahead(GatewayMessage & message, Time & lookahead) const
+{
+    if (message.GetSize() < 1)
+    {
+        return false;
+    }
+    std::string_view value = message[0];
+    int64_t nanoseconds;
+    if (m_framing == FRAMING::BINARY)
+    {
+        if (!BinaryDecoder(value.data(), value.size()).ReadInt64(nanoseconds))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        auto result = std::from_chars(value.data(), value.data() + value.size(), nanoseconds);
+        if (result.ec != std::errc() || result.ptr != value.data() + value.size())
+        {
+            return false;
+        }
+    }
+    if (nanoseconds < 0)
+    {
+        return false;
+    }
+    lookahead = NanoSeconds(nanoseconds);
+    message.RemoveFront(1);
+    return true;
+}
+
+void
+Gateway::ParseMessage(GatewayMessage & message, Time & timestamp, Time & lookahead) const
+{
+    bool isValid = (m_framing == FRAMING::BINARY) ? ParseBinaryMessage(message, timestamp)
+                                                  : ParseTextMessage(message, timestamp);
+    if (!isValid)
+    {
+        NS_FATAL_ERROR("ERROR: received invalid message header");
+    }
+
+    lookahead = m_lookahead;
+    if (!timestamp.IsStrictlyNegative() && m_lookaheadHeader && !ParseLookahead(message, lookahead))
+    {
+        NS_FATAL_ERROR("ERROR: received invalid lookahead");
+    }
+}
+
+int64_t
+Gateway::GetNextEventTime()
+{
+    m_watchedEvents.erase(std::remove_if(m_watchedEvents.begin(), m_watchedEvents.end(),
+                                         [](const EventId & event) { return event.IsExpired(); }),
+                          m_watchedEvents.end());
+    if (m_watchedEvents.empty())
+    {
+        return -1;
+    }
+    uint64_t next = m_watchedEvents[0].GetTs();
+    for (const EventId & event : m_watchedEvents)
+    {
+        next = std::min(next, event.GetTs());
+    }
+    return (TimeStep(next) + Max(m_timeStart, Time(0))).GetNanoSeconds();
+}
+
+void
+Gateway::SetFormattedValue(uint32_t index, const char * value, size_t size, bool checkDelimiters)
+{
+    if (index >= m_data.size())
+    {
+        NS_FATAL_ERROR("ERROR: Gateway::SetValue called with i=" << index << " for a max size of " << m_data.size());
+    }
+    if (m_framing == FRAMING::BINARY)
+    {
+        m_encoded.clear();
+        BinaryEncoder::AppendBytes(m_encoded, value, size);
+        SetFieldValue(index, m_encoded.data(), m_encoded.size());
+        return;
+    }
+    std::string_view view(value, size);
+    if (checkDelimiters)
+    {
+        if (view.find(m_delimiterField) != std::string_view::npos)
+        {
+            NS_FATAL_ERROR("ERROR: Gateway::SetValue called with a value containing the protocol field delimiter");
+        }
+        if (view.find(m_delimiterMessage) != std::string_view::npos)
+        {
+            NS_FATAL_ERROR("ERROR: Gateway::SetValue called with a value containing the protocol message delimiter");
+        }
+    }
+    SetFieldValue(index, value, size);
+}
+
+void
+Gateway::SetFieldValue(uint32_t index, const char * value, size_t size)
+{
+    if (index >= m_data.size())
+    {
+        NS_FATAL_ERROR("ERROR: Gateway::SetValue called with i=" << index << " for a max size of " << m_data.size());
+    }
+    if (m_data[index] == std::string_view(value, size))
+    {
+        return;
+    }
+    m_data[index].assign(value, size); // re-uses the memory of the previous value if it is large enough
+    if (!m_changed[index])
+    {
+        m_changed[index] = true;
+        m_changedIndices.push_back(index);
+    }
+}
+
+void
+Gateway::GrantTime(Time timeGrant)
+{
+    NS_LOG_FUNCTION(this << timeGrant);
+
+    if (m_eventWait.IsPending())
+    {
+        m_eventWait.Cancel();
+    }
+    m_timePause = timeGrant;
+    m_paused = false;
+    if (m_coordinator != nullptr)
+    {
+        m_coordinator->UpdateGrant();
+        return;
+    }
+    m_eventWait = Simulator::Schedule(timeGrant - Simulator::Now(), &Gateway::WaitForNextUpdate, this);
+}
+
+void
+Gateway::WaitForNextUpdate() // do not add log output to this function
+{
+    if (m_state != STATE::STOPPING) // this probably isn't necessary
+    {
+        if (m_eventWait.IsPending())
+        {
+            NS_LOG_WARN("WARNING: Gateway::WaitForNextUpdate scheduled multiple times"); // except this one!
+            m_eventWait.Cancel();
+        }
+        if (m_pacingSpeed > 0)
+        {
+            PaceToNow(); // the granted time is a deadline
+        }
+        if (!m_paused && IsTimingEnabled()) // the first call since the time grant
+        {
+            m_paused = true;
+            m_pausedAt = std::chrono::steady_clock::now();
+        }
+        if (m_idleMode == IDLE_MODE::BLOCK)
+        {
+            BlockUntilReceive();
+        }
+        // pause Simulator time progression until this event is cancelled
+        m_eventWait = Simulator::ScheduleNow(&Gateway::WaitForNextUpdate, this);
+    }
+}
+
+void
+Gateway::PaceToNow() // do not add log output to this function
+{
+    Time now = Simulator::Now();
+    if (m_pacedTime == Time::Max() || now <= m_pacedTime)
+    {
+        return; // waiting for the first message, or this time was already paced
+    }
+    m_pacedTime = now;
+
+    std::chrono::steady_clock::time_point deadline = m_pacingStart + std::chrono::nanoseconds(
+        int64_t((now - m_pacingOrigin).GetNanoSeconds() / m_pacingSpeed));
+    std::chrono::steady_clock::time_point reached = std::chrono::steady_clock::now();
+
+    PacingTiming timing;
+    timing.timestamp = now;
+    timing.slack = NanoSeconds(std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - reached).count());
+    timing.jitter = Time(0);
+    if (reached < deadline)
+    {
+        std::this_thread::sleep_until(deadline);
+        timing.jitter = NanoSeconds(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - deadline).count());
+        m_pacingJitterTotal += timing.jitter;
+        m_pacingJitterMax = Max(m_pacingJitterMax, timing.jitter);
+    }
+    else
+    {
+        m_pacingMisses++;
+    }
+    m_pacingMinSlack = (m_pacingDeadlines == 0) ? timing.slack : Min(m_pacingMinSlack, timing.slack);
+    m_pacingDeadlines++;
+    m_pacingTrace(timing);
+}
+
+void
+Gateway::BlockUntilReceive() // do not add log output to this function
+{
+    if (IsOnlyWaiting(m_idleEventCount, m_idleWaitEventCount))
+    {
+        WaitForAnyReceive(this);
+    }
+}
+
+bool
+Gateway::IsOnlyWaiting(uint64_t & eventCount, uint64_t & waitEventCount) // do not add log output to this function
+{
+    // each wait event is scheduled behind every event already pending for the current time, so if only wait events
+    // (of this or other paused gateways) executed since the caller's previous one, nothing else remains to be processed
+    g_waitEventCount++;
+    uint64_t otherEvents = (Simulator::GetEventCount() - eventCount) - (g_waitEventCount - waitEventCount);
+    eventCount = Simulator::GetEventCount();
+    waitEventCount = g_waitEventCount;
+    return otherEvents == 0;
+}
+
+void
+Gateway::WaitForAnyReceive(const Gateway * gateway) // do not add log output to this function
+{
+    std::unique_lock lock(g_waitMutex);
+    g_waitCondition.wait(lock, [gateway] {
+        return (gateway != nullptr && gateway->m_threadExited.load()) || IsAnyReceived();
+    });
+}
+
+bool
+Gateway::IsAnyReceived()
+{
+    for (const Gateway * gateway : g_wakingGateways)
+    {
+        if (gateway->m_forwardScheduled.load() || gateway->m_threadExited.load())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+Gateway::WakeMainThread()
+{
+    {   // critical section start (prevents a lost wakeup in Gateway::WaitForAnyReceive)
+        std::unique_lock lock(g_waitMutex);
+    }   // critical section end
+    g_waitCondition.notify_all();
+}
+
+void
+Gateway::SetWaking(bool waking)
+{
+    std::unique_lock lock(g_waitMutex);
+    auto position = std::find(g_wakingGateways.begin(), g_wakingGateways.end(), this);
+    if (waking && position == g_wakingGateways.end())
+    {
+        g_wakingGateways.push_back(this);
+    }
+    else if (!waking && position != g_wakingGateways.end())
+    {
+        g_wakingGateways.erase(position);
+    }
+}
+
+void
+Gateway::ForwardUp()
+{
+    NS_LOG_FUNCTION(this);
+
+    // clear the flag before draining, so that a message pushed after the last Pop schedules another ForwardUp
+    m_forwardScheduled.exchange(false, std::memory_order_acq_rel);
+
+    while (m_messageQueue.Pop(m_forwardBuffer)) // m_forwardBuffer's previous buffer is returned to the read thread
+    {
+        if (!ForwardMessage(m_forwardBuffer))
+        {
+            break; // terminate message
+        }
+    }
+    ResumeReceiving();
+}
+
+void
+Gateway::ResumeReceiving()
+{
+    if (m_receivePaused.exchange(false))
+    {
+        m_reactor->Resume(m_transport->GetDescriptor());
+    }
+}
+
+bool
+Gateway::ForwardMessage(ReceivedMessage & received)
+{
+    NS_LOG_FUNCTION(this);
+
+    PendingStep step;
+    step.measured = IsTimingEnabled();
+    std::chrono::steady_clock::time_point start;
+    if (step.measured)
+    {
+        start = std::chrono::steady_clock::now();
+        step.timing.serverWait = m_paused ? NanoSeconds(std::max<int64_t>(0, std::chrono::duration_cast<
+            std::chrono::nanoseconds>(received.time - m_pausedAt).count())) : Time(0);
+        step.timing.queue = NanoSeconds(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            start - received.time).count());
+    }
+
+    if (m_framing == FRAMING::TEXT)
+    {
+        NS_LOG_DEBUG("processing message: " << (received.parsed ? received.message.GetBuffer() : received.data));
+    }
+
+    // re-use the buffers of a previously processed message, if available
+    GatewayMessage message;
+    if (!m_updatePool.empty())
+    {
+        message = std::move(m_updatePool.back());
+        m_updatePool.pop_back();
+    }
+
+    // split the message into the timestamp header and values, unless the read thread already did
+    Time timestamp;
+    Time lookahead;
+    if (received.parsed)
+    {
+        std::swap(message, received.message); // the pooled buffers are returned to the read thread
+        timestamp = received.timestamp;
+        lookahead = received.lookahead;
+    }
+    else
+    {
+        message.Assign(received.data);
+        ParseMessage(message, timestamp, lookahead);
+    }
+    NS_LOG_DEBUG("received time: " << timestamp);
+
+    // process based on timestamp content
+    if (timestamp.IsStrictlyNegative()) // signal to terminate
+    {
+        NS_LOG_INFO("Gateway received the terminate message");
+        m_terminated = true;
+        if (m_coordinator != nullptr)
+        {
+            m_coordinator->Terminate(this); // the simulation stops once every federate terminated
+            return false;
+        }
+        Simulator::Stop(m_timePause - Simulator::Now()); // the last granted time, which is now without lookahead
+        return false;
+    }
+
+    if (m_timeStart.IsStrictlyNegative()) // first value received
+    {
+        m_timeStart = timestamp;
+        NS_LOG_INFO("Gateway reference time set as " << timestamp);
+        m_updateQueue.push_back(std::move(message));
+        Simulator::ScheduleNow(&Gateway::HandleInitialize, this);
+        GrantTime(Max(Simulator::Now(), lookahead));
+        step.timing.timestamp = Simulator::Now();
+    }
+    else // normal message
+    {
+        NS_LOG_LOGIC("...update received for " << timestamp);
+
+        // the server must not send a timestamp earlier than the time it already granted
+        Time timeUpdate = timestamp - m_timeStart;
+        if (timeUpdate < m_timePause)
+        {
+            NS_FATAL_ERROR("ERROR: received timestamps were not increasing values (or were within the lookahead)");
+        }
+        m_updateQueue.push_back(std::move(message));
+        Simulator::Schedule(timeUpdate - Simulator::Now(), &Gateway::HandleUpdate, this);
+
+        NS_LOG_INFO("advancing time from " << Simulator::Now() << " to " << timeUpdate + lookahead);
+        GrantTime(timeUpdate + lookahead);
+        step.timing.timestamp = timeUpdate;
+    }
+
+    if (step.measured)
+    {
+        step.granted = std::chrono::steady_clock::now();
+        step.timing.parse = NanoSeconds(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            step.granted - start).count());
+    }
+    m_stepQueue.push_back(step);
+    return true;
+}
+
+void
+Gateway::HandleInitialize()
+{
+    NS_LOG_FUNCTION(this);
+
+    GatewayMessage message = std::move(m_updateQueue.front());
+    m_updateQueue.pop_front();
+
+    m_sequence = 0;
+    if (m_pacingSpeed > 0) // align the wall clock with the first message
+    {
+        m_pacingOrigin = Simulator::Now();
+        m_pacingStart = std::chrono::steady_clock::now();
+        m_pacedTime = m_pacingOrigin;
+    }
+    ExecuteStep(&Gateway::DoInitialize, message);
+    m_updatePool.push_back(std::move(message));
+}
+
+void
+Gateway::HandleUpdate()
+{
+    NS_LOG_FUNCTION(this);
+
+    GatewayMessage message = std::move(m_updateQueue.front());
+    m_updateQueue.pop_front();
+
+    m_sequence++;
+    if (m_pacingSpeed > 0)
+    {
+        PaceToNow(); // the update time is a deadline
+    }
+    ExecuteStep(&Gateway::DoUpdate, message);
+    m_updatePool.push_back(std::move(message));
+}
+
+bool
+Gateway::IsTimingEnabled() const
+{
+    return m_timingHistograms || !m_stepTrace.IsEmpty();
+}
+
+void
+Gateway::ExecuteStep(void (Gateway::*update)(const GatewayMessage &), const GatewayMessage & message)
+{
+    PendingStep step = m_stepQueue.front();
+    m_stepQueue.pop_front();
+
+    if (!step.measured)
+    {
+        (this->*update)(message);
+        return;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    m_responseDuration = std::chrono::steady_clock::duration(0);
+    m_timingResponse = true;
+    (this->*update)(message);
+    m_timingResponse = false;
+    std::chrono::steady_clock::duration updateDuration = std::chrono::steady_clock::now() - start;
+
+    step.timing.events = NanoSeconds(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        start - step.granted).count());
+    step.timing.update = NanoSeconds(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        updateDuration - m_responseDuration).count());
+    step.timing.response = NanoSeconds(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        m_responseDuration).count());
+
+    if (m_timingHistograms)
+    {
+        m_histograms[TIMING_STAGE::SERVER_WAIT].Record(step.timing.serverWait);
+        m_histograms[TIMING_STAGE::QUEUE].Record(step.timing.queue);
+        m_histograms[TIMING_STAGE::PARSE].Record(step.timing.parse);
+        m_histograms[TIMING_STAGE::EVENTS].Record(step.timing.events);
+        m_histograms[TIMING_STAGE::UPDATE].Record(step.timing.update);
+        m_histograms[TIMING_STAGE::RESPONSE].Record(step.timing.response);
+    }
+    m_stepTrace(step.timing);
+}
+
+bool
+Gateway::DoStage(const GatewayMessage & /* receivedData */)
+{
+    return true; // nothing to stage
+}
+
+void
+Gateway::DoInitialize(const GatewayMessage & receivedData)
+{
+    DoInitialize(receivedData.ToVector());
+}
+
+void
+Gateway::DoUpdate(const GatewayMessage & receivedData)
+{
+    DoUpdate(receivedData.ToVector());
+}
+
+void
+Gateway::DoInitialize(const std::vector<std::string> & receivedData)
+{
+    NS_FATAL_ERROR("ERROR: a class derived from Gateway must implement DoInitialize");
+}
+
+void
+Gateway::DoUpdate(const std::vector<std::string> & receivedData)
+{
+    NS_FATAL_ERROR("ERROR: a class derived from Gateway must implement DoUpdate");
 }
 
 } // namespace ns3
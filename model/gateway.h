@@ -35,31 +35,140 @@
 #ifndef GATEWAY_H
 #define GATEWAY_H
 
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
-#include <queue>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 #include "ns3/core-module.h"
 
+#include "binary-codec.h"
+#include "gateway-message.h"
+#include "gateway-reactor.h"
+#include "gateway-recorder.h"
+#include "gateway-transport.h"
+#include "latency-histogram.h"
+#include "receive-buffer.h"
+#include "spsc-queue.h"
+
 namespace ns3
 {
 
+class GatewayCoordinator;
+
 /**
- * An abstract base class that maintains a socket connection with a server to exchange data during simulation runtime.
- * The pure virtual Gateway::DoInitialize and Gateway::DoUpdate functions must be implemented in a derived class to
+ * An abstract base class that maintains a connection with a server to exchange data during simulation runtime.
+ * The virtual Gateway::DoInitialize and Gateway::DoUpdate functions must be implemented in a derived class to
  * specify how data received from the server is processed. The purpose of this class is to handle time management,
  * turning the ns-3 simulator into a discrete-time simulation that operates in lock-step with the server.
  *
- * All packets, sent and received, are strings with the format "v1_v2_.._vn|", where:
+ * With the default TEXT framing, all packets, sent and received, are strings with the format "v1_v2_.._vn|", where:
  *  1) _ is a user-specified delimiter that separates elements within the message (see the constructor)
  *  2) | is a user-specified delimiter that indicates the end of the message (see the constructor)
  *  3) v1 .. vn are string elements that contain any value excluding the delimiters from 1 and 2
+ *
+ * With the BINARY framing, all packets have a fixed size header (containing the timestamp and the payload size)
+ * followed by typed little-endian fields. Refer to BinaryEncoder for the format, and to BinaryDecoder for reading
+ * the received fields.
+ *
+ * The gateway measures the wall clock time spent in each stage of a step, and publishes it with the "Step" trace
+ * source (see Gateway::StepTiming) and optional histograms (see Gateway::SetTimingHistograms).
  */
-class Gateway
+class Gateway : public ObjectBase
 {
     public:
+        enum IDLE_MODE  // how the main thread waits while ns-3 time progression is paused
+        {
+            SPIN,       // Gateway::WaitForNextUpdate reschedules itself to execute now (default)
+            BLOCK       // Gateway::WaitForNextUpdate blocks the main thread until a message is received
+        };
+
+        enum FRAMING    // the format of the messages exchanged with the server
+        {
+            TEXT,       // delimiter-separated strings (default)
+            BINARY      // a length-prefixed header followed by typed fields (see BinaryEncoder)
+        };
+
+        enum RESPONSE_MODE  // which values Gateway::SendResponse sends to the server
+        {
+            FULL,       // every value (default)
+            DELTA       // only the values that changed since the previous response, with periodic keyframes
+        };
+
+        enum TIMING_STAGE   // the stages of a step measured by Gateway::StepTiming
+        {
+            SERVER_WAIT,    // waiting for the server after ns-3 paused
+            QUEUE,          // waiting for the main thread to process the received message
+            PARSE,          // splitting the message and scheduling its update
+            EVENTS,         // executing ns-3 events until the update
+            UPDATE,         // executing Gateway::DoUpdate (excluding Gateway::SendResponse)
+            RESPONSE,       // executing Gateway::SendResponse during Gateway::DoUpdate
+            TIMING_STAGE_COUNT
+        };
+
+        struct StepTiming   // the wall clock time spent in each stage of one step (one received message)
+        {
+            Time timestamp;     //!< The simulation time of the step
+            Time serverWait;    //!< From ns-3 pausing at the granted time until the message was received (0 if the
+                                //!< message was received before ns-3 paused)
+            Time queue;         //!< From receiving the message until the main thread began processing it
+            Time parse;         //!< Splitting the message, and scheduling its update
+            Time events;        //!< Executing ns-3 events from the time grant until the update for this step
+            Time update;        //!< Executing Gateway::DoUpdate (or DoInitialize), excluding Gateway::SendResponse
+            Time response;      //!< Executing Gateway::SendResponse during Gateway::DoUpdate
+        };
+
+        /**
+         * @brief TracedCallback signature for the timing of each step.
+         * @param timing the time spent in each stage of the step
+         */
+        typedef void (*StepTracedCallback)(const StepTiming & timing);
+
+        struct PacingTiming // the wall clock pacing of one deadline (see Gateway::SetPacing)
+        {
+            Time timestamp;     //!< The simulation time of the deadline
+            Time slack;         //!< The wall clock time left until the deadline when ns-3 reached it (negative if the
+                                //!< deadline was missed)
+            Time jitter;        //!< How late the timed wait woke up after the deadline (0 if the deadline was missed)
+        };
+
+        /**
+         * @brief TracedCallback signature for the pacing of each deadline.
+         * @param timing the slack and jitter of the deadline
+         */
+        typedef void (*PacingTracedCallback)(const PacingTiming & timing);
+
+        struct PacingStatistics // counters for the deadlines paced by Gateway::SetPacing
+        {
+            uint64_t deadlines;     //!< The number of deadlines reached
+            uint64_t misses;        //!< The number of deadlines reached after their wall clock time
+            Time minSlack;          //!< The smallest slack (the latest miss, if negative)
+            Time meanJitter;        //!< Mean time that the timed waits woke up after their deadlines
+            Time maxJitter;         //!< Maximum time that a timed wait woke up after its deadline
+        };
+
+        struct SendStatistics   // counters for the responses sent by Gateway::SendResponse
+        {
+            uint64_t queuedBytes;   //!< Bytes of responses waiting for the writer thread (see Gateway::SetAsyncSend)
+            uint64_t sentResponses; //!< The number of responses passed to the transport
+            uint64_t sentBytes;     //!< The number of bytes passed to the transport
+            Time meanLatency;       //!< Mean time from Gateway::SendResponse until the transport accepted a response
+            Time maxLatency;        //!< Maximum time from Gateway::SendResponse until the transport accepted a response
+        };
+
+        /**
+         * @brief Get the type ID.
+         * @return the object TypeId
+         */
+        static TypeId GetTypeId();
+
         /**
          * @brief Construct a new gateway instance.
          *
@@ -74,6 +183,18 @@ class Gateway
         Gateway(uint32_t dataSize,
                 const std::string & delimiterField = " ",
                 const std::string & delimiterMessage = "\r\n");
+
+        /**
+         * @brief Construct a new gateway instance with the specified message framing.
+         *
+         * With the BINARY framing, each field of the data received by Gateway::DoInitialize and Gateway::DoUpdate
+         * contains one encoded field that can be read using BinaryDecoder, and each value set by Gateway::SetValue
+         * is sent as a field of the matching type (a string as a BYTES field).
+         *
+         * @param dataSize the number of elements the gateway sends to its server
+         * @param framing the format of the messages exchanged with the server
+         */
+        Gateway(uint32_t dataSize, FRAMING framing);
         
         /**
          * @brief Connects the gateway to the server specified as arguments.
@@ -84,31 +205,339 @@ class Gateway
          * the server once, so the remote server must be running before calling this function.
          *
          * Side Effects:
-         *  1) this function will create a UDP socket connected to the remote server.
+         *  1) this function will create a TCP socket connected to the remote server (see TcpTransport).
          *  2) this function will create a second thread to handle messages received from the remote server.
          *
          * Exceptions:
          *  1) this function can only be called once; a second call will cause a fatal error.
          *  2) an invalid or unresolved address will cause a fatal error. 
          *
-         * @param serverAddress the IPv4 or IPv6 address of the remote server
+         * @param serverAddress the host name, IPv4 address, or IPv6 address of the remote server
          * @param serverPort the port number of the remote server
          */
         void Connect(const std::string & serverAddress, uint16_t serverPort);
 
+        /**
+         * @brief Connects the gateway to a server using a connected transport.
+         *
+         * This function behaves like the TCP/IP overload, except that the transport is selected by the caller. For a
+         * server running on the same host, a UnixTransport avoids the TCP/IP stack, and a SharedMemoryTransport avoids
+         * socket system calls entirely. Both the TEXT and the BINARY framing can be used with any transport.
+         *
+         * Exceptions:
+         *  1) this function can only be called once; a second call will cause a fatal error.
+         *
+         * @param transport the transport, which the gateway closes when it stops
+         */
+        void Connect(Ptr<GatewayTransport> transport);
+
+        /**
+         * @brief Set how the main simulator thread waits while time progression is paused.
+         *
+         * In the SPIN mode, the paused simulator continuously executes events scheduled for the current time, which
+         * occupies one processor core while the server computes its next step. In the BLOCK mode, the main thread is
+         * suspended on a condition variable once every other event scheduled for the current time has executed, and
+         * it resumes as soon as the gateway thread receives the next message. The simulation results are identical
+         * for both modes.
+         *
+         * The main thread is blocked on a wakeup shared by every gateway in the process, so with several independent
+         * gateways, a message received by any of them wakes the main thread. A gateway added to a GatewayCoordinator
+         * uses the idle mode of the coordinator instead.
+         *
+         * Exceptions:
+         *  1) this function must be called before Gateway::Connect.
+         *
+         * @param mode the idle mode to use (default: SPIN)
+         */
+        void SetIdleMode(IDLE_MODE mode);
+
+        /**
+         * @brief Receive messages with the threads of a shared reactor, instead of a dedicated gateway thread.
+         *
+         * By default, each gateway creates a thread that blocks until its transport receives data. With many gateways
+         * in one process (for example, one for each federate of a co-simulation), a shared reactor waits for every
+         * transport with a few threads (see GatewayReactor::GetInstance for the process-wide reactor). The reactor
+         * thread splits the received data into messages and passes them to the main thread, exactly like the gateway
+         * thread. Only transports with a descriptor (TcpTransport and UnixTransport) can use a reactor; a gateway with
+         * another transport, or on a platform without epoll, creates its own thread with a warning.
+         *
+         * Exceptions:
+         *  1) this function must be called before Gateway::Connect.
+         *
+         * @param reactor the reactor, or a null pointer for a dedicated gateway thread (default: null)
+         */
+        void SetReactor(Ptr<GatewayReactor> reactor);
+
+        /**
+         * @brief Set the maximum number of bytes requested from the transport by one receive call.
+         *
+         * Received data is stored in a ring buffer that grows as needed to hold the largest message, so this value
+         * does not limit the message size. Larger values reduce the number of receive calls for large messages.
+         *
+         * Exceptions:
+         *  1) this function must be called before Gateway::Connect.
+         *  2) the size must be greater than 0.
+         *
+         * @param size the receive size in bytes (default: 65536)
+         */
+        void SetReceiveSize(uint32_t size);
+
+        /**
+         * @brief Parse received messages on the thread that receives them, instead of on the main ns-3 thread.
+         *
+         * Splitting each message into fields and reading its timestamp and lookahead then overlaps with the execution
+         * of ns-3 events, and the main thread only schedules the parsed message. The receiving thread also calls
+         * Gateway::DoStage for each message (other than the terminate message), which a derived class can use to
+         * decode the fields before the message is processed (see StagedGateway). Simulation results are unchanged.
+         *
+         * Exceptions:
+         *  1) this function must be called before Gateway::Connect.
+         *
+         * @param enabled true if messages are parsed by the receiving thread (default: false)
+         */
+        void SetReadThreadParsing(bool enabled);
+
+        /**
+         * @brief Send responses from a dedicated writer thread instead of the main thread.
+         *
+         * By default, Gateway::SendResponse blocks the main thread until the transport accepts the response, which
+         * stalls event processing while the server is not reading. When enabled, Gateway::SendResponse passes the
+         * response to a writer thread and returns immediately. Responses are sent in order, and Gateway::Stop waits up
+         * to 1 second for the queued responses to be sent before the transport is closed. If the writer thread falls
+         * behind by 1024 responses, Gateway::SendResponse waits for it, unless the connection closed (the response is
+         * then dropped).
+         *
+         * Exceptions:
+         *  1) this function must be called before Gateway::Connect.
+         *
+         * @param enabled true to send responses from a writer thread (default: false)
+         */
+        void SetAsyncSend(bool enabled);
+
+        /**
+         * @brief Get the counters for the responses sent by Gateway::SendResponse (see Gateway::SetAsyncSend).
+         * @return the current counter values
+         */
+        SendStatistics GetSendStatistics() const;
+
+        /**
+         * @brief Record every message received from the server, and optionally every response, to a file.
+         *
+         * Each message is recorded by the gateway thread as it was received (including its framing), with its receive
+         * time relative to Gateway::Connect. Each response is recorded when it is passed to the transport. A recording
+         * can be replayed without the server using a ReplayTransport, and the recorded responses can be compared with
+         * the responses of the replay. Refer to GatewayRecorder for the file format.
+         *
+         * Exceptions:
+         *  1) this function must be called before Gateway::Connect.
+         *  2) failing to create a file will cause a fatal error during Gateway::Connect.
+         *
+         * @param messagePath the file system path of the received message recording
+         * @param responsePath the file system path of the response recording, or empty to not record responses
+         */
+        void SetRecordFile(const std::string & messagePath, const std::string & responsePath = "");
+
+        /**
+         * @brief Record the time spent in each stage of every step in a histogram (see Gateway::StepTiming).
+         *
+         * The stages are only timed while this is enabled or the "Step" trace source is connected. Otherwise, the
+         * gateway only reads the clock once for each received message.
+         *
+         * @param enabled true to record the histograms (default: false)
+         */
+        void SetTimingHistograms(bool enabled);
+
+        /**
+         * @brief Get the histogram of the time spent in one stage (see Gateway::SetTimingHistograms).
+         * @param stage the stage
+         * @return the histogram, which is empty unless histograms are enabled
+         */
+        const LatencyHistogram & GetTimingHistogram(TIMING_STAGE stage) const;
+
+        /**
+         * @brief Output the histogram of each stage, one stage per line (see Gateway::SetTimingHistograms).
+         * @param os the output stream
+         */
+        void PrintTimingSummary(std::ostream & os) const;
+
+        /**
+         * @brief Advance ns-3 no faster than wall clock time (for example, with hardware in the loop).
+         *
+         * The simulation time of the first received message is aligned with the wall clock time at which it is
+         * processed. Each later update, and each time at which ns-3 pauses at its granted time, is then a deadline:
+         * the main thread sleeps (without spinning) until the wall clock time corresponding to the simulation time
+         * before continuing. Events between deadlines execute as fast as possible. A deadline that is reached after
+         * its wall clock time is a miss, and ns-3 continues without waiting (it does not skip ahead). The slack and
+         * wake-up jitter of each deadline are published with the "Pacing" trace source (see Gateway::PacingTiming),
+         * and summarized by Gateway::GetPacingStatistics. The pacing replaces RealtimeSimulatorImpl, which cannot be
+         * used with a gateway. With a GatewayCoordinator, only the updates are paced.
+         *
+         * Exceptions:
+         *  1) this function must be called before Gateway::Connect.
+         *  2) the speed must not be negative.
+         *
+         * @param speed the simulation seconds per wall clock second, or 0 to not pace (default: 0)
+         */
+        void SetPacing(double speed);
+
+        /**
+         * @brief Get the counters for the deadlines paced by Gateway::SetPacing (main thread only).
+         * @return the current counter values
+         */
+        PacingStatistics GetPacingStatistics() const;
+
+        // inherited from ObjectBase
+        TypeId GetInstanceTypeId() const override;
+
+        /**
+         * @brief Set a constant lookahead granted by the server with every message.
+         *
+         * By default, ns-3 pauses at the timestamp of each received message until the next message is received. With
+         * a lookahead L, the server promises that the timestamp of its next message will be at least T + L, where T is
+         * the timestamp of its current message. ns-3 then continues to execute events up to T + L while the server
+         * computes its next step, and only pauses at T + L if the next message has not been received. The received
+         * message is still processed at T, and only the processing of the next message waits for its data. Simulation
+         * results do not depend on when the next message is received.
+         *
+         * Exceptions:
+         *  1) this function must be called before Gateway::Connect.
+         *  2) the lookahead must not be negative.
+         *  3) after Gateway::Connect, a received timestamp earlier than the previously granted time is a fatal error.
+         *
+         * @param lookahead the time that ns-3 may advance beyond each received timestamp (default: 0)
+         */
+        void SetLookahead(Time lookahead);
+
+        /**
+         * @brief Read the lookahead from each received message, instead of using a constant lookahead.
+         *
+         * With the TEXT framing, the lookahead is the third element of the message header (after the timestamp) as an
+         * integer number of nanoseconds. With the BINARY framing, the lookahead is the first field of the payload as an
+         * INT64 number of nanoseconds. In both cases, the lookahead is removed before the message is processed. The
+         * terminate message does not need to include a lookahead. Refer to Gateway::SetLookahead for its meaning.
+         *
+         * Exceptions:
+         *  1) this function must be called before Gateway::Connect.
+         *  2) after Gateway::Connect, a received message without a valid lookahead is a fatal error.
+         *
+         * @param enabled true if each received message includes a lookahead (default: false)
+         */
+        void SetLookaheadHeader(bool enabled);
+
+        /**
+         * @brief Set which values Gateway::SendResponse sends to the server.
+         *
+         * In the DELTA mode, the first value of each response is a marker. A keyframe has the marker "K" followed by
+         * every value, as in the FULL mode. A delta has the marker "D" followed by an (index, value) pair for each
+         * value that changed since the previous response, in the order in which the values were first changed. The
+         * first response, and every keyframeInterval-th response after it, is a keyframe, so that a server can
+         * resynchronize. With the BINARY framing, the marker is a BYTES field and each index is an INT32 field. Refer
+         * to GatewayServer::ReceiveValues to decode responses on the server.
+         *
+         * Exceptions:
+         *  1) this function must be called before Gateway::Connect.
+         *  2) keyframeInterval must be greater than 0.
+         *
+         * @param mode the response mode (default: FULL)
+         * @param keyframeInterval the number of responses between keyframes in the DELTA mode (default: 100)
+         */
+        void SetResponseMode(RESPONSE_MODE mode, uint32_t keyframeInterval = 100);
+
+        /**
+         * @brief Begin each response with the timestamp and sequence number of the step it belongs to.
+         *
+         * The sequence number is the index of the received message most recently processed by Gateway::DoInitialize
+         * (0) or Gateway::DoUpdate (1, 2, ...), so a server that sends several messages before reading their responses
+         * can match each response to its message. With the TEXT framing, the response begins with three integer values:
+         * the (seconds, nanoseconds) server time of the current simulation time, in the same format as a received
+         * timestamp, and the sequence number. With the BINARY framing, the message header already contains the server
+         * time, and the sequence number is the first field of the payload as an INT64. The header precedes the next
+         * event time (see Gateway::SetNextEventReport) and the DELTA marker. Refer to GatewayServer::ReceiveValues to
+         * decode it.
+         *
+         * Exceptions:
+         *  1) this function must be called before Gateway::Connect.
+         *
+         * @param enabled true if each response begins with the response header (default: false)
+         */
+        void SetResponseHeader(bool enabled);
+
+        /**
+         * @brief Report the time of the next watched event to the server with each response.
+         *
+         * Each response then begins with the server time of the earliest pending event passed to Gateway::WatchEvent,
+         * or -1 if no watched event is pending. With the TEXT framing, the time is the first value of the response as
+         * an integer number of nanoseconds. With the BINARY framing, the time is the first field of the payload as an
+         * INT64 number of nanoseconds. The time follows the response header (see Gateway::SetResponseHeader), and
+         * precedes the keyframe or delta marker of the DELTA response mode.
+         *
+         * A server whose own state does not change between steps can send its next message at the reported time
+         * instead of at a fixed step size, skipping steps in which ns-3 has nothing to process (as with a Next Event
+         * Request in HLA). The report only covers watched events, so events scheduled later (for example, by the next
+         * update) can be earlier than a reported time. Refer to GatewayServer::GetNextEventTime to decode it.
+         *
+         * Exceptions:
+         *  1) this function must be called before Gateway::Connect.
+         *
+         * @param enabled true if each response includes the time of the next watched event (default: false)
+         */
+        void SetNextEventReport(bool enabled);
+
+        /**
+         * @brief Include an event in the next event time reported to the server (see Gateway::SetNextEventReport).
+         *
+         * The event is forgotten once it executes or is cancelled. Periodic events must be watched each time they are
+         * rescheduled.
+         *
+         * @param event a scheduled event that the server should not skip past
+         */
+        void WatchEvent(const EventId & event);
+
         /**
          * @brief Set the value of one element to be sent to the server.
          *
          * This function only buffers data and does not send anything to the server (see Gateway::SendResponse).
          *
+         * In the DELTA response mode, setting an element to its current value does not mark it as changed.
+         *
          * Exceptions:
          *  1) the index must be less than the dataSize specified in the constructor.
-         *  2) the value must not contain either delimiter specified in the constructor.
+         *  2) the value must not contain either delimiter specified in the constructor (TEXT framing only).
          *
          * @param index the index of the element to update
          * @param value the new value to assign to the element
          */
         void SetValue(uint32_t index, const std::string & value);
+        void SetValue(uint32_t index, const char * value);
+
+        /**
+         * @brief Set the value of one element to a number, formatted without allocating memory.
+         *
+         * Integers are formatted in decimal, and bool values as 1 or 0. Floating point values are formatted with the
+         * precision set by Gateway::SetPrecision. The delimiters are only checked if they contain a character that can
+         * appear in a formatted number.
+         *
+         * With the BINARY framing, the number is not formatted: bool values and integers that fit in an int32 are sent
+         * as an INT32 field, other integers as an INT64 field (an unsigned 64-bit value above the int64 maximum wraps
+         * around), and floating point values as a DOUBLE field, which ignores the precision.
+         *
+         * Exceptions:
+         *  1) the index must be less than the dataSize specified in the constructor.
+         *
+         * @param index the index of the element to update
+         * @param value the new value to assign to the element
+         */
+        template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+        void SetValue(uint32_t index, T value);
+        void SetValue(uint32_t index, double value);
+
+        /**
+         * @brief Set the precision of floating point values set with Gateway::SetValue.
+         *
+         * @param precision the number of significant digits, or 0 for the shortest representation that converts back
+         *                  to the same value (default: 0)
+         */
+        void SetPrecision(uint32_t precision);
 
         /**
          * @brief Send the buffered data values to the server.
@@ -119,7 +548,8 @@ class Gateway
          * assigned a value, the default value is the empty string.
          *
          * The sent message will be a string where the values are separated by the field delimiter specified in the
-         * constructor, postpended with the message delimiter specified in the constructor. 
+         * constructor, postpended with the message delimiter specified in the constructor. With the BINARY framing,
+         * the sent message header contains the server time corresponding to the current ns-3 simulation time.
          *
          * If there is a send error, a warning will be output (this is not considered an exception).
          *
@@ -127,7 +557,28 @@ class Gateway
          *  1) the function is called when the gateway is in a state other than CONNECTED.
          */
         void SendResponse();
+    protected:
+        /**
+         * @brief Receive again after the main thread released space that the receiving thread was waiting for.
+         *
+         * A reactor thread does not wait for space in a full queue: it stops receiving from the transport until this
+         * function is called. Gateway::ForwardUp calls it after draining m_messageQueue, and a derived class whose
+         * Gateway::DoStage returned false calls it once it released staging space (main thread only).
+         */
+        void ResumeReceiving();
     private:
+        friend class GatewayCoordinator;
+
+        struct ReceivedMessage  // a message passed from the read thread to the main thread
+        {
+            std::string data;                               //!< The message content, if it was not parsed
+            GatewayMessage message;                         //!< The parsed message, excluding its header
+            Time timestamp;                                 //!< The parsed timestamp
+            Time lookahead;                                 //!< The parsed (or constant) lookahead
+            bool parsed;                                    //!< True if the read thread parsed the message
+            std::chrono::steady_clock::time_point time;     //!< When the message was received
+        };
+
         enum STATE      // the gateway internal state
         {
             CREATED,    // constructed
@@ -140,7 +591,7 @@ class Gateway
          *
          * Side Effects:
          *  1) a signal is sent for the thread to exit, and the thread is joined.
-         *  2) if the client socket is connected to a server, the socket is closed.
+         *  2) if the transport is connected to a server, the transport is closed.
          *  3) the gateway will no longer affect/prevent the Simulator time progression.
          *
          * This function is safe to call any number of times, and in any context within the main Simulator thread.
@@ -148,85 +599,481 @@ class Gateway
         void Stop();
 
         /**
-         * @brief Read data from the socket until the connection closes.
+         * @brief Handle the transport connection closing, which is scheduled by the gateway thread.
          *
-         * This function executes until either the socket terminates or Gateway::Stop is called from the main thread.
-         * If the socket terminates, Gateway::Stop is scheduled before the function returns. When data is received from
-         * the socket, Gateway::ForwardUp is scheduled to process the data.
+         * Gateway::Stop is called unless the terminate message was received, in which case the simulator is already
+         * going to stop once the updates received before the terminate message have executed.
+         */
+        void HandleClose();
+
+        /**
+         * @brief Send responses from m_sendQueue until Gateway::Stop is called and the queue is empty.
+         */
+        void RunWriterThread();
+
+        /**
+         * @brief Pass one response to the transport, and update the send counters.
+         *
+         * @param response the response to send
+         * @param queued the time at which Gateway::SendResponse created the response
+         */
+        void TransmitResponse(const std::string & response, std::chrono::steady_clock::time_point queued);
+
+        /**
+         * @brief Read data from the transport until the connection closes.
+         *
+         * This function executes until either the transport terminates or Gateway::Stop is called from the main
+         * thread. If the transport terminates, Gateway::HandleClose is scheduled before the function returns. When a
+         * message is received from the transport, it is added to m_messageQueue. Gateway::ForwardUp is only scheduled
+         * to process the queue if it is not already scheduled, and the thread waits for the main thread if the queue
+         * is full.
          */
         void RunThread();
 
+        /**
+         * @brief Receive data from the transport, when called by the reactor because data is available.
+         * @return false to remove the transport from the reactor
+         */
+        bool HandleReadable();
+
+        /**
+         * @brief Process the result of one receive call.
+         *
+         * Received data is passed to Gateway::ForwardReceived. If the connection closed or failed,
+         * Gateway::HandleClose is scheduled and the main thread is woken.
+         *
+         * @param bytesReceived the result of GatewayTransport::Receive
+         * @return false if no more data should be received
+         */
+        bool HandleReceived(ssize_t bytesReceived);
+
+        /**
+         * @brief Add each complete message in m_receiveBuffer to m_messageQueue.
+         *
+         * Gateway::ForwardUp is only scheduled to process the queue if it is not already scheduled. If the queue is
+         * full (or Gateway::DoStage cannot stage a message), the gateway thread waits for the main thread, while a
+         * reactor thread keeps the message in m_receivedMessage, pauses the transport in the reactor, and returns
+         * (see Gateway::ResumeReceiving).
+         *
+         * @return false if the gateway is stopping
+         */
+        bool ForwardReceived();
+
+        /**
+         * @brief Find the end of the first complete message in m_receiveBuffer.
+         *
+         * For the TEXT framing, the search resumes from the end of the data searched by the previous call.
+         *
+         * @param messageSize the size of the message (excluding the message delimiter for the TEXT framing)
+         * @param trailerSize the size of the message delimiter following the message (0 for the BINARY framing)
+         * @return true if m_receiveBuffer contains at least one complete message
+         */
+        bool FindMessage(size_t & messageSize, size_t & trailerSize);
+
+        /**
+         * @brief Split a received message into fields, and remove its timestamp header.
+         *
+         * @param message the received message
+         * @param timestamp the received timestamp
+         * @return true if the message is valid
+         */
+        bool ParseTextMessage(GatewayMessage & message, Time & timestamp) const;
+        bool ParseBinaryMessage(GatewayMessage & message, Time & timestamp) const;
+
+        /**
+         * @brief Remove the lookahead from the front of a received message (see Gateway::SetLookaheadHeader).
+         *
+         * @param message the received message, excluding its timestamp header
+         * @param lookahead the received lookahead
+         * @return true if the message began with a valid lookahead
+         */
+        bool ParseLookahead(GatewayMessage & message, Time & lookahead) const;
+
+        /**
+         * @brief Split a received message into fields, and remove its timestamp header and lookahead.
+         *
+         * The lookahead is only read if the timestamp is not negative (the terminate message does not include one).
+         *
+         * Exceptions:
+         *  1) the message must begin with a valid timestamp header.
+         *  2) the message must include a valid lookahead, if enabled by Gateway::SetLookaheadHeader.
+         *
+         * @param message the received message
+         * @param timestamp the received timestamp
+         * @param lookahead the received lookahead, or the constant lookahead (see Gateway::SetLookahead)
+         */
+        void ParseMessage(GatewayMessage & message, Time & timestamp, Time & lookahead) const;
+
+        /**
+         * @brief Find the earliest pending event passed to Gateway::WatchEvent, and forget expired events.
+         *
+         * @return the server time of the event in nanoseconds, or -1 if no watched event is pending
+         */
+        int64_t GetNextEventTime();
+
+        /**
+         * @brief Assign a string value to one element, which is sent as a BYTES field with the BINARY framing.
+         *
+         * Exceptions:
+         *  1) the index must be less than the dataSize specified in the constructor.
+         *
+         * @param index the index of the element to update
+         * @param value the first character of the value
+         * @param size the number of characters in the value
+         * @param checkDelimiters true if the value must be checked for the TEXT framing delimiters
+         */
+        void SetFormattedValue(uint32_t index, const char * value, size_t size, bool checkDelimiters);
+
+        /**
+         * @brief Assign the value of one element as it is sent, and track the change for the DELTA response mode.
+         *
+         * Exceptions:
+         *  1) the index must be less than the dataSize specified in the constructor.
+         *
+         * @param index the index of the element to update
+         * @param value the first character of the value (an encoded field with the BINARY framing)
+         * @param size the number of characters in the value
+         */
+        void SetFieldValue(uint32_t index, const char * value, size_t size);
+
+        /**
+         * @brief Allow ns-3 time to advance up to a time, where it pauses until the next message is received.
+         *
+         * The pending Gateway::WaitForNextUpdate event is moved to the granted time.
+         *
+         * @param timeGrant the granted simulation time, which must not be in the past
+         */
+        void GrantTime(Time timeGrant);
+
+        /**
+         * @brief Sleep until the wall clock time corresponding to the current simulation time (see Gateway::SetPacing).
+         *
+         * Each simulation time is only paced once, so this can be called repeatedly while ns-3 is paused.
+         */
+        void PaceToNow();
+
         /**
          * @brief Pause the simulation by scheduling events to execute now until cancelled.
          *
          * This function schedules itself to execute immediately forever. Interrupt it by cancelling m_eventWait.
+         * In the BLOCK idle mode, it first blocks the main thread until the gateway thread has a message to forward.
          */
         void WaitForNextUpdate();
 
+        /**
+         * @brief Block the main thread until any gateway schedules Gateway::ForwardUp or this gateway's thread exits.
+         *
+         * This only blocks if no other event was executed since the previous call, which guarantees that every event
+         * already scheduled for the current time has been processed before the main thread is suspended. The wait
+         * events of other gateways paused at the same time do not count, so they do not keep the main thread spinning.
+         */
+        void BlockUntilReceive();
+
+        /**
+         * @brief Count a wait event in the BLOCK idle mode, and check if only wait events executed since the previous
+         *        one of the same caller.
+         *
+         * The wait events of every gateway and coordinator in the BLOCK idle mode are counted together, so several of
+         * them paused at the same time can block the main thread instead of executing each other's wait events.
+         *
+         * @param eventCount the simulator event count at the caller's previous wait event (updated)
+         * @param waitEventCount the wait event count at the caller's previous wait event (updated)
+         * @return true if every event at the current time has been processed, so the main thread can block
+         */
+        static bool IsOnlyWaiting(uint64_t & eventCount, uint64_t & waitEventCount);
+
+        /**
+         * @brief Block the main thread until any connected gateway has a message or a closed connection to process.
+         *
+         * Every gateway wakes the main thread through the same condition variable (see Gateway::WakeMainThread), so
+         * one blocked main thread is woken by the gateway that receives the next message, whichever it is.
+         *
+         * @param gateway a gateway whose exited thread also ends the wait, or null
+         */
+        static void WaitForAnyReceive(const Gateway * gateway);
+
+        /**
+         * @brief Check if any connected gateway has a message or a closed connection to process.
+         *
+         * The caller must hold the shared wait mutex.
+         *
+         * @return true if Gateway::ForwardUp or Gateway::HandleClose is pending for any connected gateway
+         */
+        static bool IsAnyReceived();
+
+        /**
+         * @brief Wake the main thread if it is blocked in Gateway::WaitForAnyReceive (called by the receiving thread).
+         */
+        void WakeMainThread();
+
+        /**
+         * @brief Add or remove this gateway from the gateways checked by Gateway::IsAnyReceived.
+         * @param waking true to add the gateway, or false to remove it
+         */
+        void SetWaking(bool waking);
+
+        /**
+         * @brief Process every message in m_messageQueue.
+         *
+         * Messages are processed in order using Gateway::ForwardMessage, until either the queue is empty or the
+         * terminate message is processed.
+         */
+        void ForwardUp();
+
         /**
          * @brief Processes one received message.
          *
          * Dependent on the message timestamp, the following outcomes are possible:
-         *  1) if the received timestamp is negative, Simulator::Stop is called (and the message it not processed).
+         *  1) if the received timestamp is negative, Simulator::Stop is scheduled for the last granted time (and the
+         *     message it not processed).
          *  2) if this is the first message, Gateway::DoInitialize is scheduled to execute now.
          *  3) otherwise, Gateway::HandleUpdate is scheduled for the received timestamp.
+         * In cases 2 and 3, time is then granted up to the received timestamp plus the lookahead (see GrantTime).
          *
-         * The timestamp is removed from the message before scheduling Gateway::DoInitialize and Gateway::HandleUpdate.
+         * The timestamp is removed from the message before scheduling Gateway::HandleInitialize or
+         * Gateway::HandleUpdate, and the message is added to m_updateQueue for that function to process.
          *
          * Exceptions:
-         *  1) m_messageQueue must contain at least one element.
-         *  2) the message must begin with two integers that represent a (seconds, nanoseconds) timestamp.
-         *  3) the received timestamps must be increasing between consecutive calls.
+         *  1) the message must begin with two integers that represent a (seconds, nanoseconds) timestamp.
+         *  2) the received timestamps must be increasing between consecutive calls, and must not be earlier than the
+         *     previously granted time.
+         *
+         * @param received the received message (parsed unless Gateway::SetReadThreadParsing is disabled), which is
+         *                 swapped with buffers that can be re-used
+         * @return false if the message was the terminate message
          */
-        void ForwardUp();
+        bool ForwardMessage(ReceivedMessage & received);
+
+        /**
+         * @brief Handle processing the first received message prior to execution of the callback function.
+         *
+         * The message is the front element of m_updateQueue, which is returned to m_updatePool after processing.
+         */
+        void HandleInitialize();
 
         /**
          * @brief Handle processing a received message prior to execution of the callback functions.
          *
-         * This function is responsible for pausing simulation time if there are no messages pending in the queue.
+         * The message is the front element of m_updateQueue, which is returned to m_updatePool after processing.
+         */ 
+        void HandleUpdate();
+
+        /**
+         * @brief Callback on the thread that receives messages, to decode a message before it is processed.
+         *
+         * This is only called if Gateway::SetReadThreadParsing is enabled, once for each message other than the
+         * terminate message, in the order in which the messages are later processed by Gateway::DoInitialize and
+         * Gateway::DoUpdate. It executes concurrently with ns-3 events, so it must not access the simulation. The
+         * default implementation does nothing.
+         *
+         * A derived class that has no space to stage the message returns false, and this function is called again for
+         * the same message later: after a short wait on the gateway thread, or after the derived class calls
+         * Gateway::ResumeReceiving when a reactor receives the messages.
          *
          * @param receivedData the received message content excluding the header/timestamp
-         */ 
-        void HandleUpdate(const std::vector<std::string> & receivedData);
+         * @return false if the message cannot be staged yet
+         */
+        virtual bool DoStage(const GatewayMessage & receivedData);
 
         /**
          * @brief Callback to process the first message received from the server.
          *
+         * Derived classes must implement either this function or the std::vector<std::string> overload. The default
+         * implementation copies the fields and calls the std::vector<std::string> overload.
+         *
          * @param receivedData the received message content excluding the header/timestamp
-         */        
-        virtual void DoInitialize(const std::vector<std::string> & receivedData) = 0;
+         */
+        virtual void DoInitialize(const GatewayMessage & receivedData);
 
         /**
          * @brief Callback to process a message received from the server.
          *
+         * Derived classes must implement either this function or the std::vector<std::string> overload. The default
+         * implementation copies the fields and calls the std::vector<std::string> overload.
+         *
+         * @param receivedData the received message content excluding the header/timestamp
+         */
+        virtual void DoUpdate(const GatewayMessage & receivedData);
+
+        /**
+         * @brief Callback to process the first message received from the server (compatibility API).
+         *
+         * @param receivedData the received message content excluding the header/timestamp
+         */        
+        virtual void DoInitialize(const std::vector<std::string> & receivedData);
+
+        /**
+         * @brief Callback to process a message received from the server (compatibility API).
+         *
          * @param receivedData the received message content excluding the header/timestamp
          */ 
-        virtual void DoUpdate(const std::vector<std::string> & receivedData) = 0;
+        virtual void DoUpdate(const std::vector<std::string> & receivedData);
 
         uint32_t m_context;     //!< Simulator context when the gateway instance was created
         
         EventId m_eventWait;    //!< If IsPending, an event to call Gateway::WaitForNextUpdate in an infinite loop
         EventId m_eventDestroy; //!< If IsPending, an event to call Gateway::StopThread when the simulator stops
 
-        STATE m_state;          //!< Current state of the gateway instance
+        std::atomic<STATE> m_state; //!< Current state of the gateway instance (also read by the gateway threads)
+        FRAMING m_framing;      //!< The format of the messages exchanged with the server
+        IDLE_MODE m_idleMode;   //!< How Gateway::WaitForNextUpdate pauses ns-3 time progression
+
+        uint64_t m_idleEventCount;      //!< Simulator event count when Gateway::WaitForNextUpdate last executed
+        uint64_t m_idleWaitEventCount;  //!< Shared wait event count when Gateway::WaitForNextUpdate last executed
 
         Time m_timeStart;       //!< Initial timestamp received from the server specified by Gateway::Connect
         Time m_timePause;       //!< Time at which Gateway::WaitForNextUpdate will pause ns-3 time progression
+        Time m_lookahead;       //!< Time ns-3 may advance beyond each received timestamp (see Gateway::SetLookahead)
+        bool m_lookaheadHeader; //!< True if each received message includes its lookahead
+
+        Ptr<GatewayTransport> m_transport;  //!< Connection to the server specified by Gateway::Connect
 
-        int m_socket;           //!< Client UDP socket connection to the server specified by Gateway::Connect
+        std::thread m_thread;   //!< Thread that receives messages from the transport (without a reactor)
+        Ptr<GatewayReactor> m_reactor;  //!< The reactor that receives messages (see Gateway::SetReactor)
+        bool m_reactorRegistered;       //!< True while the transport is added to m_reactor
+        GatewayCoordinator * m_coordinator; //!< The coordinator of time progression (see GatewayCoordinator), or null
 
-        std::thread m_thread;   //!< Thread that receives messages from the client UDP socket connection
+        static const size_t MESSAGE_QUEUE_CAPACITY = 1024; //!< The maximum number of messages in m_messageQueue
+        static constexpr std::chrono::milliseconds WRITER_DRAIN_TIMEOUT{1000};  //!< The maximum time Gateway::Stop
+                                                                                //!< waits to send queued responses
 
-        std::queue<std::string> m_messageQueue; //!< Shared memory between the main thread and the read thread
-        std::mutex m_messageQueueMutex;         //!< Mutex lock used to synchronize access to the shared memory
+        struct TimedMessage     // a message buffer, and the time at which it was received or created
+        {
+            std::string data;                               //!< The message content
+            std::chrono::steady_clock::time_point time;     //!< When the message was received or created
+        };
+
+        SpscQueue<ReceivedMessage> m_messageQueue; //!< Messages passed from the read thread to the main thread
+        std::atomic<bool> m_forwardScheduled;   //!< True while Gateway::ForwardUp is scheduled but has not started
+        ReceivedMessage m_receivedMessage;      //!< The message being queued by Gateway::ForwardReceived
+        bool m_receivedPending;                 //!< True if m_receivedMessage was read but not yet queued
+        bool m_receivedStaged;                  //!< True if Gateway::DoStage accepted m_receivedMessage (or is unused)
+        std::atomic<bool> m_receivePaused;      //!< True while the reactor does not receive because a queue is full
+        ReceivedMessage m_forwardBuffer;        //!< The message being processed by Gateway::ForwardUp
+        bool m_readThreadParsing;               //!< True if the read thread parses each message
+
+        std::atomic<bool> m_threadExited;       //!< True once the read thread stops receiving (set with the wait mutex)
+        bool m_terminated;                      //!< True once the terminate message was processed
         
         std::string m_delimiterField;           //!< The character sequence that separates values within a message
         std::string m_delimiterMessage;         //!< The character sequence that indicates the end of a message
-        std::string m_messageBuffer;            //!< A buffer for any data received after the message delimiter
+        ReceiveBuffer m_receiveBuffer;          //!< A buffer for data received from the transport (read thread only)
+        uint32_t m_receiveSize;                 //!< The maximum number of bytes requested by one receive call
         
-        std::vector<std::string> m_data;        //!< The values that will be sent to the server next update
+        bool m_asyncSend;                       //!< True if responses are sent by the writer thread
+        std::thread m_writerThread;             //!< Thread that sends responses (see Gateway::SetAsyncSend)
+        SpscQueue<TimedMessage> m_sendQueue;    //!< Responses passed from the main thread to the writer thread
+        TimedMessage m_writerResponse;          //!< The response being sent by the writer thread
+        std::mutex m_sendMutex;                 //!< Mutex lock used to wake the writer thread
+        std::condition_variable m_sendCondition; //!< Signalled when a response is queued or the writer should stop
+        bool m_writerStopping;                  //!< True once the writer thread should exit (guarded by m_sendMutex)
+        bool m_writerExited;                    //!< True once the writer thread exits (guarded by m_sendMutex)
+
+        std::atomic<uint64_t> m_queuedBytes;        //!< Bytes in m_sendQueue
+        std::atomic<uint64_t> m_sentResponses;      //!< The number of responses passed to the transport
+        std::atomic<uint64_t> m_sentBytes;          //!< The number of bytes passed to the transport
+        std::atomic<int64_t> m_sendLatencyTotal;    //!< Sum of the send latencies in nanoseconds
+        std::atomic<int64_t> m_sendLatencyMax;      //!< Maximum send latency in nanoseconds
+
+        std::string m_messageRecordPath;        //!< The path of the received message recording, or empty
+        std::string m_responseRecordPath;       //!< The path of the response recording, or empty
+        GatewayRecorder m_messageRecorder;      //!< Records received messages (read thread only)
+        GatewayRecorder m_responseRecorder;     //!< Records responses (the thread that sends responses only)
+
+        std::vector<std::string> m_data;        //!< The values sent with the next response (encoded fields if BINARY)
+        std::string m_encoded;                  //!< The field being encoded by Gateway::SetValue (BINARY framing only)
+        uint32_t m_precision;                   //!< Significant digits of floating point values (0 for shortest)
+        bool m_checkNumbers;                    //!< True if a delimiter can appear in a formatted number
+        std::string m_response;                 //!< The buffer of the response being sent (re-used between responses)
+
+        RESPONSE_MODE m_responseMode;           //!< Which values Gateway::SendResponse sends
+        uint32_t m_keyframeInterval;            //!< The number of responses between keyframes in the DELTA mode
+        uint64_t m_responseCount;               //!< The number of responses sent
+        bool m_nextEventReport;                 //!< True if each response includes the next watched event time
+        bool m_responseHeader;                  //!< True if each response begins with its timestamp and sequence
+        uint64_t m_sequence;                    //!< The index of the received message most recently processed
+        std::vector<EventId> m_watchedEvents;   //!< Events included in the next event time (see Gateway::WatchEvent)
+        std::vector<bool> m_changed;            //!< True for each value changed since the previous response
+        std::vector<uint32_t> m_changedIndices; //!< The indices of the changed values, in order of the first change
+
+        std::deque<GatewayMessage> m_updateQueue;   //!< Parsed messages waiting for Gateway::HandleUpdate
+        std::vector<GatewayMessage> m_updatePool;   //!< Processed messages whose buffers can be re-used
+
+        struct PendingStep      // the timing of a step whose update has not executed yet
+        {
+            StepTiming timing;                              //!< The stages measured so far
+            std::chrono::steady_clock::time_point granted;  //!< When the time grant for the step was made
+            bool measured;                                  //!< True if the stages were timed
+        };
+
+        /**
+         * @brief Check if the stages of each step are timed.
+         * @return true if the timing histograms are enabled or the "Step" trace source is connected
+         */
+        bool IsTimingEnabled() const;
+
+        /**
+         * @brief Execute a function, then complete the timing of the front element of m_stepQueue.
+         *
+         * @param update the function to execute (Gateway::DoInitialize or Gateway::DoUpdate)
+         * @param message the message to pass to the function
+         */
+        void ExecuteStep(void (Gateway::*update)(const GatewayMessage &), const GatewayMessage & message);
+
+        std::deque<PendingStep> m_stepQueue;    //!< The timing of each message in m_updateQueue
+        TracedCallback<const StepTiming &> m_stepTrace; //!< Trace source for the timing of each step
+        bool m_timingHistograms;                //!< True if each step is recorded in m_histograms
+        std::array<LatencyHistogram, TIMING_STAGE_COUNT> m_histograms;  //!< The time spent in each stage
+        bool m_paused;                          //!< True if ns-3 paused at the granted time since the last grant
+        std::chrono::steady_clock::time_point m_pausedAt;   //!< When ns-3 paused at the granted time
+        bool m_timingResponse;                  //!< True while Gateway::SendResponse durations are being measured
+        std::chrono::steady_clock::duration m_responseDuration; //!< Time spent in Gateway::SendResponse this step
+
+        double m_pacingSpeed;                   //!< Simulation seconds per wall clock second, or 0 to not pace
+        Time m_pacingOrigin;                    //!< The simulation time aligned with m_pacingStart
+        std::chrono::steady_clock::time_point m_pacingStart;    //!< The wall clock time aligned with m_pacingOrigin
+        Time m_pacedTime;                       //!< The simulation time of the most recent deadline
+        TracedCallback<const PacingTiming &> m_pacingTrace; //!< Trace source for the pacing of each deadline
+        uint64_t m_pacingDeadlines;             //!< The number of deadlines reached
+        uint64_t m_pacingMisses;                //!< The number of missed deadlines
+        Time m_pacingMinSlack;                  //!< The smallest slack of a deadline
+        Time m_pacingJitterTotal;               //!< Sum of the wake-up jitter of every deadline
+        Time m_pacingJitterMax;                 //!< Maximum wake-up jitter of a deadline
 };
 
+template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type>
+void
+Gateway::SetValue(uint32_t index, T value)
+{
+    if (m_framing == FRAMING::BINARY)
+    {
+        m_encoded.clear();
+        if constexpr (sizeof(T) < sizeof(int32_t) || (sizeof(T) == sizeof(int32_t) && std::is_signed<T>::value))
+        {
+            BinaryEncoder::AppendInt32(m_encoded, value);
+        }
+        else
+        {
+            BinaryEncoder::AppendInt64(m_encoded, static_cast<int64_t>(value));
+        }
+        SetFieldValue(index, m_encoded.data(), m_encoded.size());
+        return;
+    }
+
+    char buffer[24]; // the longest 64-bit integer has 20 digits and a sign
+    size_t size;
+    if constexpr (std::is_same<T, bool>::value)
+    {
+        buffer[0] = value ? '1' : '0';
+        size = 1;
+    }
+    else
+    {
+        size = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer;
+    }
+    SetFormattedValue(index, buffer, size, m_checkNumbers);
+}
+
 } // namespace ns3
 
 #endif /* GATEWAY_H */
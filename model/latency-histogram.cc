@@ -0,0 +1,155 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "latency-histogram.h"
+
+namespace ns3
+{
+
+LatencyHistogram::LatencyHistogram():
+    m_counts((64 - SUB_BUCKET_BITS) * SUB_BUCKET_COUNT, 0)
+{
+    Clear();
+}
+
+void
+LatencyHistogram::Record(Time value)
+{
+    uint64_t nanoseconds = value.IsStrictlyNegative() ? 0 : value.GetNanoSeconds();
+    m_counts[GetIndex(nanoseconds)]++;
+    m_count++;
+    m_total += nanoseconds;
+    m_min = std::min(m_min, nanoseconds);
+    m_max = std::max(m_max, nanoseconds);
+}
+
+void
+LatencyHistogram::Clear()
+{
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_count = 0;
+    m_total = 0;
+    m_min = std::numeric_limits<uint64_t>::max();
+    m_max = 0;
+}
+
+uint64_t
+LatencyHistogram::GetCount() const
+{
+    return m_count;
+}
+
+Time
+LatencyHistogram::GetMin() const
+{
+    return NanoSeconds(m_count == 0 ? 0 : m_min);
+}
+
+Time
+LatencyHistogram::GetMax() const
+{
+    return NanoSeconds(m_max);
+}
+
+Time
+LatencyHistogram::GetMean() const
+{
+    return NanoSeconds(m_count == 0 ? 0 : m_total / m_count);
+}
+
+Time
+LatencyHistogram::GetPercentile(double percentile) const
+{
+    if (m_count == 0)
+    {
+        return Time(0);
+    }
+
+    // the rank of the value at the percentile, from 1 to m_count
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::min(std::max(percentile, 0.0), 100.0) / 100.0 * m_count));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t count = 0;
+    for (uint32_t index = 0; index < m_counts.size(); index++)
+    {
+        count += m_counts[index];
+        if (count >= rank)
+        {
+            return NanoSeconds(std::min(GetUpperBound(index), m_max));
+        }
+    }
+    return NanoSeconds(m_max);
+}
+
+void
+LatencyHistogram::Print(std::ostream & os) const
+{
+    os << "count=" << m_count
+       << " mean=" << GetMean().As(Time::US)
+       << " p50=" << GetPercentile(50).As(Time::US)
+       << " p90=" << GetPercentile(90).As(Time::US)
+       << " p99=" << GetPercentile(99).As(Time::US)
+       << " p99.9=" << GetPercentile(99.9).As(Time::US)
+       << " max=" << GetMax().As(Time::US);
+}
+
+uint32_t
+LatencyHistogram::GetIndex(uint64_t value)
+{
+    if (value < 2 * SUB_BUCKET_COUNT)
+    {
+        return value; // exact
+    }
+
+    // keep the SUB_BUCKET_BITS + 1 most significant bits of the value
+    uint32_t shift = (63 - __builtin_clzll(value)) - SUB_BUCKET_BITS;
+    return shift * SUB_BUCKET_COUNT + static_cast<uint32_t>(value >> shift);
+}
+
+uint64_t
+LatencyHistogram::GetUpperBound(uint32_t index)
+{
+    if (index < 2 * SUB_BUCKET_COUNT)
+    {
+        return index;
+    }
+
+    uint32_t shift = index / SUB_BUCKET_COUNT - 1;
+    uint64_t top = index % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT;
+    return ((top + 1) << shift) - 1; // INT64_MAX (2^63 - 1) for the last bucket
+}
+
+} // namespace ns3
@@ -0,0 +1,126 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "ns3/nstime.h"
+
+namespace ns3
+{
+
+/**
+ * A histogram of durations with logarithmic buckets, in the style of an HDR histogram.
+ *
+ * Durations are recorded in nanoseconds. Values below 64 ns are counted exactly, and larger values are counted in
+ * buckets whose width is 1/32 of their power of 2, so every percentile is reported within about 3 % of the recorded
+ * value. Every non-negative Time (the full range of a signed int64 in nanoseconds) is covered by a fixed set of
+ * (64 - SUB_BUCKET_BITS) * SUB_BUCKET_COUNT = 1888 buckets, so recording a value never allocates memory and takes
+ * constant time.
+ */
+class LatencyHistogram
+{
+    public:
+        /**
+         * @brief Create an empty histogram.
+         */
+        LatencyHistogram();
+
+        /**
+         * @brief Count one duration (negative durations are counted as 0).
+         * @param value the duration
+         */
+        void Record(Time value);
+
+        /**
+         * @brief Remove every recorded duration.
+         */
+        void Clear();
+
+        /**
+         * @brief Get the number of recorded durations.
+         * @return the number of calls to Record since the histogram was created or cleared
+         */
+        uint64_t GetCount() const;
+
+        /**
+         * @brief Get a statistic of the recorded durations (0 if the histogram is empty).
+         * @return the exact minimum, maximum, or mean duration
+         */
+        Time GetMin() const;
+        Time GetMax() const;
+        Time GetMean() const;
+
+        /**
+         * @brief Get the duration at or below which a percentage of the recorded durations fall.
+         * @param percentile the percentage, from 0 to 100
+         * @return the largest value in the bucket containing the percentile (0 if the histogram is empty)
+         */
+        Time GetPercentile(double percentile) const;
+
+        /**
+         * @brief Output the count, mean, 50th, 90th, 99th, and 99.9th percentiles, and maximum on one line.
+         * @param os the output stream
+         */
+        void Print(std::ostream & os) const;
+    private:
+        static const uint32_t SUB_BUCKET_BITS = 5;                      //!< log2 of the buckets per power of 2
+        static const uint32_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;  //!< The number of buckets per power of 2
+
+        /**
+         * @brief Get the bucket that counts a value.
+         * @param value the value in nanoseconds
+         * @return the index of the bucket within m_counts
+         */
+        static uint32_t GetIndex(uint64_t value);
+
+        /**
+         * @brief Get the largest value counted by a bucket.
+         * @param index the index of the bucket within m_counts
+         * @return the value in nanoseconds
+         */
+        static uint64_t GetUpperBound(uint32_t index);
+
+        std::vector<uint64_t> m_counts; //!< The number of values in each bucket
+        uint64_t m_count;               //!< The number of recorded values
+        uint64_t m_total;               //!< The sum of the recorded values in nanoseconds
+        uint64_t m_min;                 //!< The smallest recorded value in nanoseconds
+        uint64_t m_max;                 //!< The largest recorded value in nanoseconds
+};
+
+} // namespace ns3
+
+#endif /* LATENCY_HISTOGRAM_H */
@@ -0,0 +1,202 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <algorithm>
+#include <cstring>
+
+#include "receive-buffer.h"
+
+#include "ns3/fatal-error.h"
+
+namespace ns3
+{
+
+ReceiveBuffer::ReceiveBuffer(size_t capacity):
+    m_data(capacity > 0 ? capacity : 1),
+    m_head(0),
+    m_size(0),
+    m_searched(0)
+{
+    // do nothing
+}
+
+char *
+ReceiveBuffer::GetWritable(size_t maximumSize, size_t & size)
+{
+    if (m_size == m_data.size())
+    {
+        Reallocate(2 * m_data.size()); // the buffer is full, so a message is larger than the capacity
+    }
+
+    size_t tail = m_head + m_size;
+    if (tail >= m_data.size())
+    {
+        // the free space is between the wrapped tail and the head
+        tail -= m_data.size();
+        size = m_head - tail;
+    }
+    else
+    {
+        // the free space is from the tail to the end of the memory (the space before the head is returned next time)
+        size = m_data.size() - tail;
+    }
+    size = std::min(size, maximumSize);
+    return &m_data[tail];
+}
+
+void
+ReceiveBuffer::Commit(size_t size)
+{
+    if (m_size + size > m_data.size())
+    {
+        NS_FATAL_ERROR("ERROR: ReceiveBuffer::Commit called with " << size << " bytes for a free size of "
+            << m_data.size() - m_size);
+    }
+    m_size += size;
+}
+
+size_t
+ReceiveBuffer::GetSize() const
+{
+    return m_size;
+}
+
+bool
+ReceiveBuffer::Find(const std::string & delimiter, size_t & position)
+{
+    const size_t delimiterSize = delimiter.size();
+    const char first = delimiter[0];
+
+    size_t offset = m_searched;
+    while (offset + delimiterSize <= m_size)
+    {
+        // search for the first delimiter byte within the contiguous memory starting at offset
+        size_t index = m_head + offset;
+        if (index >= m_data.size())
+        {
+            index -= m_data.size();
+        }
+        size_t searchSize = std::min(m_data.size() - index, m_size - delimiterSize + 1 - offset);
+        const char * match = static_cast<const char *>(std::memchr(&m_data[index], first, searchSize));
+        if (match == nullptr)
+        {
+            offset += searchSize;
+            continue;
+        }
+        offset += match - &m_data[index];
+
+        // compare the remaining delimiter bytes, which may wrap around the end of the memory
+        size_t i = 1;
+        while (i < delimiterSize && At(offset + i) == delimiter[i])
+        {
+            i++;
+        }
+        if (i == delimiterSize)
+        {
+            position = offset;
+            m_searched = offset;
+            return true;
+        }
+        offset++;
+    }
+
+    // the last (delimiterSize - 1) bytes may start a delimiter that is completed by the next received bytes
+    m_searched = (m_size >= delimiterSize) ? m_size - delimiterSize + 1 : 0;
+    return false;
+}
+
+void
+ReceiveBuffer::Peek(char * data, size_t size) const
+{
+    if (size > m_size)
+    {
+        NS_FATAL_ERROR("ERROR: ReceiveBuffer::Peek called with " << size << " bytes for a size of " << m_size);
+    }
+
+    size_t firstSize = std::min(size, m_data.size() - m_head);
+    std::memcpy(data, &m_data[m_head], firstSize);
+    std::memcpy(data + firstSize, &m_data[0], size - firstSize);
+}
+
+void
+ReceiveBuffer::Read(size_t size, std::string & data)
+{
+    if (size > m_size)
+    {
+        NS_FATAL_ERROR("ERROR: ReceiveBuffer::Read called with " << size << " bytes for a size of " << m_size);
+    }
+
+    size_t firstSize = std::min(size, m_data.size() - m_head);
+    data.assign(&m_data[m_head], firstSize);
+    data.append(&m_data[0], size - firstSize);
+    Consume(size);
+}
+
+void
+ReceiveBuffer::Consume(size_t size)
+{
+    if (size > m_size)
+    {
+        NS_FATAL_ERROR("ERROR: ReceiveBuffer::Consume called with " << size << " bytes for a size of " << m_size);
+    }
+
+    m_head += size;
+    if (m_head >= m_data.size())
+    {
+        m_head -= m_data.size();
+    }
+    m_size -= size;
+    m_searched = (m_searched > size) ? m_searched - size : 0;
+
+    if (m_size == 0)
+    {
+        m_head = 0; // keep the free space contiguous when possible
+    }
+}
+
+char
+ReceiveBuffer::At(size_t offset) const
+{
+    size_t index = m_head + offset;
+    return m_data[index < m_data.size() ? index : index - m_data.size()];
+}
+
+void
+ReceiveBuffer::Reallocate(size_t capacity)
+{
+    std::vector<char> data(capacity);
+    Peek(data.data(), m_size);
+    m_data.swap(data);
+    m_head = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,151 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#ifndef RECEIVE_BUFFER_H
+#define RECEIVE_BUFFER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * A growable ring buffer for data received from a stream socket.
+ *
+ * Data is received directly into the free space of the buffer (see ReceiveBuffer::GetWritable), and complete messages
+ * are copied out exactly once (see ReceiveBuffer::Read). The search for a message delimiter is resumable: bytes that
+ * were already searched are not searched again when more data is received.
+ */
+class ReceiveBuffer
+{
+    public:
+        /**
+         * @brief Create an empty buffer.
+         * @param capacity the initial capacity in bytes (the buffer grows as needed)
+         */
+        explicit ReceiveBuffer(size_t capacity = 65536);
+
+        /**
+         * @brief Get the contiguous free space at the end of the buffer, growing the buffer only if it is full.
+         *
+         * When the free space wraps around the end of the memory, only the part before the wrap is returned, and the
+         * rest is returned by the next call after ReceiveBuffer::Commit. The buffered bytes are never moved, except
+         * when a full buffer grows. The returned memory remains valid until the next call to a non-const member
+         * function.
+         *
+         * @param maximumSize the maximum number of free bytes to return (greater than 0)
+         * @param size the number of free bytes returned, which is greater than 0 and at most maximumSize
+         * @return the first free byte
+         */
+        char * GetWritable(size_t maximumSize, size_t & size);
+
+        /**
+         * @brief Add bytes written into the memory returned by ReceiveBuffer::GetWritable to the end of the buffer.
+         * @param size the number of bytes written
+         */
+        void Commit(size_t size);
+
+        /**
+         * @brief Get the number of bytes in the buffer.
+         * @return the number of bytes
+         */
+        size_t GetSize() const;
+
+        /**
+         * @brief Find the first occurrence of a delimiter, resuming the search where the previous search stopped.
+         *
+         * The delimiter must not change between calls unless the buffer is emptied in between.
+         *
+         * @param delimiter the non-empty sequence of bytes to find
+         * @param position the offset of the delimiter from the start of the buffer
+         * @return true if the delimiter was found
+         */
+        bool Find(const std::string & delimiter, size_t & position);
+
+        /**
+         * @brief Copy bytes from the start of the buffer without removing them.
+         *
+         * Exceptions:
+         *  1) size must be at most ReceiveBuffer::GetSize.
+         *
+         * @param data the destination of the copied bytes
+         * @param size the number of bytes to copy
+         */
+        void Peek(char * data, size_t size) const;
+
+        /**
+         * @brief Remove bytes from the start of the buffer, copying them into a string.
+         *
+         * The string is overwritten, and its memory is re-used if it has sufficient capacity.
+         *
+         * Exceptions:
+         *  1) size must be at most ReceiveBuffer::GetSize.
+         *
+         * @param size the number of bytes to remove
+         * @param data the destination of the removed bytes
+         */
+        void Read(size_t size, std::string & data);
+
+        /**
+         * @brief Remove bytes from the start of the buffer.
+         *
+         * Exceptions:
+         *  1) size must be at most ReceiveBuffer::GetSize.
+         *
+         * @param size the number of bytes to remove
+         */
+        void Consume(size_t size);
+    private:
+        /**
+         * @brief Get the byte at an offset from the start of the buffer.
+         * @param offset the offset, which must be less than ReceiveBuffer::GetSize
+         * @return the byte at the offset
+         */
+        char At(size_t offset) const;
+
+        /**
+         * @brief Allocate new memory, moving the buffered bytes to the start of the new memory.
+         * @param capacity the new capacity, which must be at least the current capacity
+         */
+        void Reallocate(size_t capacity);
+
+        std::vector<char> m_data;   //!< The memory of the ring buffer
+        size_t m_head;              //!< The index in m_data of the first byte in the buffer
+        size_t m_size;              //!< The number of bytes in the buffer
+        size_t m_searched;          //!< The number of bytes at the start of the buffer known not to start a delimiter
+};
+
+} // namespace ns3
+
+#endif /* RECEIVE_BUFFER_H */
@@ -0,0 +1,200 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <algorithm>
+#include <cstring>
+
+#include "replay-transport.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ReplayTransport");
+
+ReplayTransport::ReplayTransport():
+    m_pacing(PACING::AS_FAST_AS_POSSIBLE),
+    m_messageOffset(0),
+    m_started(false),
+    m_shutdown(false),
+    m_responses(0),
+    m_mismatches(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ReplayTransport::~ReplayTransport()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+void
+ReplayTransport::Open(const std::string & path, PACING pacing)
+{
+    NS_LOG_FUNCTION(this << path << pacing);
+
+    if (m_messages.IsOpen())
+    {
+        NS_FATAL_ERROR("ERROR: ReplayTransport::Open called for an open transport");
+    }
+    m_messages.Open(path);
+    m_pacing = pacing;
+    NS_LOG_INFO("ReplayTransport replaying " << path);
+}
+
+void
+ReplayTransport::SetResponseLog(const std::string & path)
+{
+    NS_LOG_FUNCTION(this << path);
+
+    m_responseLog.Close();
+    m_responseLog.Open(path);
+}
+
+uint64_t
+ReplayTransport::GetResponseCount() const
+{
+    return m_responses.load();
+}
+
+uint64_t
+ReplayTransport::GetMismatchCount() const
+{
+    return m_mismatches.load();
+}
+
+ssize_t
+ReplayTransport::Receive(char * data, size_t size)
+{
+    {   // critical section start
+        std::unique_lock lock(m_shutdownMutex);
+        if (m_shutdown)
+        {
+            return 0;
+        }
+    }   // critical section end
+
+    while (m_messageOffset == m_message.size()) // skips empty messages
+    {
+        Time time;
+        if (!m_messages.Read(m_message, time))
+        {
+            return 0; // the end of the recording closes the connection
+        }
+        m_messageOffset = 0;
+
+        if (m_pacing == PACING::WALL_CLOCK)
+        {
+            if (!m_started)
+            {
+                m_start = std::chrono::steady_clock::now();
+                m_started = true;
+            }
+            std::unique_lock lock(m_shutdownMutex);
+            if (m_shutdownCondition.wait_until(lock, m_start + std::chrono::nanoseconds(time.GetNanoSeconds()),
+                [this] { return m_shutdown; }))
+            {
+                return 0;
+            }
+        }
+    }
+
+    size_t receivedSize = std::min(size, m_message.size() - m_messageOffset);
+    std::memcpy(data, m_message.data() + m_messageOffset, receivedSize);
+    m_messageOffset += receivedSize;
+    return receivedSize;
+}
+
+bool
+ReplayTransport::Send(const char * data, size_t size)
+{
+    uint64_t response = m_responses.fetch_add(1);
+    if (!m_responseLog.IsOpen())
+    {
+        return true; // discard the response
+    }
+
+    Time time;
+    if (!m_responseLog.Read(m_expected, time))
+    {
+        m_mismatches.fetch_add(1);
+        NS_LOG_WARN("WARNING: response " << response << " is beyond the end of the response log");
+        return true;
+    }
+    if (m_expected.size() != size || std::memcmp(m_expected.data(), data, size) != 0)
+    {
+        size_t common = std::min(m_expected.size(), size);
+        size_t position = std::mismatch(data, data + common, m_expected.data()).first - data;
+        m_mismatches.fetch_add(1);
+        NS_LOG_WARN("WARNING: response " << response << " differs from the response log at byte " << position
+            << " (" << size << " bytes sent, " << m_expected.size() << " bytes recorded)"
+        );
+    }
+    return true;
+}
+
+void
+ReplayTransport::Shutdown()
+{
+    NS_LOG_FUNCTION(this);
+
+    {   // critical section start
+        std::unique_lock lock(m_shutdownMutex);
+        m_shutdown = true;
+    }   // critical section end
+    m_shutdownCondition.notify_all();
+}
+
+void
+ReplayTransport::Close()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_responseLog.IsOpen())
+    {
+        uint64_t missing = 0;
+        Time time;
+        while (m_responseLog.Read(m_expected, time))
+        {
+            missing++;
+        }
+        if (missing > 0)
+        {
+            m_mismatches.fetch_add(missing);
+            NS_LOG_WARN("WARNING: " << missing << " recorded responses were not sent");
+        }
+        m_responseLog.Close();
+    }
+    m_messages.Close();
+}
+
+} // namespace ns3
@@ -0,0 +1,131 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#ifndef REPLAY_TRANSPORT_H
+#define REPLAY_TRANSPORT_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "gateway-recorder.h"
+#include "gateway-transport.h"
+
+namespace ns3
+{
+
+/**
+ * A transport that replays the messages recorded by a gateway (see Gateway::SetRecordFile), instead of connecting to a
+ * server. This runs the ns-3 side of a co-simulation without the server, for repeatable benchmarks of ns-3 and for
+ * regression checks of the responses.
+ *
+ * Messages are received in the recorded order, either as fast as the gateway reads them or at the recorded wall clock
+ * times (see ReplayTransport::PACING). The connection closes at the end of the recording. Responses are discarded, or
+ * compared with a recorded response log (see ReplayTransport::SetResponseLog), where each response must be identical
+ * to the recorded response at the same position.
+ */
+class ReplayTransport : public GatewayTransport
+{
+    public:
+        enum PACING     // when recorded messages are received
+        {
+            AS_FAST_AS_POSSIBLE,    // as soon as the gateway requests data (default)
+            WALL_CLOCK              // at the recorded time since the first receive call
+        };
+
+        ReplayTransport();
+        ~ReplayTransport() override;
+
+        /**
+         * @brief Open the recording of received messages.
+         *
+         * Exceptions:
+         *  1) the transport must not already be open.
+         *  2) a file that does not exist or is not a recording will cause a fatal error.
+         *
+         * @param path the file system path of the recorded messages
+         * @param pacing when recorded messages are received (default: AS_FAST_AS_POSSIBLE)
+         */
+        void Open(const std::string & path, PACING pacing = PACING::AS_FAST_AS_POSSIBLE);
+
+        /**
+         * @brief Compare each sent response with a recorded response log, instead of discarding it.
+         *
+         * A response that differs from the recorded response, a response beyond the end of the log, and each recorded
+         * response that was not sent when the transport closes, are counted as mismatches with a warning.
+         *
+         * Exceptions:
+         *  1) a file that does not exist or is not a recording will cause a fatal error.
+         *
+         * @param path the file system path of the recorded responses
+         */
+        void SetResponseLog(const std::string & path);
+
+        /**
+         * @brief Get the number of responses sent to the transport.
+         * @return the number of responses
+         */
+        uint64_t GetResponseCount() const;
+
+        /**
+         * @brief Get the number of responses that did not match the response log (see ReplayTransport::SetResponseLog).
+         * @return the number of mismatches
+         */
+        uint64_t GetMismatchCount() const;
+
+        ssize_t Receive(char * data, size_t size) override;
+        bool Send(const char * data, size_t size) override;
+        void Close() override;
+        void Shutdown() override;
+    private:
+        GatewayRecordReader m_messages;     //!< The recorded messages (read by the receiving thread)
+        PACING m_pacing;                    //!< When recorded messages are received
+        std::string m_message;              //!< The current recorded message
+        size_t m_messageOffset;             //!< Bytes of m_message already received
+        bool m_started;                     //!< True once the first message was read
+        std::chrono::steady_clock::time_point m_start;  //!< The time of the first receive call (WALL_CLOCK pacing)
+        bool m_shutdown;                    //!< True once ReplayTransport::Shutdown is called
+        std::mutex m_shutdownMutex;         //!< Protects m_shutdown
+        std::condition_variable m_shutdownCondition;    //!< Wakes a receive call waiting for a WALL_CLOCK time
+
+        GatewayRecordReader m_responseLog;  //!< The recorded responses (read by the sending thread)
+        std::string m_expected;             //!< The recorded response compared with the sent response
+        std::atomic<uint64_t> m_responses;  //!< The number of sent responses
+        std::atomic<uint64_t> m_mismatches; //!< The number of responses that did not match m_responseLog
+};
+
+} // namespace ns3
+
+#endif /* REPLAY_TRANSPORT_H */
@@ -0,0 +1,446 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <thread>
+
+#include "shared-memory-transport.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SharedMemoryTransport");
+
+namespace
+{
+
+const uint32_t SEGMENT_MAGIC = 0x4e33434d;  //!< Identifies an initialized shared memory transport ("N3CM")
+
+enum PEER_STATE : uint32_t  // the state of one side of the transport
+{
+    NONE,       // not connected (yet)
+    OPEN,       // connected
+    CLOSED      // SharedMemoryTransport::Close called
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "shared memory atomics must be lock-free");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "a futex must be a 32-bit word");
+
+/**
+ * @brief Wait until a signal no longer has the expected value, a wake up, or a timeout of 100 ms.
+ * @return false if the wait timed out
+ */
+bool
+WaitSignal(std::atomic<uint32_t> & signal, uint32_t expected)
+{
+#ifdef __linux__
+    struct timespec timeout = {0, 100000000};
+    long result = syscall(SYS_futex, reinterpret_cast<uint32_t *>(&signal), FUTEX_WAIT, expected, &timeout, NULL, 0);
+    return !(result == -1 && errno == ETIMEDOUT);
+#else
+    std::this_thread::sleep_for(std::chrono::microseconds(100)); // poll without futexes
+    return signal.load() != expected;
+#endif
+}
+
+/**
+ * @brief Wake every thread, in any process, waiting on a signal.
+ */
+void
+WakeSignal(std::atomic<uint32_t> & signal)
+{
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&signal), FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#endif
+}
+
+} // namespace
+
+/**
+ * The positions are the total number of bytes written to and read from the ring, so the ring is empty when they are
+ * equal and full when they differ by the capacity. Each signal is incremented when its position advances, and the
+ * other side only makes a wake system call if the waiting flag of the signal is set.
+ */
+struct SharedMemoryTransport::Ring
+{
+    alignas(64) std::atomic<uint64_t> head;     //!< Total bytes read (written by the reader)
+    alignas(64) std::atomic<uint64_t> tail;     //!< Total bytes written (written by the writer)
+    alignas(64) std::atomic<uint32_t> dataSignal;       //!< Incremented after tail advances
+    std::atomic<uint32_t> readerWaiting;                //!< Set while the reader waits on dataSignal
+    alignas(64) std::atomic<uint32_t> spaceSignal;      //!< Incremented after head advances
+    std::atomic<uint32_t> writerWaiting;                //!< Set while the writer waits on spaceSignal
+};
+
+struct SharedMemoryTransport::Segment
+{
+    std::atomic<uint32_t> magic;        //!< SEGMENT_MAGIC once the server has initialized the segment
+    uint32_t capacity;                  //!< The size of each ring's data, a power of 2
+    std::atomic<uint32_t> serverState;  //!< PEER_STATE of the server
+    std::atomic<uint32_t> clientState;  //!< PEER_STATE of the client (also used as a futex by Accept)
+    std::atomic<int32_t> serverPid;     //!< Process id of the server
+    std::atomic<int32_t> clientPid;     //!< Process id of the client
+    Ring rings[2];                      //!< [0] from the server to the client, [1] from the client to the server
+
+    /**
+     * @brief Get the offset of the ring data from the start of the segment.
+     */
+    static size_t GetDataOffset()
+    {
+        return (sizeof(Segment) + 63) & ~size_t(63);
+    }
+};
+
+SharedMemoryTransport::SharedMemoryTransport():
+    m_segment(nullptr),
+    m_mappedSize(0),
+    m_isServer(false),
+    m_sendRing(nullptr),
+    m_receiveRing(nullptr),
+    m_sendData(nullptr),
+    m_receiveData(nullptr),
+    m_peerExited(false),
+    m_shutdown(false)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SharedMemoryTransport::~SharedMemoryTransport()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+void
+SharedMemoryTransport::Connect(const std::string & name)
+{
+    NS_LOG_FUNCTION(this << name);
+
+    if (m_segment)
+    {
+        NS_FATAL_ERROR("ERROR: SharedMemoryTransport::Connect called for a connected transport");
+    }
+
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd == -1)
+    {
+        NS_FATAL_ERROR("ERROR: SharedMemoryTransport::Connect failed to open " << name
+            << " (check if the server is running)"
+        );
+    }
+    struct stat status;
+    if (fstat(fd, &status) == -1 || status.st_size < (off_t)Segment::GetDataOffset())
+    {
+        NS_FATAL_ERROR("ERROR: SharedMemoryTransport::Connect opened an invalid shared memory object " << name);
+    }
+    Map(fd, status.st_size);
+
+    if (m_segment->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC
+        || m_mappedSize != Segment::GetDataOffset() + 2 * (size_t)m_segment->capacity)
+    {
+        NS_FATAL_ERROR("ERROR: SharedMemoryTransport::Connect opened an invalid shared memory object " << name);
+    }
+
+    m_segment->clientPid.store(getpid());
+    uint32_t state = PEER_STATE::NONE;
+    if (!m_segment->clientState.compare_exchange_strong(state, PEER_STATE::OPEN))
+    {
+        NS_FATAL_ERROR("ERROR: SharedMemoryTransport::Connect found " << name << " already has a client");
+    }
+    WakeSignal(m_segment->clientState); // the server is waiting in SharedMemoryTransport::Accept
+
+    m_isServer = false;
+    m_sendRing = &m_segment->rings[1];
+    m_receiveRing = &m_segment->rings[0];
+    m_sendData = reinterpret_cast<char *>(m_segment) + Segment::GetDataOffset() + m_segment->capacity;
+    m_receiveData = reinterpret_cast<char *>(m_segment) + Segment::GetDataOffset();
+    NS_LOG_INFO("SharedMemoryTransport connected to " << name);
+}
+
+void
+SharedMemoryTransport::Accept(const std::string & name, uint32_t capacity)
+{
+    Listen(name, capacity);
+    Accept();
+}
+
+void
+SharedMemoryTransport::Listen(const std::string & name, uint32_t capacity)
+{
+    NS_LOG_FUNCTION(this << name << capacity);
+
+    if (m_segment)
+    {
+        NS_FATAL_ERROR("ERROR: SharedMemoryTransport::Listen called for a connected transport");
+    }
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+    {
+        NS_FATAL_ERROR("ERROR: SharedMemoryTransport::Listen called with a capacity that is not a power of 2");
+    }
+
+    shm_unlink(name.c_str()); // replace an object left by a server that did not exit normally
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1)
+    {
+        NS_FATAL_ERROR("ERROR: SharedMemoryTransport::Listen failed to create " << name);
+    }
+    size_t size = Segment::GetDataOffset() + 2 * (size_t)capacity;
+    if (ftruncate(fd, size) == -1)
+    {
+        NS_FATAL_ERROR("ERROR: SharedMemoryTransport::Listen failed to allocate " << size << " bytes for " << name);
+    }
+    Map(fd, size);
+
+    // the new object is zero-filled, so only non-zero values are initialized
+    m_segment->capacity = capacity;
+    m_segment->serverPid.store(getpid());
+    m_segment->serverState.store(PEER_STATE::OPEN);
+    m_segment->magic.store(SEGMENT_MAGIC, std::memory_order_release);
+    m_isServer = true;
+    m_name = name;
+    NS_LOG_INFO("SharedMemoryTransport listening on " << name);
+}
+
+void
+SharedMemoryTransport::Accept()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!m_segment || !m_isServer || m_sendRing)
+    {
+        NS_FATAL_ERROR("ERROR: SharedMemoryTransport::Accept called before SharedMemoryTransport::Listen");
+    }
+
+    // wait for the client to open the object
+    NS_LOG_INFO("SharedMemoryTransport waiting for a client to open " << m_name);
+    while (m_segment->clientState.load() == PEER_STATE::NONE)
+    {
+        WaitSignal(m_segment->clientState, PEER_STATE::NONE);
+    }
+    shm_unlink(m_name.c_str()); // the object is freed once both sides unmap it
+    m_name.clear();
+
+    m_sendRing = &m_segment->rings[0];
+    m_receiveRing = &m_segment->rings[1];
+    m_sendData = reinterpret_cast<char *>(m_segment) + Segment::GetDataOffset();
+    m_receiveData = reinterpret_cast<char *>(m_segment) + Segment::GetDataOffset() + m_segment->capacity;
+    NS_LOG_INFO("SharedMemoryTransport accepted a client connection");
+}
+
+ssize_t
+SharedMemoryTransport::Receive(char * data, size_t size)
+{
+    Ring & ring = *m_receiveRing;
+    uint64_t head = ring.head.load(std::memory_order_relaxed); // only written by this side
+    uint64_t mask = m_segment->capacity - 1;
+
+    while (!m_shutdown.load())
+    {
+        uint64_t tail = ring.tail.load(std::memory_order_acquire);
+        if (tail != head)
+        {
+            // copy the available bytes, in at most two contiguous runs
+            size_t count = std::min<uint64_t>(size, tail - head);
+            size_t offset = head & mask;
+            size_t first = std::min<size_t>(count, mask + 1 - offset);
+            std::memcpy(data, m_receiveData + offset, first);
+            std::memcpy(data + first, m_receiveData, count - first);
+
+            ring.head.store(head + count);
+            ring.spaceSignal.fetch_add(1);
+            if (ring.writerWaiting.load())
+            {
+                WakeSignal(ring.spaceSignal);
+            }
+            return count;
+        }
+        if (IsPeerClosed())
+        {
+            // the other side may have sent data before closing
+            return (ring.tail.load(std::memory_order_acquire) != head) ? Receive(data, size) : 0;
+        }
+
+        // wait for data, unless it arrived after the checks above
+        uint32_t signal = ring.dataSignal.load();
+        ring.readerWaiting.store(1);
+        if (ring.tail.load() == head && !WaitSignal(ring.dataSignal, signal))
+        {
+            CheckPeerExited();
+        }
+        ring.readerWaiting.store(0, std::memory_order_relaxed);
+    }
+    return 0;
+}
+
+bool
+SharedMemoryTransport::Send(const char * data, size_t size)
+{
+    Ring & ring = *m_sendRing;
+    uint64_t tail = ring.tail.load(std::memory_order_relaxed); // only written by this side
+    uint64_t capacity = m_segment->capacity;
+
+    while (size > 0)
+    {
+        if (m_shutdown.load() || IsPeerClosed())
+        {
+            return false;
+        }
+
+        uint64_t head = ring.head.load(std::memory_order_acquire);
+        uint64_t space = capacity - (tail - head);
+        if (space == 0)
+        {
+            // wait for the other side to read, unless it did so after the check above
+            uint32_t signal = ring.spaceSignal.load();
+            ring.writerWaiting.store(1);
+            if (ring.head.load() == head && !WaitSignal(ring.spaceSignal, signal))
+            {
+                CheckPeerExited();
+            }
+            ring.writerWaiting.store(0, std::memory_order_relaxed);
+            continue;
+        }
+
+        // copy as many bytes as fit, in at most two contiguous runs
+        size_t count = std::min<uint64_t>(size, space);
+        size_t offset = tail & (capacity - 1);
+        size_t first = std::min<size_t>(count, capacity - offset);
+        std::memcpy(m_sendData + offset, data, first);
+        std::memcpy(m_sendData, data + first, count - first);
+
+        tail += count;
+        ring.tail.store(tail);
+        ring.dataSignal.fetch_add(1);
+        if (ring.readerWaiting.load())
+        {
+            WakeSignal(ring.dataSignal);
+        }
+        data += count;
+        size -= count;
+    }
+    return true;
+}
+
+void
+SharedMemoryTransport::Close()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!m_segment)
+    {
+        return;
+    }
+    if (!m_name.empty())
+    {
+        shm_unlink(m_name.c_str()); // closed before a client opened the object
+        m_name.clear();
+    }
+
+    (m_isServer ? m_segment->serverState : m_segment->clientState).store(PEER_STATE::CLOSED);
+    for (Ring & ring : m_segment->rings) // wake the other side if it is waiting
+    {
+        ring.dataSignal.fetch_add(1);
+        ring.spaceSignal.fetch_add(1);
+        WakeSignal(ring.dataSignal);
+        WakeSignal(ring.spaceSignal);
+    }
+
+    munmap(m_segment, m_mappedSize);
+    m_segment = nullptr;
+    m_sendRing = nullptr;
+    m_receiveRing = nullptr;
+}
+
+void
+SharedMemoryTransport::Shutdown()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!m_segment || !m_receiveRing)
+    {
+        return; // not connected, so no thread can be waiting in Receive or Send
+    }
+
+    m_shutdown.store(true);
+    m_receiveRing->dataSignal.fetch_add(1); // wake this side's reader, which is the only thread waiting on the signal
+    WakeSignal(m_receiveRing->dataSignal);
+    m_sendRing->spaceSignal.fetch_add(1);   // wake this side's writer, which is the only thread waiting on the signal
+    WakeSignal(m_sendRing->spaceSignal);
+}
+
+void
+SharedMemoryTransport::Map(int fd, size_t size)
+{
+    void * address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED)
+    {
+        NS_FATAL_ERROR("ERROR: SharedMemoryTransport failed to map " << size << " bytes of shared memory");
+    }
+    m_segment = static_cast<Segment *>(address);
+    m_mappedSize = size;
+}
+
+bool
+SharedMemoryTransport::IsPeerClosed() const
+{
+    const std::atomic<uint32_t> & state = m_isServer ? m_segment->clientState : m_segment->serverState;
+    return state.load() == PEER_STATE::CLOSED || m_peerExited.load(std::memory_order_relaxed);
+}
+
+void
+SharedMemoryTransport::CheckPeerExited()
+{
+    pid_t pid = m_isServer ? m_segment->clientPid.load() : m_segment->serverPid.load();
+    if (kill(pid, 0) == -1 && errno == ESRCH)
+    {
+        NS_LOG_WARN("WARNING: SharedMemoryTransport peer process " << pid << " exited without closing");
+        m_peerExited.store(true, std::memory_order_relaxed);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,150 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#ifndef SHARED_MEMORY_TRANSPORT_H
+#define SHARED_MEMORY_TRANSPORT_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "gateway-transport.h"
+
+namespace ns3
+{
+
+/**
+ * A transport over a pair of single-producer/single-consumer byte rings in POSIX shared memory, for a server that runs
+ * on the same host as ns-3.
+ *
+ * The server creates the shared memory object (see SharedMemoryTransport::Listen) and the client opens it by name (see
+ * SharedMemoryTransport::Connect). Each direction has its own ring, so sending and receiving never contend. Data is
+ * copied directly between the caller's buffer and the ring, without system calls, and a side that waits for data or
+ * free space sleeps on a futex that the other side only wakes if it is waiting. On platforms without futexes, a waiting
+ * side polls instead.
+ *
+ * The name of the shared memory object is removed once the client connects, so the object is freed when both sides
+ * close the transport. SharedMemoryTransport::Close must not be called while another thread is sending or receiving.
+ */
+class SharedMemoryTransport : public GatewayTransport
+{
+    public:
+        SharedMemoryTransport();
+        ~SharedMemoryTransport() override;
+
+        /**
+         * @brief Open the shared memory object created by a server (client side).
+         *
+         * Exceptions:
+         *  1) the transport must not already be connected.
+         *  2) a shared memory object that does not exist, is not a transport, or already has a client will cause a
+         *     fatal error.
+         *
+         * @param name the name of the shared memory object (for example, "/ns3-cosim")
+         */
+        void Connect(const std::string & name);
+
+        /**
+         * @brief Create a shared memory object, and block until one client opens it (server side).
+         *
+         * This is equivalent to SharedMemoryTransport::Listen followed by SharedMemoryTransport::Accept.
+         *
+         * @param name the name of the shared memory object (for example, "/ns3-cosim")
+         * @param capacity the size in bytes of the ring used for each direction (default: 1 MiB)
+         */
+        void Accept(const std::string & name, uint32_t capacity = 1 << 20);
+
+        /**
+         * @brief Create a shared memory object without waiting for a client (server side).
+         *
+         * A client can open the object as soon as this function returns. An existing object with the same name is
+         * replaced, and the name is removed once a client opens the object or the transport is closed.
+         *
+         * Exceptions:
+         *  1) the transport must not already be connected or listening.
+         *  2) the capacity must be a power of 2.
+         *  3) failing to create the shared memory object will cause a fatal error.
+         *
+         * @param name the name of the shared memory object (for example, "/ns3-cosim")
+         * @param capacity the size in bytes of the ring used for each direction (default: 1 MiB)
+         */
+        void Listen(const std::string & name, uint32_t capacity = 1 << 20);
+
+        /**
+         * @brief Block until one client opens the object created by SharedMemoryTransport::Listen (server side).
+         *
+         * Exceptions:
+         *  1) SharedMemoryTransport::Listen must be called first.
+         */
+        void Accept();
+
+        ssize_t Receive(char * data, size_t size) override;
+        bool Send(const char * data, size_t size) override;
+        void Close() override;
+        void Shutdown() override;
+    private:
+        struct Ring;    //!< The shared state of one direction (defined in the source file)
+        struct Segment; //!< The layout of the start of the shared memory object (defined in the source file)
+
+        /**
+         * @brief Map an open shared memory object into memory.
+         * @param fd the file descriptor of the shared memory object, which is closed by this function
+         * @param size the size of the shared memory object
+         */
+        void Map(int fd, size_t size);
+
+        /**
+         * @brief Check if the other side closed the transport or exited.
+         * @return true if the other side can no longer send or receive data
+         */
+        bool IsPeerClosed() const;
+
+        /**
+         * @brief Check if the other side's process still exists, after a wait timed out.
+         */
+        void CheckPeerExited();
+
+        Segment * m_segment;    //!< The mapped shared memory object, or nullptr
+        size_t m_mappedSize;    //!< The size of the mapping
+        bool m_isServer;        //!< True for the side that called SharedMemoryTransport::Listen
+        std::string m_name;     //!< The name of the shared memory object until a client opens it (server side)
+        Ring * m_sendRing;      //!< The ring written by this side
+        Ring * m_receiveRing;   //!< The ring read by this side
+        char * m_sendData;      //!< The data of m_sendRing
+        char * m_receiveData;   //!< The data of m_receiveRing
+        std::atomic<bool> m_peerExited; //!< True once the other side's process no longer exists
+        std::atomic<bool> m_shutdown;   //!< True once SharedMemoryTransport::Shutdown is called
+};
+
+} // namespace ns3
+
+#endif /* SHARED_MEMORY_TRANSPORT_H */
@@ -0,0 +1,166 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * A bounded, lock-free queue for exactly one producer thread and one consumer thread.
+ *
+ * SpscQueue::Push must only be called by the producer thread, and SpscQueue::Pop must only be called by the consumer
+ * thread. Neither function blocks: Push returns false if the queue is full, and Pop returns false if it is empty.
+ *
+ * Elements are swapped in and out of pre-allocated slots. Pop leaves the consumer's previous value in the slot, and
+ * Push later returns that value to the producer. For an element type that owns memory (such as std::string), this
+ * recycles buffers from the consumer back to the producer without any memory allocation.
+ *
+ * @tparam T the element type, which must be default constructible and swappable
+ */
+template <typename T>
+class SpscQueue
+{
+    public:
+        /**
+         * @brief Create an empty queue.
+         * @param capacity the maximum number of elements (rounded up to a power of 2)
+         */
+        explicit SpscQueue(size_t capacity);
+
+        /**
+         * @brief Add an element to the back of the queue (producer thread only).
+         * @param value the element to add, which is swapped with a value previously left in the slot by Pop
+         *              (unchanged on failure)
+         * @return false if the queue is full
+         */
+        bool Push(T & value);
+
+        /**
+         * @brief Remove the element at the front of the queue (consumer thread only).
+         * @param value the removed element, whose previous value is left in the slot for re-use by Push
+         *              (unchanged on failure)
+         * @return false if the queue is empty
+         */
+        bool Pop(T & value);
+
+        /**
+         * @brief Check if the queue is empty.
+         *
+         * The result is exact when called by the consumer thread and there are no concurrent calls to Push.
+         *
+         * @return true if the queue has no elements
+         */
+        bool IsEmpty() const;
+    private:
+        static const size_t CACHE_LINE_SIZE = 64; //!< Alignment that keeps the indices on separate cache lines
+
+        std::vector<T> m_slots;     //!< The queue elements, indexed by (position & m_mask)
+        size_t m_mask;              //!< The number of slots minus 1
+
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head; //!< The position of the next element to pop
+        size_t m_tailCache;         //!< The consumer's most recent copy of m_tail
+
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail; //!< The position of the next element to push
+        size_t m_headCache;         //!< The producer's most recent copy of m_head
+};
+
+/* ========== TEMPLATE IMPLEMENTATION ======================================= */
+
+template <typename T>
+SpscQueue<T>::SpscQueue(size_t capacity):
+    m_head(0),
+    m_tailCache(0),
+    m_tail(0),
+    m_headCache(0)
+{
+    size_t size = 1;
+    while (size < capacity)
+    {
+        size *= 2;
+    }
+    m_slots.resize(size);
+    m_mask = size - 1;
+}
+
+template <typename T>
+bool
+SpscQueue<T>::Push(T & value)
+{
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_headCache > m_mask) // appears full, so refresh the copy of the consumer position
+    {
+        m_headCache = m_head.load(std::memory_order_acquire);
+        if (tail - m_headCache > m_mask)
+        {
+            return false;
+        }
+    }
+    std::swap(value, m_slots[tail & m_mask]);
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool
+SpscQueue<T>::Pop(T & value)
+{
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tailCache) // appears empty, so refresh the copy of the producer position
+    {
+        m_tailCache = m_tail.load(std::memory_order_acquire);
+        if (head == m_tailCache)
+        {
+            return false;
+        }
+    }
+    std::swap(value, m_slots[head & m_mask]);
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool
+SpscQueue<T>::IsEmpty() const
+{
+    return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+}
+
+} // namespace ns3
+
+#endif /* SPSC_QUEUE_H */
@@ -0,0 +1,209 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#ifndef STAGED_GATEWAY_H
+#define STAGED_GATEWAY_H
+
+#include <string>
+
+#include "ns3/core-module.h"
+
+#include "gateway.h"
+#include "gateway-message.h"
+#include "spsc-queue.h"
+
+namespace ns3
+{
+
+/**
+ * A gateway that decodes each received message into a user-defined staged struct on the thread that receives it.
+ *
+ * Decoding (such as converting the fields into arrays of positions, velocities, and flags) then overlaps with the
+ * execution of ns-3 events for the previous message, and the main ns-3 thread only applies the decoded data. Each
+ * message is split and decoded by StagedGateway::DoDecode on the receiving thread (see Gateway::SetReadThreadParsing,
+ * which is enabled by the constructor), and the staged struct is passed to StagedGateway::DoInitializeStaged or
+ * StagedGateway::DoUpdateStaged on the main thread, in the order the messages were received.
+ *
+ * Staged structs are passed between the threads by swapping them through a bounded queue, so the struct being applied
+ * and the struct being decoded are never the same object, and their buffers (such as std::vector capacity) are re-used
+ * for later messages without memory allocations. Each struct therefore still contains the data of an older message
+ * when it is passed to StagedGateway::DoDecode, which must overwrite every member it uses. At most
+ * STAGE_QUEUE_CAPACITY decoded messages can wait to be applied, after which the receiving thread waits (or a reactor
+ * stops receiving) until the main thread applies one.
+ *
+ * For example, a gateway that stages the positions of its nodes:
+ *
+ *      struct Positions { std::vector<Vector> position; };
+ *
+ *      class PositionGateway : public StagedGateway<Positions>
+ *      {
+ *          void DoDecode(const GatewayMessage & message, Positions & stage) override
+ *          {
+ *              stage.position.resize(message.GetSize() / 3);
+ *              for (uint32_t i = 0; i < stage.position.size(); i++) { message.GetVector(3 * i, stage.position[i]); }
+ *          }
+ *          void DoUpdateStaged(const Positions & stage) override { ... }
+ *      };
+ *
+ * @tparam STAGE the staged struct, which must be default constructible and swappable
+ */
+template <typename STAGE>
+class StagedGateway : public Gateway
+{
+    public:
+        /**
+         * @brief Construct a new gateway instance with the TEXT framing (see Gateway::Gateway).
+         * @param dataSize the number of values the gateway sends to its server
+         * @param delimiterField the delimiter used between values within one message (default: " ")
+         * @param delimiterMessage the delimiter used to indicate the end of a message (default: "\r\n")
+         */
+        StagedGateway(uint32_t dataSize,
+                      const std::string & delimiterField = " ",
+                      const std::string & delimiterMessage = "\r\n");
+
+        /**
+         * @brief Construct a new gateway instance with the specified message framing (see Gateway::Gateway).
+         * @param dataSize the number of values the gateway sends to its server
+         * @param framing the format of the messages exchanged with the server
+         */
+        StagedGateway(uint32_t dataSize, FRAMING framing);
+    private:
+        static const size_t STAGE_QUEUE_CAPACITY = 1024;    //!< The maximum number of decoded messages in m_stageQueue
+
+        bool DoStage(const GatewayMessage & receivedData) final;
+        void DoInitialize(const GatewayMessage & receivedData) final;
+        void DoUpdate(const GatewayMessage & receivedData) final;
+
+        /**
+         * @brief Take the staged struct of the next processed message from m_stageQueue into m_applying.
+         *
+         * Exceptions:
+         *  1) every processed message must have been decoded (Gateway::SetReadThreadParsing must remain enabled).
+         */
+        void TakeStage();
+
+        /**
+         * @brief Callback on the thread that receives messages, to decode a message into a staged struct.
+         *
+         * This executes concurrently with ns-3 events, so it must not access the simulation or any member used by
+         * the main thread. A message that cannot be decoded can be reported with NS_FATAL_ERROR.
+         *
+         * @param receivedData the received message content excluding the header/timestamp
+         * @param stage the staged struct to overwrite, which contains the data of an older message
+         */
+        virtual void DoDecode(const GatewayMessage & receivedData, STAGE & stage) = 0;
+
+        /**
+         * @brief Callback to apply the staged struct of the first message received from the server.
+         * @param stage the decoded message, which remains valid until the next message is processed
+         */
+        virtual void DoInitializeStaged(const STAGE & stage) = 0;
+
+        /**
+         * @brief Callback to apply the staged struct of a message received from the server.
+         * @param stage the decoded message, which remains valid until the next message is processed
+         */
+        virtual void DoUpdateStaged(const STAGE & stage) = 0;
+
+        SpscQueue<STAGE> m_stageQueue;  //!< Staged structs passed from the receiving thread to the main thread
+        STAGE m_decoding;               //!< The struct being decoded (receiving thread only)
+        bool m_decoded;                 //!< True if m_decoding holds a message that did not fit in m_stageQueue
+        STAGE m_applying;               //!< The struct being applied (main thread only)
+};
+
+template <typename STAGE>
+StagedGateway<STAGE>::StagedGateway(uint32_t dataSize,
+                                    const std::string & delimiterField,
+                                    const std::string & delimiterMessage):
+    Gateway(dataSize, delimiterField, delimiterMessage),
+    m_stageQueue(STAGE_QUEUE_CAPACITY),
+    m_decoded(false)
+{
+    SetReadThreadParsing(true);
+}
+
+template <typename STAGE>
+StagedGateway<STAGE>::StagedGateway(uint32_t dataSize, FRAMING framing):
+    Gateway(dataSize, framing),
+    m_stageQueue(STAGE_QUEUE_CAPACITY),
+    m_decoded(false)
+{
+    SetReadThreadParsing(true);
+}
+
+template <typename STAGE>
+bool
+StagedGateway<STAGE>::DoStage(const GatewayMessage & receivedData)
+{
+    if (!m_decoded)
+    {
+        DoDecode(receivedData, m_decoding);
+        m_decoded = true;
+    }
+    if (!m_stageQueue.Push(m_decoding)) // m_decoding now holds a struct released by the main thread
+    {
+        return false; // the queue is full, so Gateway::ForwardReceived calls this function again
+    }
+    m_decoded = false;
+    return true;
+}
+
+template <typename STAGE>
+void
+StagedGateway<STAGE>::DoInitialize(const GatewayMessage & /* receivedData */)
+{
+    TakeStage();
+    DoInitializeStaged(m_applying);
+}
+
+template <typename STAGE>
+void
+StagedGateway<STAGE>::DoUpdate(const GatewayMessage & /* receivedData */)
+{
+    TakeStage();
+    DoUpdateStaged(m_applying);
+}
+
+template <typename STAGE>
+void
+StagedGateway<STAGE>::TakeStage()
+{
+    if (!m_stageQueue.Pop(m_applying)) // m_applying's previous struct is returned to the receiving thread
+    {
+        NS_FATAL_ERROR("ERROR: StagedGateway processed a message that was not decoded by the receiving thread");
+    }
+    ResumeReceiving(); // a reactor may have stopped receiving because the queue was full
+}
+
+} // namespace ns3
+
+#endif /* STAGED_GATEWAY_H */
@@ -0,0 +1,516 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#ifndef TYPED_GATEWAY_H
+#define TYPED_GATEWAY_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+#include "gateway.h"
+#include "gateway-message.h"
+
+namespace ns3
+{
+
+/**
+ * Converts one C++ type to and from consecutive message fields (used by TypedGateway).
+ *
+ * Specializations are provided for integral types (including bool, received as an integer that is non-zero if true),
+ * floating point types, and Vector (three consecutive fields x, y, z). Other types can be supported by defining a
+ * specialization with the same members.
+ *
+ * @tparam T the C++ type of the value
+ */
+template <typename T, typename Enable = void>
+struct GatewayField;
+
+template <typename T>
+struct GatewayField<T, typename std::enable_if<std::is_integral<T>::value>::type>
+{
+    static constexpr uint32_t SIZE = 1; //!< The number of message fields used by one value
+
+    /**
+     * @brief Convert the fields starting at index to a value.
+     * @param message the received message
+     * @param index the index of the first field
+     * @param value the converted value
+     * @return false if a field is missing, is not a number, or is out of range for the type
+     */
+    static bool Decode(const GatewayMessage & message, uint32_t index, T & value)
+    {
+        int64_t result;
+        if (!message.GetInt(index, result))
+        {
+            return false;
+        }
+        if constexpr (std::is_same<T, bool>::value)
+        {
+            value = (result != 0);
+            return true;
+        }
+        else if constexpr (std::is_unsigned<T>::value)
+        {
+            if (result < 0 || static_cast<uint64_t>(result) > std::numeric_limits<T>::max())
+            {
+                return false;
+            }
+        }
+        else if (result < std::numeric_limits<T>::min() || result > std::numeric_limits<T>::max())
+        {
+            return false;
+        }
+        value = static_cast<T>(result);
+        return true;
+    }
+
+    /**
+     * @brief Set the response elements starting at index to a value.
+     * @param gateway the gateway that sends the response
+     * @param index the index of the first element
+     * @param value the value to set
+     */
+    static void Encode(Gateway & gateway, uint32_t index, T value)
+    {
+        gateway.SetValue(index, value);
+    }
+};
+
+template <typename T>
+struct GatewayField<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+{
+    static constexpr uint32_t SIZE = 1; //!< The number of message fields used by one value
+
+    static bool Decode(const GatewayMessage & message, uint32_t index, T & value)
+    {
+        double result;
+        if (!message.GetDouble(index, result))
+        {
+            return false;
+        }
+        value = static_cast<T>(result);
+        return true;
+    }
+
+    static void Encode(Gateway & gateway, uint32_t index, T value)
+    {
+        gateway.SetValue(index, static_cast<double>(value));
+    }
+};
+
+template <>
+struct GatewayField<Vector>
+{
+    static constexpr uint32_t SIZE = 3; //!< The number of message fields used by one value
+
+    static bool Decode(const GatewayMessage & message, uint32_t index, Vector & value)
+    {
+        return message.GetVector(index, value);
+    }
+
+    static void Encode(Gateway & gateway, uint32_t index, const Vector & value)
+    {
+        gateway.SetValue(index, value.x);
+        gateway.SetValue(index + 1, value.y);
+        gateway.SetValue(index + 2, value.z);
+    }
+};
+
+/**
+ * The layout of one record received from the server by a TypedGateway.
+ *
+ * A record is a std::tuple of the field types, decoded from consecutive message fields in order. For example,
+ * Record<Vector, Vector, bool> is decoded from 7 fields: a position (x, y, z), a velocity (x, y, z), and a flag.
+ *
+ * @tparam FIELDS the type of each field (see GatewayField)
+ */
+template <typename... FIELDS>
+struct Record
+{
+    using Type = std::tuple<FIELDS...>;                             //!< The decoded record
+    static constexpr uint32_t SIZE = (0 + ... + GatewayField<FIELDS>::SIZE);   //!< The number of message fields
+    static constexpr bool SPARSE = false;                           //!< True if only changed fields are received
+};
+
+/**
+ * The layout of one record received from the server by a TypedGateway, where each message only contains the records
+ * and fields that changed.
+ *
+ * A message is a sequence of entries with the format "key, mask, values", where:
+ *  1) key is the index of the record as an integer (for example, the index of a node in a NodeContainer)
+ *  2) mask is an integer where bit i is set if the entry contains a value for the field i of the record
+ *  3) values are the fields whose bit is set, in order, each decoded from its GatewayField::SIZE message fields
+ *
+ * With the BINARY framing, key and mask are INT32 or INT64 fields. For example, with SparseRecord<Vector, Vector,
+ * bool>, the entry "12 5 1.5 2.5 0 1" sets the position (bit 0) and the flag (bit 2) of the record 12, and keeps its
+ * velocity. Records and fields that are not in a message keep their previous values (initially value-initialized), so
+ * a flag must be explicitly cleared. The records grow to include the largest received key, so keys should be small
+ * consecutive indices. Keys are limited to the maximum number of records (see TypedGateway::SetMaxRecords), so a
+ * corrupt key cannot allocate an unbounded number of records.
+ *
+ * @tparam FIELDS the type of each field (see GatewayField)
+ */
+template <typename... FIELDS>
+struct SparseRecord
+{
+    static_assert(sizeof...(FIELDS) <= 31, "a sparse record must contain at most 31 fields (one bit of the mask each)");
+
+    using Type = std::tuple<FIELDS...>;                             //!< The decoded record
+    static constexpr uint32_t SIZE = (0 + ... + GatewayField<FIELDS>::SIZE);   //!< The number of message fields
+    static constexpr bool SPARSE = true;                            //!< True if only changed fields are received
+};
+
+/**
+ * The layout of one record sent to the server by a TypedGateway (see Record).
+ *
+ * @tparam FIELDS the type of each field (see GatewayField)
+ */
+template <typename... FIELDS>
+struct Response
+{
+    using Type = std::tuple<FIELDS...>;                             //!< The record to encode
+    static constexpr uint32_t SIZE = (0 + ... + GatewayField<FIELDS>::SIZE);   //!< The number of response elements
+};
+
+/**
+ * A gateway whose messages are arrays of fixed-layout records, where the layout is checked at compile time.
+ *
+ * Each received message is decoded directly into a contiguous std::vector of records, which is passed to
+ * TypedGateway::DoInitializeRecords and TypedGateway::DoUpdateRecords. The message size is checked once per message
+ * (it must be a whole number of records), and each field is converted by its GatewayField specialization without
+ * virtual function calls or string copies. The records are re-used between messages to avoid memory allocations.
+ * Responses are encoded from an array of records using TypedGateway::SendResponse.
+ *
+ * With a SparseRecord layout, each message only updates the records it contains, so the cost of decoding a message
+ * grows with the number of changes rather than with the number of records. The records then persist between messages,
+ * and TypedGateway::GetUpdatedRecords lists the records updated by the most recent message.
+ *
+ * For example, a gateway that receives a position, velocity, and broadcast flag for each vehicle, and responds with a
+ * counter for each vehicle:
+ *
+ *      class VehicleGateway : public TypedGateway<Record<Vector, Vector, bool>, Response<uint32_t>>
+ *      {
+ *          void DoUpdateRecords(const std::vector<RecordType> & records) override
+ *          {
+ *              for (const auto & [position, velocity, broadcast] : records) { ... }
+ *              SendResponse(m_counts); // a std::vector<ResponseType> with one record per vehicle
+ *          }
+ *      };
+ *
+ * @tparam RECORD the layout of received records (see Record)
+ * @tparam RESPONSE the layout of sent records (see Response)
+ */
+template <typename RECORD, typename RESPONSE>
+class TypedGateway : public Gateway
+{
+    static_assert(RECORD::SIZE > 0, "a received record must contain at least one field");
+
+    public:
+        using RecordType = typename RECORD::Type;       //!< One decoded record
+        using ResponseType = typename RESPONSE::Type;   //!< One record to encode in a response
+
+        /**
+         * @brief Construct a new gateway instance with the TEXT framing (see Gateway::Gateway).
+         * @param responseCount the number of records the gateway sends to its server
+         * @param delimiterField the delimiter used between values within one message (default: " ")
+         * @param delimiterMessage the delimiter used to indicate the end of a message (default: "\r\n")
+         */
+        TypedGateway(uint32_t responseCount,
+                     const std::string & delimiterField = " ",
+                     const std::string & delimiterMessage = "\r\n");
+
+        /**
+         * @brief Construct a new gateway instance with the specified message framing (see Gateway::Gateway).
+         * @param responseCount the number of records the gateway sends to its server
+         * @param framing the format of the messages exchanged with the server
+         */
+        TypedGateway(uint32_t responseCount, FRAMING framing);
+
+        /**
+         * @brief Set the response values and send them to the server (see Gateway::SendResponse).
+         *
+         * Exceptions:
+         *  1) the number of records must equal the responseCount specified in the constructor.
+         *  2) the function is called when the gateway is in a state other than CONNECTED.
+         *
+         * @param responses the records to send
+         */
+        void SendResponse(const std::vector<ResponseType> & responses);
+        using Gateway::SendResponse;
+
+        /**
+         * @brief Get the records updated by the most recent message.
+         *
+         * With a Record layout, every record is updated by each message. With a SparseRecord layout, each record
+         * contained in the message is listed once, in the order in which it was first received.
+         *
+         * @return the indices of the updated records, which remain valid until the next message is received
+         */
+        const std::vector<uint32_t> & GetUpdatedRecords() const;
+
+        /**
+         * @brief Ignore the fields after the last whole record of a message, instead of causing a fatal error.
+         *
+         * This keeps the behavior of a gateway that only read the fields it expected (Record layout only).
+         *
+         * @param ignore true to ignore trailing fields (default: false)
+         */
+        void SetIgnoreTrailingFields(bool ignore);
+
+        /**
+         * @brief Set the maximum number of records, so that each received key must be less than count (SparseRecord
+         * layout only).
+         *
+         * @param count the maximum number of records (default: the responseCount specified in the constructor)
+         */
+        void SetMaxRecords(uint32_t count);
+    private:
+        void DoInitialize(const GatewayMessage & receivedData) final;
+        void DoUpdate(const GatewayMessage & receivedData) final;
+
+        /**
+         * @brief Decode every record in a received message into m_records.
+         *
+         * Exceptions:
+         *  1) the message size must be a whole number of records, unless trailing fields are ignored (Record layout
+         *     only).
+         *  2) each key must be a non-negative integer less than the maximum number of records, and each mask must
+         *     only contain bits for fields of the record (SparseRecord layout only).
+         *  3) each field must be convertible to its type.
+         *
+         * @param receivedData the received message content excluding the header/timestamp
+         */
+        void Decode(const GatewayMessage & receivedData);
+        void DecodeSparse(const GatewayMessage & receivedData);
+
+        /**
+         * @brief Callback to process the records of the first message received from the server.
+         * @param records the decoded records, which remain valid until the next message is received
+         */
+        virtual void DoInitializeRecords(const std::vector<RecordType> & records) = 0;
+
+        /**
+         * @brief Callback to process the records of a message received from the server.
+         * @param records the decoded records, which remain valid until the next message is received
+         */
+        virtual void DoUpdateRecords(const std::vector<RecordType> & records) = 0;
+
+        std::vector<RecordType> m_records;  //!< The records decoded from the most recent message (or all messages)
+        std::vector<uint32_t> m_updatedRecords; //!< The indices of the records updated by the most recent message
+        std::vector<bool> m_updated;        //!< True for each record in m_updatedRecords (SparseRecord layout only)
+        uint32_t m_responseCount;           //!< The number of records sent in each response
+        bool m_ignoreTrailingFields;        //!< True if fields after the last whole record are ignored
+        uint32_t m_maxRecords;              //!< The maximum number of records (SparseRecord layout only)
+};
+
+template <typename RECORD, typename RESPONSE>
+TypedGateway<RECORD, RESPONSE>::TypedGateway(uint32_t responseCount,
+                                             const std::string & delimiterField,
+                                             const std::string & delimiterMessage):
+    Gateway(responseCount * RESPONSE::SIZE, delimiterField, delimiterMessage),
+    m_responseCount(responseCount),
+    m_ignoreTrailingFields(false),
+    m_maxRecords(responseCount)
+{
+    // do nothing
+}
+
+template <typename RECORD, typename RESPONSE>
+TypedGateway<RECORD, RESPONSE>::TypedGateway(uint32_t responseCount, FRAMING framing):
+    Gateway(responseCount * RESPONSE::SIZE, framing),
+    m_responseCount(responseCount),
+    m_ignoreTrailingFields(false),
+    m_maxRecords(responseCount)
+{
+    // do nothing
+}
+
+template <typename RECORD, typename RESPONSE>
+void
+TypedGateway<RECORD, RESPONSE>::SendResponse(const std::vector<ResponseType> & responses)
+{
+    if (responses.size() != m_responseCount)
+    {
+        NS_FATAL_ERROR("ERROR: TypedGateway::SendResponse called with " << responses.size() << " records instead of "
+            << m_responseCount);
+    }
+
+    uint32_t index = 0;
+    for (const ResponseType & response : responses)
+    {
+        std::apply([this, &index](const auto &... fields) {
+            ((GatewayField<std::decay_t<decltype(fields)>>::Encode(*this, index, fields),
+              index += GatewayField<std::decay_t<decltype(fields)>>::SIZE), ...);
+        }, response);
+    }
+    Gateway::SendResponse();
+}
+
+template <typename RECORD, typename RESPONSE>
+const std::vector<uint32_t> &
+TypedGateway<RECORD, RESPONSE>::GetUpdatedRecords() const
+{
+    return m_updatedRecords;
+}
+
+template <typename RECORD, typename RESPONSE>
+void
+TypedGateway<RECORD, RESPONSE>::SetIgnoreTrailingFields(bool ignore)
+{
+    m_ignoreTrailingFields = ignore;
+}
+
+template <typename RECORD, typename RESPONSE>
+void
+TypedGateway<RECORD, RESPONSE>::SetMaxRecords(uint32_t count)
+{
+    m_maxRecords = count;
+}
+
+template <typename RECORD, typename RESPONSE>
+void
+TypedGateway<RECORD, RESPONSE>::DoInitialize(const GatewayMessage & receivedData)
+{
+    Decode(receivedData);
+    DoInitializeRecords(m_records);
+}
+
+template <typename RECORD, typename RESPONSE>
+void
+TypedGateway<RECORD, RESPONSE>::DoUpdate(const GatewayMessage & receivedData)
+{
+    Decode(receivedData);
+    DoUpdateRecords(m_records);
+}
+
+template <typename RECORD, typename RESPONSE>
+void
+TypedGateway<RECORD, RESPONSE>::Decode(const GatewayMessage & receivedData)
+{
+    if constexpr (RECORD::SPARSE)
+    {
+        DecodeSparse(receivedData);
+        return;
+    }
+
+    if (receivedData.GetSize() % RECORD::SIZE != 0 && !m_ignoreTrailingFields)
+    {
+        NS_FATAL_ERROR("ERROR: received " << receivedData.GetSize() << " fields, which is not a multiple of the "
+            << RECORD::SIZE << " fields in a record");
+    }
+    m_records.resize(receivedData.GetSize() / RECORD::SIZE);
+
+    uint32_t index = 0;
+    for (RecordType & record : m_records)
+    {
+        // decode each field in order, stopping at the first field that cannot be converted
+        bool decoded = std::apply([&receivedData, &index](auto &... fields) {
+            return ((GatewayField<std::decay_t<decltype(fields)>>::Decode(receivedData, index, fields)
+                     && ((index += GatewayField<std::decay_t<decltype(fields)>>::SIZE), true)) && ...);
+        }, record);
+        if (!decoded)
+        {
+            NS_FATAL_ERROR("ERROR: received field " << index << " cannot be converted to its record type");
+        }
+    }
+
+    // every record is updated (only re-numbered when the number of records changes)
+    while (m_updatedRecords.size() < m_records.size())
+    {
+        m_updatedRecords.push_back(m_updatedRecords.size());
+    }
+    m_updatedRecords.resize(m_records.size());
+}
+
+template <typename RECORD, typename RESPONSE>
+void
+TypedGateway<RECORD, RESPONSE>::DecodeSparse(const GatewayMessage & receivedData)
+{
+    // only reset the records updated by the previous message
+    for (uint32_t key : m_updatedRecords)
+    {
+        m_updated[key] = false;
+    }
+    m_updatedRecords.clear();
+
+    uint32_t index = 0;
+    while (index < receivedData.GetSize())
+    {
+        int64_t key;
+        int64_t mask;
+        if (!receivedData.GetInt(index, key) || !receivedData.GetInt(index + 1, mask)
+            || key < 0 || mask < 0 || (mask >> std::tuple_size<RecordType>::value) != 0)
+        {
+            NS_FATAL_ERROR("ERROR: received field " << index << " is not a valid record key and field mask");
+        }
+        if (key >= m_maxRecords)
+        {
+            NS_FATAL_ERROR("ERROR: received record key " << key << " (field " << index << ") exceeds the maximum of "
+                << m_maxRecords << " records");
+        }
+        index += 2;
+
+        if (static_cast<uint64_t>(key) >= m_records.size())
+        {
+            m_records.resize(key + 1);
+            m_updated.resize(key + 1, false);
+        }
+
+        // decode each field whose bit is set in order, stopping at the first field that cannot be converted
+        uint32_t bit = 0;
+        bool decoded = std::apply([&receivedData, &index, &bit, mask](auto &... fields) {
+            return ((((mask >> bit++) & 1) == 0
+                     || (GatewayField<std::decay_t<decltype(fields)>>::Decode(receivedData, index, fields)
+                         && ((index += GatewayField<std::decay_t<decltype(fields)>>::SIZE), true))) && ...);
+        }, m_records[key]);
+        if (!decoded)
+        {
+            NS_FATAL_ERROR("ERROR: received field " << index << " cannot be converted to its record type");
+        }
+
+        if (!m_updated[key])
+        {
+            m_updated[key] = true;
+            m_updatedRecords.push_back(key);
+        }
+    }
+}
+
+} // namespace ns3
+
+#endif /* TYPED_GATEWAY_H */
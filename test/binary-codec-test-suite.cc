@@ -0,0 +1,123 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <string>
+
+#include "ns3/test.h"
+
+#include "ns3/binary-codec.h"
+
+using namespace ns3;
+
+/* ========== ROUND TRIP ==================================================== */
+
+class BinaryCodecRoundTripTestCase : public TestCase
+{
+    public:
+        BinaryCodecRoundTripTestCase();
+    private:
+        void DoRun() override;
+};
+
+BinaryCodecRoundTripTestCase::BinaryCodecRoundTripTestCase():
+    TestCase("Check that BinaryEncoder and BinaryDecoder round-trip fields and reject partial data")
+{
+}
+
+void
+BinaryCodecRoundTripTestCase::DoRun()
+{
+    BinaryEncoder encoder;
+    encoder.AddInt32(-5);
+    encoder.AddInt64(int64_t(1) << 40);
+    encoder.AddDouble(1.5);
+    encoder.AddBytes(std::string("a b\0c", 5));
+    std::string message = encoder.Finish(10, 20);
+
+    int32_t seconds;
+    uint32_t nanoseconds;
+    uint32_t payloadSize;
+    NS_TEST_ASSERT_MSG_EQ(BinaryDecoder::ReadHeader(message.data(), message.size(), seconds, nanoseconds, payloadSize),
+                          true, "a complete header must be decoded");
+    NS_TEST_ASSERT_MSG_EQ(seconds, 10, "the header must contain the seconds");
+    NS_TEST_ASSERT_MSG_EQ(nanoseconds, 20, "the header must contain the nanoseconds");
+    NS_TEST_ASSERT_MSG_EQ(payloadSize, message.size() - BinaryEncoder::HEADER_SIZE, "the header must contain the size");
+    NS_TEST_ASSERT_MSG_EQ(BinaryDecoder::ReadHeader(message.data(), BinaryEncoder::HEADER_SIZE - 1, seconds,
+                                                    nanoseconds, payloadSize),
+                          false, "a partial header must not be decoded");
+
+    BinaryDecoder decoder(message.data() + BinaryEncoder::HEADER_SIZE, payloadSize);
+    int32_t int32Value;
+    int64_t int64Value;
+    double doubleValue;
+    std::string bytesValue;
+    NS_TEST_ASSERT_MSG_EQ(decoder.ReadDouble(doubleValue), false, "a field must not be read as another type");
+    NS_TEST_ASSERT_MSG_EQ(decoder.ReadInt32(int32Value), true, "a failed read must not advance the decoder");
+    NS_TEST_ASSERT_MSG_EQ(int32Value, -5, "an INT32 field must round-trip");
+    NS_TEST_ASSERT_MSG_EQ(decoder.ReadInt64(int64Value), true, "the INT64 field must be read");
+    NS_TEST_ASSERT_MSG_EQ(int64Value, int64_t(1) << 40, "an INT64 field must round-trip");
+    NS_TEST_ASSERT_MSG_EQ(decoder.ReadDouble(doubleValue), true, "the DOUBLE field must be read");
+    NS_TEST_ASSERT_MSG_EQ(doubleValue, 1.5, "a DOUBLE field must round-trip");
+    NS_TEST_ASSERT_MSG_EQ(decoder.ReadBytes(bytesValue), true, "the BYTES field must be read");
+    NS_TEST_ASSERT_MSG_EQ(bytesValue, std::string("a b\0c", 5), "a BYTES field must round-trip");
+    NS_TEST_ASSERT_MSG_EQ(decoder.IsEmpty(), true, "every field must be read");
+
+    // a truncated field is not read
+    BinaryDecoder truncated(message.data() + BinaryEncoder::HEADER_SIZE, payloadSize - 1);
+    truncated.ReadInt32(int32Value);
+    truncated.ReadInt64(int64Value);
+    truncated.ReadDouble(doubleValue);
+    NS_TEST_ASSERT_MSG_EQ(truncated.ReadBytes(bytesValue), false, "a truncated field must not be read");
+    NS_TEST_ASSERT_MSG_EQ(truncated.IsEmpty(), false, "a truncated field must not be consumed");
+
+    // the encoder is reused for the next message
+    encoder.Clear();
+    encoder.AddInt32(1);
+    NS_TEST_ASSERT_MSG_EQ(encoder.Finish(-1, 0).size(), BinaryEncoder::HEADER_SIZE + 5,
+                          "a cleared encoder must not keep the previous fields");
+}
+
+/* ========== TEST SUITE ==================================================== */
+
+class BinaryCodecTestSuite : public TestSuite
+{
+    public:
+        BinaryCodecTestSuite();
+};
+
+BinaryCodecTestSuite::BinaryCodecTestSuite():
+    TestSuite("ns3-cosim-binary-codec", Type::UNIT)
+{
+    AddTestCase(new BinaryCodecRoundTripTestCase());
+}
+
+static BinaryCodecTestSuite g_binaryCodecTestSuite; //!< The static instance that registers the test suite
@@ -0,0 +1,24 @@
+#! /usr/bin/env python3
+
+## A list of C++ examples to run in order to ensure that they remain
+## buildable and runnable over time.  Each tuple in the list contains
+##
+##     (example_name, do_run, do_valgrind_run).
+##
+## See test.py for more information.
+##
+## The examples that need a server (simple-gateway and simple-gateway-server) are not listed. The benchmarks are run
+## with small parameters, and without a TCP port, so they do not conflict with other processes.
+cpp_examples = [
+    ("gateway-queue-benchmark --messageCount=10000", "True", "False"),
+    ("gateway-benchmark --transports=unix,shm --framings=text,binary --fields=10 --nodes=10 --steps=100",
+     "True", "False"),
+]
+
+## A list of Python examples to run in order to ensure that they remain
+## runnable over time.  Each tuple in the list contains
+##
+##     (example_name, do_run).
+##
+## See test.py for more information.
+python_examples = []
@@ -0,0 +1,248 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include "ns3/test.h"
+
+#include "ns3/boolean.h"
+#include "ns3/core-module.h"
+#include "ns3/double.h"
+#include "ns3/network-module.h"
+
+#include "ns3/external-mobility-fleet.h"
+#include "ns3/external-mobility-model.h"
+
+using namespace ns3;
+
+namespace
+{
+
+// count the CourseChange notifications of the connected mobility models
+class CourseChangeCounter
+{
+    public:
+        void Count(Ptr<const MobilityModel> /* model */)
+        {
+            m_count++;
+        }
+
+        uint32_t m_count = 0;   //!< The number of notifications
+};
+
+} // namespace
+
+/* ========== EXTERNAL MOBILITY FLEET ======================================= */
+
+class ExternalMobilityFleetTestCase : public TestCase
+{
+    public:
+        ExternalMobilityFleetTestCase();
+    private:
+        void DoRun() override;
+};
+
+ExternalMobilityFleetTestCase::ExternalMobilityFleetTestCase():
+    TestCase("Check that ExternalMobilityFleet only updates and notifies the nodes that changed")
+{
+}
+
+void
+ExternalMobilityFleetTestCase::DoRun()
+{
+    CourseChangeCounter counter;
+    NodeContainer nodes;
+    nodes.Create(3);
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        Ptr<ExternalMobilityModel> model = CreateObject<ExternalMobilityModel>();
+        model->TraceConnectWithoutContext("CourseChange", MakeCallback(&CourseChangeCounter::Count, &counter));
+        nodes.Get(i)->AggregateObject(model);
+    }
+    ExternalMobilityFleet fleet(nodes);
+    NS_TEST_ASSERT_MSG_EQ(fleet.GetN(), 3, "the fleet must contain every node");
+
+    // node 1 keeps its initial position and velocity
+    std::vector<Vector> positions = {Vector(1, 2, 3), Vector(0, 0, 0), Vector(4, 5, 6)};
+    std::vector<Vector> velocities = {Vector(1, 0, 0), Vector(0, 0, 0), Vector(0, 1, 0)};
+    NS_TEST_ASSERT_MSG_EQ(fleet.Update(positions, velocities), 2, "only the changed nodes must be updated");
+    NS_TEST_ASSERT_MSG_EQ(counter.m_count, 2, "each changed node must notify one course change");
+    NS_TEST_ASSERT_MSG_EQ(fleet.Get(2)->GetPosition(), Vector(4, 5, 6), "the position must be applied");
+    NS_TEST_ASSERT_MSG_EQ(fleet.Get(2)->GetVelocity(), Vector(0, 1, 0), "the velocity must be applied");
+
+    NS_TEST_ASSERT_MSG_EQ(fleet.Update(positions, velocities), 0, "repeated values must not update any node");
+    NS_TEST_ASSERT_MSG_EQ(counter.m_count, 2, "repeated values must not notify a course change");
+
+    // only the listed nodes are compared, so the change to node 1 is ignored
+    positions[1] = Vector(7, 7, 7);
+    velocities[2] = Vector(0, 2, 0);
+    NS_TEST_ASSERT_MSG_EQ(fleet.Update({2, 0}, positions, velocities), 1, "only the listed nodes must be updated");
+    NS_TEST_ASSERT_MSG_EQ(fleet.Get(1)->GetPosition(), Vector(0, 0, 0), "an unlisted node must not be updated");
+    NS_TEST_ASSERT_MSG_EQ(counter.m_count, 3, "the changed listed node must notify a course change");
+
+    NS_TEST_ASSERT_MSG_EQ(fleet.Update(1, Vector(7, 7, 7), Vector(0, 0, 1)), true, "one node must be updated");
+    NS_TEST_ASSERT_MSG_EQ(fleet.Get(1)->GetVelocity(), Vector(0, 0, 1), "the velocity of one node must be applied");
+    NS_TEST_ASSERT_MSG_EQ(counter.m_count, 4, "a position and velocity change must notify one course change");
+}
+
+/* ========== DEAD RECKONING ================================================ */
+
+class DeadReckoningTestCase : public TestCase
+{
+    public:
+        DeadReckoningTestCase();
+    private:
+        void DoRun() override;
+};
+
+DeadReckoningTestCase::DeadReckoningTestCase():
+    TestCase("Check that dead reckoning extrapolates between updates, and that small corrections do not notify")
+{
+}
+
+void
+DeadReckoningTestCase::DoRun()
+{
+    CourseChangeCounter counter;
+    Ptr<ExternalMobilityModel> model = CreateObject<ExternalMobilityModel>();
+    model->SetAttribute("ResyncThreshold", DoubleValue(1));
+    model->TraceConnectWithoutContext("CourseChange", MakeCallback(&CourseChangeCounter::Count, &counter));
+    Ptr<ExternalMobilityModel> constant = CreateObject<ExternalMobilityModel>();
+
+    NodeContainer nodes;
+    nodes.Create(1);
+    nodes.Get(0)->AggregateObject(model);
+    ExternalMobilityFleet fleet(nodes);
+    model->SetAttribute("DeadReckoning", BooleanValue(true)); // enabled after the node was added to the fleet
+
+    // each scheduled event records the state of the models at its time
+    std::vector<bool> notified;
+    std::vector<Vector> positions;
+    std::vector<Vector> velocities;
+    std::vector<uint32_t> counts;
+    Simulator::Schedule(Seconds(0), [&] {
+        notified.push_back(model->SetPositionAndVelocity(Vector(0, 0, 0), Vector(1, 0, 0)));
+        model->SetAcceleration(Vector(0, 2, 0));
+        constant->SetPositionAndVelocity(Vector(0, 0, 0), Vector(1, 0, 0));
+        counts.push_back(counter.m_count);
+    });
+    Simulator::Schedule(Seconds(2), [&] {
+        positions.push_back(model->GetPosition());
+        velocities.push_back(model->GetVelocity());
+        positions.push_back(constant->GetPosition());
+        notified.push_back(model->SetPositionAndVelocity(Vector(2.5, 4, 0), Vector(1, 4, 0))); // within the threshold
+        notified.push_back(model->SetPositionAndVelocity(Vector(2.5, 6, 0), Vector(1, 4, 0)));
+        counts.push_back(counter.m_count);
+    });
+    Simulator::Schedule(Seconds(3), [&] {
+        // the node continued to move, so repeating the previous update corrects its position
+        notified.push_back(fleet.Update(0, Vector(2.5, 6, 0), Vector(1, 4, 0)));
+        positions.push_back(model->GetPosition());
+        counts.push_back(counter.m_count);
+    });
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(counts.size(), 3, "every event must execute");
+    NS_TEST_ASSERT_MSG_EQ(counts[0], 2, "the first update and the acceleration must each notify a course change");
+    NS_TEST_ASSERT_MSG_EQ(positions[0], Vector(2, 4, 0), "the position must be extrapolated");
+    NS_TEST_ASSERT_MSG_EQ(velocities[0], Vector(1, 4, 0), "the velocity must be extrapolated");
+    NS_TEST_ASSERT_MSG_EQ(positions[1], Vector(0, 0, 0), "the position must be constant without dead reckoning");
+    NS_TEST_ASSERT_MSG_EQ(notified[1], false, "a correction within the threshold must not notify");
+    NS_TEST_ASSERT_MSG_EQ(notified[2], true, "a correction beyond the threshold must notify");
+    NS_TEST_ASSERT_MSG_EQ(counts[1], 3, "only the correction beyond the threshold must notify");
+    NS_TEST_ASSERT_MSG_EQ(notified[3], true, "the fleet must not skip a repeated update with dead reckoning");
+    NS_TEST_ASSERT_MSG_EQ(positions[2], Vector(2.5, 6, 0), "the repeated update must replace the extrapolation");
+    NS_TEST_ASSERT_MSG_EQ(counts[2], 4, "the repeated update must notify a course change");
+}
+
+/* ========== RESYNC THRESHOLD ============================================== */
+
+class ResyncThresholdTestCase : public TestCase
+{
+    public:
+        ResyncThresholdTestCase();
+    private:
+        void DoRun() override;
+};
+
+ResyncThresholdTestCase::ResyncThresholdTestCase():
+    TestCase("Check that every setter of a dead reckoning model only notifies corrections beyond the threshold")
+{
+}
+
+void
+ResyncThresholdTestCase::DoRun()
+{
+    CourseChangeCounter counter;
+    Ptr<ExternalMobilityModel> model = CreateObject<ExternalMobilityModel>();
+    model->SetAttribute("DeadReckoning", BooleanValue(true));
+    model->SetAttribute("ResyncThreshold", DoubleValue(1));
+    model->TraceConnectWithoutContext("CourseChange", MakeCallback(&CourseChangeCounter::Count, &counter));
+    CourseChangeCounter constantCounter;
+    Ptr<ExternalMobilityModel> constant = CreateObject<ExternalMobilityModel>();
+    constant->TraceConnectWithoutContext("CourseChange", MakeCallback(&CourseChangeCounter::Count, &constantCounter));
+
+    model->SetPositionAndVelocity(Vector(0, 0, 0), Vector(1, 0, 0));
+    NS_TEST_ASSERT_MSG_EQ(counter.m_count, 1, "the first update must notify a course change");
+
+    model->SetPosition(Vector(0.5, 0, 0));
+    NS_TEST_ASSERT_MSG_EQ(counter.m_count, 1, "a position within the threshold must not notify");
+    NS_TEST_ASSERT_MSG_EQ(model->GetPosition(), Vector(0.5, 0, 0), "the position must still be replaced");
+    model->SetPosition(Vector(3, 0, 0));
+    NS_TEST_ASSERT_MSG_EQ(counter.m_count, 2, "a position beyond the threshold must notify");
+
+    model->SetVelocity(Vector(1 + 1e-12, 0, 0));
+    NS_TEST_ASSERT_MSG_EQ(counter.m_count, 2, "a velocity within the tolerance must not notify");
+    model->SetVelocity(Vector(2, 0, 0));
+    NS_TEST_ASSERT_MSG_EQ(counter.m_count, 3, "a changed velocity must notify");
+
+    // without dead reckoning, a position change is still never reported
+    constant->SetPosition(Vector(10, 0, 0));
+    NS_TEST_ASSERT_MSG_EQ(constantCounter.m_count, 0, "a position without dead reckoning must not notify");
+}
+
+/* ========== TEST SUITE ==================================================== */
+
+class ExternalMobilityTestSuite : public TestSuite
+{
+    public:
+        ExternalMobilityTestSuite();
+};
+
+ExternalMobilityTestSuite::ExternalMobilityTestSuite():
+    TestSuite("ns3-cosim-external-mobility", Type::UNIT)
+{
+    AddTestCase(new ExternalMobilityFleetTestCase());
+    AddTestCase(new DeadReckoningTestCase());
+    AddTestCase(new ResyncThresholdTestCase());
+}
+
+static ExternalMobilityTestSuite g_externalMobilityTestSuite; //!< The static instance that registers the test suite
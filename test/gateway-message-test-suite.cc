@@ -0,0 +1,216 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <string>
+#include <vector>
+
+#include "ns3/test.h"
+
+#include "ns3/binary-codec.h"
+#include "ns3/gateway-message.h"
+
+using namespace ns3;
+
+/* ========== TEXT FIELDS =================================================== */
+
+class GatewayMessageTextTestCase : public TestCase
+{
+    public:
+        GatewayMessageTextTestCase();
+    private:
+        void DoRun() override;
+};
+
+GatewayMessageTextTestCase::GatewayMessageTextTestCase():
+    TestCase("Check that GatewayMessage splits TEXT fields in place like the previous string splitting")
+{
+}
+
+void
+GatewayMessageTextTestCase::DoRun()
+{
+    GatewayMessage message;
+    std::string data = "7::-2::::abc";
+    message.Assign(data);
+    NS_TEST_ASSERT_MSG_EQ(data.empty(), true, "the previous (empty) buffer must be swapped into the argument");
+    message.SplitText("::");
+    NS_TEST_ASSERT_MSG_EQ(message.GetSize(), 4, "the text must be split at each delimiter");
+    NS_TEST_ASSERT_MSG_EQ(message.Get(0), "7", "a field must not include the delimiter");
+    NS_TEST_ASSERT_MSG_EQ(message.Get(2), "", "consecutive delimiters must separate an empty field");
+    NS_TEST_ASSERT_MSG_EQ(message[3], "abc", "the last field must end at the end of the message");
+
+    message.RemoveFront(1);
+    NS_TEST_ASSERT_MSG_EQ(message.GetSize(), 3, "removed fields must not be counted");
+    NS_TEST_ASSERT_MSG_EQ(message[0], "-2", "the fields must be re-indexed from the first remaining field");
+    std::vector<std::string> fields = message.ToVector();
+    NS_TEST_ASSERT_MSG_EQ(fields.size(), 3, "every remaining field must be copied");
+    NS_TEST_ASSERT_MSG_EQ(fields[0] + "|" + fields[1] + "|" + fields[2], "-2||abc",
+                          "the fields must be copied in order");
+    NS_TEST_ASSERT_MSG_EQ(message.GetBuffer(), "7::-2::::abc", "the buffer must keep the complete message");
+
+    // re-using the message replaces its fields
+    data = "";
+    message.Assign(data);
+    NS_TEST_ASSERT_MSG_EQ(data, "7::-2::::abc", "the previous buffer must be swapped into the argument");
+    message.SplitText("::");
+    NS_TEST_ASSERT_MSG_EQ(message.GetSize(), 1, "an empty message must contain one empty field");
+    NS_TEST_ASSERT_MSG_EQ(message[0], "", "an empty message must contain one empty field");
+}
+
+/* ========== BINARY FIELDS ================================================= */
+
+class GatewayMessageBinaryTestCase : public TestCase
+{
+    public:
+        GatewayMessageBinaryTestCase();
+    private:
+        void DoRun() override;
+};
+
+GatewayMessageBinaryTestCase::GatewayMessageBinaryTestCase():
+    TestCase("Check that GatewayMessage splits BINARY fields, and rejects truncated fields")
+{
+}
+
+void
+GatewayMessageBinaryTestCase::DoRun()
+{
+    BinaryEncoder encoder;
+    encoder.AddInt32(7);
+    encoder.AddBytes("abc");
+    encoder.AddDouble(-0.25);
+    std::string data = encoder.Finish(0, 0);
+
+    GatewayMessage message;
+    message.Assign(data);
+    NS_TEST_ASSERT_MSG_EQ(message.SplitBinary(BinaryEncoder::HEADER_SIZE), true, "the fields must be split");
+    NS_TEST_ASSERT_MSG_EQ(message.GetSize(), 3, "each encoded field must be one field");
+
+    int32_t intValue;
+    std::string bytesValue;
+    double doubleValue;
+    NS_TEST_ASSERT_MSG_EQ(BinaryDecoder(std::string(message[0])).ReadInt32(intValue), true, "field 0 is an INT32");
+    NS_TEST_ASSERT_MSG_EQ(intValue, 7, "the INT32 field must be decoded");
+    NS_TEST_ASSERT_MSG_EQ(BinaryDecoder(std::string(message[1])).ReadBytes(bytesValue), true, "field 1 is BYTES");
+    NS_TEST_ASSERT_MSG_EQ(bytesValue, "abc", "the BYTES field must be decoded");
+    NS_TEST_ASSERT_MSG_EQ(BinaryDecoder(std::string(message[2])).ReadDouble(doubleValue), true, "field 2 is a DOUBLE");
+    NS_TEST_ASSERT_MSG_EQ(doubleValue, -0.25, "the DOUBLE field must be decoded");
+
+    std::string truncated = encoder.Finish(0, 0);
+    truncated.pop_back();
+    message.Assign(truncated);
+    NS_TEST_ASSERT_MSG_EQ(message.SplitBinary(BinaryEncoder::HEADER_SIZE), false, "a truncated field must fail");
+}
+
+/* ========== TYPED ACCESSORS =============================================== */
+
+class GatewayMessageTypedTestCase : public TestCase
+{
+    public:
+        GatewayMessageTypedTestCase();
+    private:
+        void DoRun() override;
+};
+
+GatewayMessageTypedTestCase::GatewayMessageTypedTestCase():
+    TestCase("Check that the typed accessors convert TEXT and BINARY fields, and reject invalid fields")
+{
+}
+
+void
+GatewayMessageTypedTestCase::DoRun()
+{
+    GatewayMessage message;
+    int32_t intValue;
+    int64_t longValue;
+    double doubleValue;
+    Vector vectorValue;
+    double values[3];
+
+    std::string text = "7 -2 3.5 abc 1e3 -4.5 0";
+    message.Assign(text);
+    message.SplitText(" ");
+    NS_TEST_ASSERT_MSG_EQ(message.GetInt(1, intValue), true, "a negative integer must be converted");
+    NS_TEST_ASSERT_MSG_EQ(intValue, -2, "the integer must be converted");
+    NS_TEST_ASSERT_MSG_EQ(message.GetDouble(2, doubleValue), true, "a decimal number must be converted");
+    NS_TEST_ASSERT_MSG_EQ(doubleValue, 3.5, "the decimal number must be converted");
+    NS_TEST_ASSERT_MSG_EQ(message.GetInt(2, intValue), false, "a decimal number must not be an integer");
+    NS_TEST_ASSERT_MSG_EQ(intValue, -2, "a failed conversion must not change the value");
+    NS_TEST_ASSERT_MSG_EQ(message.GetInt(3, intValue), false, "text must not be an integer");
+    NS_TEST_ASSERT_MSG_EQ(message.GetDouble(3, doubleValue), false, "text must not be a floating point value");
+    NS_TEST_ASSERT_MSG_EQ(message.GetInt(7, intValue), false, "a missing field must not be converted");
+    NS_TEST_ASSERT_MSG_EQ(message.GetVector(4, vectorValue), true, "three numbers must be a vector");
+    NS_TEST_ASSERT_MSG_EQ(vectorValue.x == 1000 && vectorValue.y == -4.5 && vectorValue.z == 0, true,
+                          "the vector must be converted");
+    NS_TEST_ASSERT_MSG_EQ(message.GetVector(5, vectorValue), false, "a vector must have three fields");
+    NS_TEST_ASSERT_MSG_EQ(message.ParseDoubles(0, values, 3), true, "consecutive numbers must be converted");
+    NS_TEST_ASSERT_MSG_EQ(values[0] == 7 && values[1] == -2 && values[2] == 3.5, true, "the numbers must be converted");
+    NS_TEST_ASSERT_MSG_EQ(message.ParseDoubles(1, values, 3), false, "a field that is not a number must fail");
+
+    BinaryEncoder encoder;
+    encoder.AddInt32(7);
+    encoder.AddInt64(int64_t(1) << 40);
+    encoder.AddDouble(-0.25);
+    encoder.AddBytes("8");
+    std::string binary = encoder.Finish(0, 0);
+    message.Assign(binary);
+    NS_TEST_ASSERT_MSG_EQ(message.SplitBinary(BinaryEncoder::HEADER_SIZE), true, "the fields must be split");
+    NS_TEST_ASSERT_MSG_EQ(message.GetInt(0, intValue), true, "an INT32 field must be converted");
+    NS_TEST_ASSERT_MSG_EQ(intValue, 7, "the INT32 field must be converted");
+    NS_TEST_ASSERT_MSG_EQ(message.GetInt(1, intValue), false, "an INT64 field must not overflow an int32_t");
+    NS_TEST_ASSERT_MSG_EQ(message.GetInt(1, longValue), true, "an INT64 field must be converted");
+    NS_TEST_ASSERT_MSG_EQ(longValue, int64_t(1) << 40, "the INT64 field must be converted");
+    NS_TEST_ASSERT_MSG_EQ(message.GetInt(2, longValue), false, "a DOUBLE field must not be an integer");
+    NS_TEST_ASSERT_MSG_EQ(message.GetInt(3, intValue), false, "a BYTES field must not be an integer");
+    NS_TEST_ASSERT_MSG_EQ(message.GetDouble(3, doubleValue), false, "a BYTES field must not be a floating point value");
+    NS_TEST_ASSERT_MSG_EQ(message.GetVector(0, vectorValue), true, "integer and DOUBLE fields must be a vector");
+    NS_TEST_ASSERT_MSG_EQ(vectorValue.x == 7 && vectorValue.y == 1099511627776.0 && vectorValue.z == -0.25, true,
+                          "the vector must be converted");
+}
+
+/* ========== TEST SUITE ==================================================== */
+
+class GatewayMessageTestSuite : public TestSuite
+{
+    public:
+        GatewayMessageTestSuite();
+};
+
+GatewayMessageTestSuite::GatewayMessageTestSuite():
+    TestSuite("ns3-cosim-gateway-message", Type::UNIT)
+{
+    AddTestCase(new GatewayMessageTextTestCase());
+    AddTestCase(new GatewayMessageBinaryTestCase());
+    AddTestCase(new GatewayMessageTypedTestCase());
+}
+
+static GatewayMessageTestSuite g_gatewayMessageTestSuite; //!< The static instance that registers the test suite
@@ -0,0 +1,1988 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ns3/test.h"
+
+#include "ns3/binary-codec.h"
+#include "ns3/gateway.h"
+#include "ns3/gateway-coordinator.h"
+#include "ns3/gateway-reactor.h"
+#include "ns3/gateway-server.h"
+#include "ns3/gateway-transport.h"
+#include "ns3/replay-transport.h"
+#include "ns3/staged-gateway.h"
+#include "ns3/typed-gateway.h"
+
+using namespace ns3;
+
+namespace
+{
+
+// the server side of a gateway connection over a loopback TCP socket, which runs on its own thread
+class TestServer
+{
+    public:
+        // listen on a port chosen by the system
+        TestServer():
+            m_socket(-1)
+        {
+            m_serverSocket = socket(AF_INET, SOCK_STREAM, 0);
+            struct sockaddr_in address = {};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            socklen_t addressSize = sizeof(address);
+            if (m_serverSocket == -1 || bind(m_serverSocket, (struct sockaddr *)&address, addressSize) == -1
+                || listen(m_serverSocket, 1) == -1
+                || getsockname(m_serverSocket, (struct sockaddr *)&address, &addressSize) == -1)
+            {
+                NS_FATAL_ERROR("ERROR: the test server failed to listen");
+            }
+            m_port = ntohs(address.sin_port);
+        }
+
+        ~TestServer()
+        {
+            close(m_serverSocket);
+        }
+
+        uint16_t GetPort() const
+        {
+            return m_port;
+        }
+
+        // accept the gateway on a new thread, and then execute the server function, which is responsible for
+        // sending the terminate message
+        void Start(const std::function<void(TestServer &)> & run)
+        {
+            m_thread = std::thread([this, run] {
+                m_socket = accept(m_serverSocket, NULL, NULL);
+                run(*this);
+                close(m_socket);
+            });
+        }
+
+        void Join()
+        {
+            m_thread.join();
+        }
+
+        bool Send(const std::string & message)
+        {
+            return send(m_socket, message.data(), message.size(), 0) == (ssize_t)message.size();
+        }
+
+        // receive one message, excluding its delimiter
+        bool Receive(std::string & message)
+        {
+            size_t end;
+            while ((end = m_buffer.find("\r\n")) == std::string::npos)
+            {
+                char data[4096];
+                ssize_t bytesReceived = recv(m_socket, data, sizeof(data), 0);
+                if (bytesReceived <= 0)
+                {
+                    return false;
+                }
+                m_buffer.append(data, bytesReceived);
+            }
+            message = m_buffer.substr(0, end);
+            m_buffer.erase(0, end + 2);
+            return true;
+        }
+
+        // receive one message of the BINARY framing, including its header
+        bool ReceiveBinary(std::string & message)
+        {
+            int32_t seconds;
+            uint32_t nanoseconds;
+            uint32_t payloadSize;
+            while (!BinaryDecoder::ReadHeader(m_buffer.data(), m_buffer.size(), seconds, nanoseconds, payloadSize)
+                   || m_buffer.size() < BinaryEncoder::HEADER_SIZE + payloadSize)
+            {
+                char data[4096];
+                ssize_t bytesReceived = recv(m_socket, data, sizeof(data), 0);
+                if (bytesReceived <= 0)
+                {
+                    return false;
+                }
+                m_buffer.append(data, bytesReceived);
+            }
+            message = m_buffer.substr(0, BinaryEncoder::HEADER_SIZE + payloadSize);
+            m_buffer.erase(0, message.size());
+            return true;
+        }
+    private:
+        int m_serverSocket;     //!< The listening socket
+        int m_socket;           //!< The socket connected to the gateway
+        uint16_t m_port;        //!< The port of the listening socket
+        std::thread m_thread;   //!< The thread executing the server function
+        std::string m_buffer;   //!< Received data that is not yet a complete message
+};
+
+// connect a gateway to a test server, and run the simulation until the server terminates it
+void
+RunGateway(Gateway & gateway, const std::function<void(TestServer &)> & run)
+{
+    TestServer server;
+    server.Start(run);
+    gateway.Connect("127.0.0.1", server.GetPort());
+    Simulator::Run();
+    server.Join();
+}
+
+// a gateway that records the simulation time of each message, and responds with its first value
+class EchoGateway : public Gateway
+{
+    public:
+        EchoGateway():
+            Gateway(1)
+        {
+        }
+
+        std::vector<std::string> m_updates; //!< The simulation time (ms) and first value of each message
+        std::string m_suffix;               //!< Appended to each response value
+    private:
+        void DoInitialize(const std::vector<std::string> & receivedData) override
+        {
+            DoUpdate(receivedData);
+        }
+
+        void DoUpdate(const std::vector<std::string> & receivedData) override
+        {
+            m_updates.push_back(std::to_string(Simulator::Now().GetMilliSeconds()) + " " + receivedData.at(0));
+            SetValue(0, receivedData.at(0) + m_suffix);
+            SendResponse();
+        }
+};
+
+// a gateway that receives an INT32 and a BYTES field, and responds with both values as one BYTES field
+class BinaryGateway : public Gateway
+{
+    public:
+        BinaryGateway():
+            Gateway(1, FRAMING::BINARY)
+        {
+        }
+    private:
+        void DoInitialize(const std::vector<std::string> & receivedData) override
+        {
+            DoUpdate(receivedData);
+        }
+
+        void DoUpdate(const std::vector<std::string> & receivedData) override
+        {
+            int32_t number;
+            std::string text;
+            if (receivedData.size() != 2 || !BinaryDecoder(receivedData[0]).ReadInt32(number)
+                || !BinaryDecoder(receivedData[1]).ReadBytes(text))
+            {
+                NS_FATAL_ERROR("ERROR: received an invalid message");
+            }
+            SetValue(0, text + std::to_string(number));
+            SendResponse();
+        }
+};
+
+// run a gateway until the server, which is executed on another thread with the other end of a Unix domain socket
+// connection, terminates it
+void
+RunWithServer(Gateway & gateway, const std::function<void(Ptr<GatewayTransport>)> & run)
+{
+    // each thread creates its own transport, since Ptr is not thread-safe
+    std::string path = "/tmp/ns3-cosim-test-" + std::to_string(getpid());
+    std::promise<void> listening;
+    std::thread serverThread([&path, &listening, &run] {
+        Ptr<UnixTransport> serverTransport = Create<UnixTransport>();
+        serverTransport->Listen(path);
+        listening.set_value();
+        serverTransport->Accept();
+        run(serverTransport);
+    });
+
+    listening.get_future().wait();
+    Ptr<UnixTransport> transport = Create<UnixTransport>();
+    transport->Connect(path);
+    gateway.Connect(transport);
+    Simulator::Run();
+    serverThread.join();
+}
+
+// send a message in two parts, so that the gateway first receives an incomplete message
+void
+SendSplit(Ptr<GatewayTransport> transport, const std::string & message, size_t split)
+{
+    transport->Send(message.data(), split);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    transport->Send(message.data() + split, message.size() - split);
+}
+
+// encode a server message containing integer fields
+std::string
+EncodeMessage(Gateway::FRAMING framing, int32_t seconds, const std::vector<int32_t> & fields)
+{
+    if (framing == Gateway::FRAMING::BINARY)
+    {
+        BinaryEncoder encoder;
+        for (int32_t field : fields)
+        {
+            encoder.AddInt32(field);
+        }
+        return encoder.Finish(seconds, 0);
+    }
+    std::string message = std::to_string(seconds) + " 0";
+    for (int32_t field : fields)
+    {
+        message += " " + std::to_string(field);
+    }
+    return message + "\r\n";
+}
+
+// a gateway that sets the value at each (index, value) pair of a message, and sends a response
+class PairGateway : public Gateway
+{
+    public:
+        PairGateway(FRAMING framing):
+            Gateway(4, framing),
+            m_framing(framing)
+        {
+        }
+    private:
+        void DoInitialize(const std::vector<std::string> & receivedData) override
+        {
+            DoUpdate(receivedData);
+        }
+
+        void DoUpdate(const std::vector<std::string> & receivedData) override
+        {
+            for (uint32_t i = 0; i + 1 < receivedData.size(); i += 2)
+            {
+                SetValue(ReadInt(receivedData[i]), std::to_string(ReadInt(receivedData[i + 1])));
+            }
+            SendResponse();
+        }
+
+        int32_t ReadInt(const std::string & field) const
+        {
+            int32_t value;
+            if (m_framing == FRAMING::TEXT)
+            {
+                return std::stoi(field);
+            }
+            if (!BinaryDecoder(field).ReadInt32(value))
+            {
+                NS_FATAL_ERROR("ERROR: received an invalid INT32 field");
+            }
+            return value;
+        }
+
+        FRAMING m_framing;  //!< The format of the received messages
+};
+
+// a gateway that responds with one value of each type supported by Gateway::SetValue
+class NumberGateway : public Gateway
+{
+    public:
+        NumberGateway(FRAMING framing = FRAMING::TEXT):
+            Gateway(6, framing),
+            m_framing(framing)
+        {
+        }
+    private:
+        void DoInitialize(const std::vector<std::string> & receivedData) override
+        {
+            DoUpdate(receivedData);
+        }
+
+        void DoUpdate(const std::vector<std::string> & receivedData) override
+        {
+            if (m_framing == FRAMING::TEXT) // the precision does not apply to BINARY fields
+            {
+                SetPrecision(std::stoi(receivedData.at(0)));
+            }
+            SetValue(0, (int32_t)-7);
+            SetValue(1, UINT64_MAX);
+            SetValue(2, true);
+            SetValue(3, 0.1);
+            SetValue(4, 3.14159);
+            SetValue(5, "text");
+            SendResponse();
+        }
+
+        FRAMING m_framing;  //!< The format of the exchanged messages
+};
+
+// a typed gateway that responds to each (position, id, flag) record with a signed id and the sum of the position
+class VehicleGateway : public TypedGateway<Record<Vector, int16_t, bool>, Response<int32_t, double>>
+{
+    public:
+        VehicleGateway():
+            TypedGateway(2),
+            m_responses(2)
+        {
+        }
+    private:
+        void DoInitializeRecords(const std::vector<RecordType> & records) override
+        {
+            DoUpdateRecords(records);
+        }
+
+        void DoUpdateRecords(const std::vector<RecordType> & records) override
+        {
+            for (uint32_t i = 0; i < records.size() && i < m_responses.size(); i++)
+            {
+                const auto & [position, id, flag] = records[i];
+                m_responses[i] = ResponseType(flag ? id : -id, position.x + position.y + position.z);
+            }
+            SendResponse(m_responses);
+        }
+
+        std::vector<ResponseType> m_responses;  //!< The records sent in each response
+};
+
+// a typed gateway that receives the changed fields of up to 3 vehicles, and responds like VehicleGateway
+class SparseVehicleGateway : public TypedGateway<SparseRecord<Vector, int16_t, bool>, Response<int32_t, double>>
+{
+    public:
+        SparseVehicleGateway():
+            TypedGateway(3),
+            m_responses(3)
+        {
+        }
+
+        std::vector<std::string> m_updated; //!< The keys updated by each message
+    private:
+        void DoInitializeRecords(const std::vector<RecordType> & records) override
+        {
+            DoUpdateRecords(records);
+        }
+
+        void DoUpdateRecords(const std::vector<RecordType> & records) override
+        {
+            std::string updated;
+            for (uint32_t key : GetUpdatedRecords())
+            {
+                updated += (updated.empty() ? "" : " ") + std::to_string(key);
+            }
+            m_updated.push_back(updated);
+            for (uint32_t i = 0; i < records.size() && i < m_responses.size(); i++)
+            {
+                const auto & [position, id, flag] = records[i];
+                m_responses[i] = ResponseType(flag ? id : -id, position.x + position.y + position.z);
+            }
+            SendResponse(m_responses);
+        }
+
+        std::vector<ResponseType> m_responses;  //!< The records sent in each response
+};
+
+// the integers of one message, decoded by StagedSumGateway on the thread that received it
+struct StagedIntegers
+{
+    std::vector<int64_t> values;    //!< The fields of the message
+    std::thread::id decoder;        //!< The thread that decoded the message
+};
+
+// a staged gateway that responds with the sum of the received integers, and whether they were decoded by another thread
+class StagedSumGateway : public StagedGateway<StagedIntegers>
+{
+    public:
+        StagedSumGateway():
+            StagedGateway(2)
+        {
+        }
+    private:
+        void DoDecode(const GatewayMessage & receivedData, StagedIntegers & stage) override
+        {
+            stage.values.resize(receivedData.GetSize());
+            for (uint32_t i = 0; i < receivedData.GetSize(); i++)
+            {
+                if (!receivedData.GetInt(i, stage.values[i]))
+                {
+                    NS_FATAL_ERROR("ERROR: received an invalid integer field");
+                }
+            }
+            stage.decoder = std::this_thread::get_id();
+        }
+
+        void DoInitializeStaged(const StagedIntegers & stage) override
+        {
+            DoUpdateStaged(stage);
+        }
+
+        void DoUpdateStaged(const StagedIntegers & stage) override
+        {
+            int64_t sum = 0;
+            for (int64_t value : stage.values)
+            {
+                sum += value;
+            }
+            SetValue(0, std::to_string(sum));
+            SetValue(1, stage.decoder != std::this_thread::get_id());
+            SendResponse();
+        }
+};
+
+// record the timing of each step published by the "Step" trace source
+class StepRecorder
+{
+    public:
+        void Record(const Gateway::StepTiming & timing)
+        {
+            m_steps.push_back(timing);
+        }
+
+        std::vector<Gateway::StepTiming> m_steps;   //!< The timing of each step
+};
+
+// record the slack and jitter of each deadline published by the "Pacing" trace source
+class PacingRecorder
+{
+    public:
+        void Record(const Gateway::PacingTiming & timing)
+        {
+            m_timings.push_back(timing);
+        }
+
+        std::vector<Gateway::PacingTiming> m_timings;   //!< The timing of each deadline
+};
+
+// a reactor handler that receives one byte from a pipe per call, and pauses the pipe after the first call
+class PausingReader
+{
+    public:
+        PausingReader(Ptr<GatewayReactor> reactor, int descriptor):
+            m_reactor(reactor),
+            m_descriptor(descriptor),
+            m_callCount(0),
+            m_byteCount(0)
+        {
+        }
+
+        bool Receive()
+        {
+            char byte;
+            if (read(m_descriptor, &byte, 1) == 1)
+            {
+                m_byteCount++;
+            }
+            if (++m_callCount == 1)
+            {
+                m_reactor->Pause(m_descriptor);
+            }
+            return true;
+        }
+
+        Ptr<GatewayReactor> m_reactor;      //!< The reactor that calls Receive
+        int m_descriptor;                   //!< The read end of the pipe
+        std::atomic<uint32_t> m_callCount;  //!< The number of calls to Receive
+        std::atomic<uint32_t> m_byteCount;  //!< The number of bytes received
+};
+
+// record the simulation time every 10 ms, so another thread can observe how far ns-3 has advanced
+void
+ProbeTime(std::atomic<int64_t> * timeReached)
+{
+    timeReached->store(Simulator::Now().GetMilliSeconds());
+    Simulator::Schedule(MilliSeconds(10), &ProbeTime, timeReached);
+}
+
+} // namespace
+
+/* ========== IDLE MODE ===================================================== */
+
+class IdleModeTestCase : public TestCase
+{
+    public:
+        IdleModeTestCase();
+    private:
+        void DoRun() override;
+
+        /**
+         * @brief Run a gateway for a server that takes 20 ms to compute each step.
+         * @param mode the idle mode of the gateway
+         * @param updates the simulation time (ms) and value of each processed message
+         * @return the number of events executed by the simulator
+         */
+        uint64_t Run(Gateway::IDLE_MODE mode, std::vector<std::string> & updates);
+};
+
+IdleModeTestCase::IdleModeTestCase():
+    TestCase("Check that the BLOCK idle mode gives the same results as SPIN without executing events while paused")
+{
+}
+
+uint64_t
+IdleModeTestCase::Run(Gateway::IDLE_MODE mode, std::vector<std::string> & updates)
+{
+    std::vector<std::string> responses;
+    EchoGateway gateway;
+    gateway.SetIdleMode(mode);
+    RunGateway(gateway, [&responses](TestServer & server) {
+        for (int32_t step = 0; step < 4; step++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            std::string response;
+            if (!server.Send(std::to_string(step) + " 500000000 v" + std::to_string(step) + "\r\n")
+                || !server.Receive(response))
+            {
+                break;
+            }
+            responses.push_back(response);
+        }
+        server.Send("-1 0\r\n"); // terminate message
+    });
+    uint64_t eventCount = Simulator::GetEventCount();
+    Simulator::Destroy();
+
+    updates = gateway.m_updates;
+    updates.insert(updates.end(), responses.begin(), responses.end());
+    return eventCount;
+}
+
+void
+IdleModeTestCase::DoRun()
+{
+    std::vector<std::string> spinUpdates;
+    std::vector<std::string> blockUpdates;
+    uint64_t spinEvents = Run(Gateway::IDLE_MODE::SPIN, spinUpdates);
+    uint64_t blockEvents = Run(Gateway::IDLE_MODE::BLOCK, blockUpdates);
+
+    // the first message sets the reference time, so the updates are 1 second apart from time 0
+    const std::vector<std::string> expected = {"0 v0", "1000 v1", "2000 v2", "3000 v3", "v0", "v1", "v2", "v3"};
+    NS_TEST_ASSERT_MSG_EQ(spinUpdates.size(), expected.size(), "every message must be processed and answered");
+    for (uint32_t i = 0; i < expected.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(spinUpdates[i], expected[i], "update or response " << i);
+        NS_TEST_ASSERT_MSG_EQ(blockUpdates[i], expected[i], "the idle mode must not change update or response " << i);
+    }
+
+    // while the server computes, the SPIN mode executes wait events continuously, and the BLOCK mode only a few
+    NS_TEST_ASSERT_MSG_LT(blockEvents, 100, "the BLOCK mode must not execute events while waiting for the server");
+    NS_TEST_ASSERT_MSG_LT(100 * blockEvents, spinEvents, "the SPIN mode must execute events while waiting");
+}
+
+/* ========== SHARED BLOCK MODE ============================================= */
+
+class SharedBlockModeTestCase : public TestCase
+{
+    public:
+        SharedBlockModeTestCase();
+    private:
+        void DoRun() override;
+};
+
+SharedBlockModeTestCase::SharedBlockModeTestCase():
+    TestCase("Check that independent gateways paused at the same time block the main thread until any receives")
+{
+}
+
+void
+SharedBlockModeTestCase::DoRun()
+{
+    // both servers take 20 ms to compute each step, so both gateways pause at the same simulation times
+    const uint32_t gatewayCount = 2;
+    std::vector<EchoGateway> gateways(gatewayCount);
+    std::vector<TestServer> servers(gatewayCount);
+    std::vector<std::vector<std::string>> responses(gatewayCount);
+    std::atomic<uint32_t> finishedCount(0);
+    for (uint32_t i = 0; i < gatewayCount; i++)
+    {
+        gateways[i].SetIdleMode(Gateway::IDLE_MODE::BLOCK);
+        servers[i].Start([&responses, &finishedCount, i, gatewayCount](TestServer & server) {
+            for (int32_t step = 0; step < 4; step++)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                std::string response;
+                if (!server.Send(std::to_string(step) + " 500000000 v" + std::to_string(step) + "\r\n")
+                    || !server.Receive(response))
+                {
+                    break;
+                }
+                responses[i].push_back(response);
+            }
+
+            // the first terminate message stops the simulation, so every server must finish its steps first
+            finishedCount++;
+            while (finishedCount.load() < gatewayCount)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            server.Send("-1 0\r\n"); // terminate message
+        });
+        gateways[i].Connect("127.0.0.1", servers[i].GetPort());
+    }
+    Simulator::Run();
+    for (TestServer & server : servers)
+    {
+        server.Join();
+    }
+    uint64_t eventCount = Simulator::GetEventCount();
+    Simulator::Destroy();
+
+    const std::vector<std::string> expected = {"0 v0", "1000 v1", "2000 v2", "3000 v3"};
+    for (uint32_t i = 0; i < gatewayCount; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(responses[i].size(), 4, "every message of gateway " << i << " must be answered");
+        NS_TEST_ASSERT_MSG_EQ(gateways[i].m_updates.size(), expected.size(), "the updates of gateway " << i);
+        for (uint32_t step = 0; step < expected.size() && step < gateways[i].m_updates.size(); step++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(gateways[i].m_updates[step], expected[step],
+                                  "update " << step << " of gateway " << i);
+        }
+    }
+
+    // each gateway executes the other's wait events, which must not keep the main thread spinning
+    NS_TEST_ASSERT_MSG_LT(eventCount, 200, "the main thread must block while both servers compute");
+}
+
+/* ========== TEXT TIMESTAMPS =============================================== */
+
+class TextTimestampTestCase : public TestCase
+{
+    public:
+        TextTimestampTestCase();
+    private:
+        void DoRun() override;
+};
+
+TextTimestampTestCase::TextTimestampTestCase():
+    TestCase("Check that text timestamps accept a '+' sign, negative nanoseconds, and trailing characters")
+{
+}
+
+void
+TextTimestampTestCase::DoRun()
+{
+    std::vector<std::string> responses;
+    EchoGateway gateway;
+    RunGateway(gateway, [&responses](TestServer & server) {
+        // each message is 1 s after the previous one, in a form that std::stoi and std::stol also accept
+        const std::vector<std::string> messages = {"+0 500000000 v0\r\n", "1s 500000000ns v1\r\n",
+                                                   "2.0 500000000 v2\r\n", "4 -500000000 v3\r\n"};
+        for (const std::string & message : messages)
+        {
+            std::string response;
+            if (!server.Send(message) || !server.Receive(response))
+            {
+                break;
+            }
+            responses.push_back(response);
+        }
+        server.Send("-1 0\r\n"); // terminate message
+    });
+    Simulator::Destroy();
+
+    const std::vector<std::string> expected = {"0 v0", "1000 v1", "2000 v2", "3000 v3"};
+    NS_TEST_ASSERT_MSG_EQ(responses.size(), expected.size(), "every message must be answered");
+    NS_TEST_ASSERT_MSG_EQ(gateway.m_updates.size(), expected.size(), "every message must be processed");
+    for (uint32_t i = 0; i < expected.size() && i < gateway.m_updates.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(gateway.m_updates[i], expected[i], "the update time of message " << i);
+    }
+}
+
+/* ========== BINARY FRAMING ================================================ */
+
+class BinaryFramingTestCase : public TestCase
+{
+    public:
+        BinaryFramingTestCase();
+    private:
+        void DoRun() override;
+};
+
+BinaryFramingTestCase::BinaryFramingTestCase():
+    TestCase("Check that the BINARY framing delivers typed fields and timestamps across partial receives")
+{
+}
+
+void
+BinaryFramingTestCase::DoRun()
+{
+    std::vector<std::string> responses;
+    BinaryGateway gateway;
+    RunGateway(gateway, [&responses](TestServer & server) {
+        BinaryEncoder encoder;
+        for (int32_t step = 0; step < 3; step++)
+        {
+            // the second message is split within its header, and the third within its payload (the delimiter of the
+            // TEXT framing in a BYTES field has no meaning)
+            encoder.Clear();
+            encoder.AddInt32(step * 10);
+            encoder.AddBytes(std::string("a \r\n\0", 5));
+            std::string message = encoder.Finish(step, 250000000);
+            size_t split = (step == 1) ? 5 : message.size() - 3;
+            std::string response;
+            server.Send(message.substr(0, split));
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            if (!server.Send(message.substr(split)) || !server.ReceiveBinary(response))
+            {
+                break;
+            }
+            responses.push_back(response);
+        }
+        server.Send(BinaryEncoder().Finish(-1, 0)); // terminate message
+    });
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(responses.size(), 3, "every message must be answered");
+    for (int32_t step = 0; step < 3; step++)
+    {
+        // the response timestamp is the server time of the update
+        int32_t seconds;
+        uint32_t nanoseconds;
+        uint32_t payloadSize;
+        std::string value;
+        const std::string & response = responses[step];
+        NS_TEST_ASSERT_MSG_EQ(BinaryDecoder::ReadHeader(response.data(), response.size(), seconds, nanoseconds,
+                                                        payloadSize),
+                              true, "response " << step << " must have a header");
+        NS_TEST_ASSERT_MSG_EQ(seconds, step, "response " << step << " must have the timestamp of its message");
+        NS_TEST_ASSERT_MSG_EQ(nanoseconds, 250000000, "response " << step << " must have the timestamp of its message");
+
+        BinaryDecoder decoder(response.data() + BinaryEncoder::HEADER_SIZE, payloadSize);
+        NS_TEST_ASSERT_MSG_EQ(decoder.ReadBytes(value), true, "response " << step << " must contain a BYTES field");
+        NS_TEST_ASSERT_MSG_EQ(value, std::string("a \r\n\0", 5) + std::to_string(step * 10), "response " << step);
+        NS_TEST_ASSERT_MSG_EQ(decoder.IsEmpty(), true, "response " << step << " must contain one field");
+    }
+}
+
+/* ========== MESSAGE BURST ================================================= */
+
+class MessageBurstTestCase : public TestCase
+{
+    public:
+        MessageBurstTestCase();
+    private:
+        void DoRun() override;
+};
+
+MessageBurstTestCase::MessageBurstTestCase():
+    TestCase("Check that a burst of messages larger than the message queue is processed in order")
+{
+}
+
+void
+MessageBurstTestCase::DoRun()
+{
+    const int32_t count = 3000; // more than the capacity of the queue between the gateway thread and the main thread
+    std::vector<std::string> responses;
+    EchoGateway gateway;
+    RunGateway(gateway, [&responses, count](TestServer & server) {
+        std::string burst;
+        for (int32_t step = 0; step < count; step++)
+        {
+            burst += "0 " + std::to_string(step * 1000) + " " + std::to_string(step) + "\r\n";
+        }
+        server.Send(burst);
+        std::string response;
+        while ((int32_t)responses.size() < count && server.Receive(response))
+        {
+            responses.push_back(response);
+        }
+        server.Send("-1 0\r\n"); // terminate message
+    });
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(gateway.m_updates.size(), count, "every message must be processed");
+    NS_TEST_ASSERT_MSG_EQ(responses.size(), count, "every message must be answered");
+    for (int32_t step = 0; step < count; step++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(responses[step], std::to_string(step), "the messages must be processed in order");
+    }
+    NS_TEST_ASSERT_MSG_EQ(gateway.m_updates.back(), "2 2999", "the last update must be at its timestamp (ms)");
+}
+
+/* ========== LOOKAHEAD ===================================================== */
+
+class LookaheadTestCase : public TestCase
+{
+    public:
+        LookaheadTestCase();
+    private:
+        void DoRun() override;
+
+        /**
+         * @brief Run a gateway for a server that sends 3 messages 1 second apart.
+         * @param lookaheadHeader true to send the lookahead of each message in its header, and false for a constant
+         *                        lookahead of 1 second
+         */
+        void Run(bool lookaheadHeader);
+};
+
+LookaheadTestCase::LookaheadTestCase():
+    TestCase("Check that ns-3 advances to the granted time while the server computes its next message")
+{
+}
+
+void
+LookaheadTestCase::Run(bool lookaheadHeader)
+{
+    // the lookahead of step k is 1 second, or (k + 1) * 250 ms when sent in the header
+    std::vector<int64_t> lookaheads = {1000, 1000, 1000};
+    if (lookaheadHeader)
+    {
+        lookaheads = {250, 500, 750};
+    }
+
+    std::atomic<int64_t> timeReached(-1);
+    std::vector<int64_t> timesReached;
+    EchoGateway gateway;
+    if (lookaheadHeader)
+    {
+        gateway.SetLookaheadHeader(true);
+    }
+    else
+    {
+        gateway.SetLookahead(Seconds(1));
+    }
+    Simulator::Schedule(Time(0), &ProbeTime, &timeReached);
+    RunGateway(gateway, [&](TestServer & server) {
+        for (int32_t step = 0; step < 3; step++)
+        {
+            std::string lookahead = lookaheadHeader ? " " + std::to_string(lookaheads[step] * 1000000) : "";
+            std::string response;
+            if (!server.Send(std::to_string(step) + " 0" + lookahead + " v" + std::to_string(step) + "\r\n")
+                || !server.Receive(response))
+            {
+                break;
+            }
+            // while the server computes, ns-3 executes the events up to the granted time
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            timesReached.push_back(timeReached.load());
+        }
+        server.Send("-1 0\r\n"); // terminate message
+    });
+    int64_t timeStopped = Simulator::Now().GetMilliSeconds();
+    Simulator::Destroy();
+
+    const std::vector<std::string> expected = {"0 v0", "1000 v1", "2000 v2"};
+    NS_TEST_ASSERT_MSG_EQ(gateway.m_updates.size(), expected.size(), "every message must be processed");
+    for (uint32_t i = 0; i < gateway.m_updates.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(gateway.m_updates[i], expected[i], "the lookahead must not delay update " << i);
+    }
+    NS_TEST_ASSERT_MSG_EQ(timesReached.size(), 3, "every message must be answered");
+    for (int32_t step = 0; step < (int32_t)timesReached.size(); step++)
+    {
+        // the last probe before the granted time is at most 10 ms earlier
+        int64_t timeGranted = step * 1000 + lookaheads[step];
+        NS_TEST_ASSERT_MSG_LT(timeGranted - timesReached[step], 11, "ns-3 must advance to the granted time " << step);
+        NS_TEST_ASSERT_MSG_LT(timesReached[step], timeGranted + 1, "ns-3 must not advance past the granted time");
+    }
+    NS_TEST_ASSERT_MSG_EQ(timeStopped, 2000 + lookaheads[2], "the simulation must stop at the last granted time");
+}
+
+void
+LookaheadTestCase::DoRun()
+{
+    Run(false);
+    Run(true);
+}
+
+/* ========== DELTA RESPONSES =============================================== */
+
+class DeltaResponseTestCase : public TestCase
+{
+    public:
+        DeltaResponseTestCase(Gateway::FRAMING framing);
+    private:
+        void DoRun() override;
+
+        Gateway::FRAMING m_framing; //!< The framing of the messages
+};
+
+DeltaResponseTestCase::DeltaResponseTestCase(Gateway::FRAMING framing):
+    TestCase(std::string("Check that keyframes and deltas round-trip through GatewayServer with the ")
+             + (framing == Gateway::FRAMING::BINARY ? "BINARY" : "TEXT") + " framing"),
+    m_framing(framing)
+{
+}
+
+void
+DeltaResponseTestCase::DoRun()
+{
+    // each step sends (index, value) pairs, and the expected response contains a keyframe every 3 responses ("?" is a
+    // value that a delta must not contain)
+    const std::vector<std::vector<int32_t>> steps = {{0, 10, 1, 11, 2, 12, 3, 13}, {2, 22}, {1, 11}, {0, 30},
+                                                     {3, 43, 1, 41}};
+    const std::vector<std::string> expected = {"10 11 12 13", "? ? 22 ?", "? ? ? ?", "30 11 22 13", "? 41 ? 43"};
+    std::vector<std::string> received;
+
+    PairGateway gateway(m_framing);
+    gateway.SetResponseMode(Gateway::RESPONSE_MODE::DELTA, 3);
+    RunWithServer(gateway, [this, &steps, &received](Ptr<GatewayTransport> transport) {
+        GatewayServer server(transport, m_framing);
+        server.SetResponseMode(Gateway::RESPONSE_MODE::DELTA);
+        std::vector<std::string> values(4);
+        for (uint32_t step = 0; step < steps.size(); step++)
+        {
+            // split the first message within its header, and the others within their payload
+            std::string message = EncodeMessage(m_framing, step, steps[step]);
+            SendSplit(transport, message, (step == 0) ? 3 : message.size() - 2);
+
+            values.assign(4, "?");
+            if (!server.ReceiveValues(values))
+            {
+                break;
+            }
+            received.push_back(values[0] + " " + values[1] + " " + values[2] + " " + values[3]);
+        }
+        server.Send(EncodeMessage(m_framing, -1, {})); // terminate message
+        server.Close();
+    });
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(received.size(), expected.size(), "every step must receive a response");
+    for (uint32_t step = 0; step < expected.size(); step++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(received[step], expected[step], "response " << step);
+    }
+}
+
+/* ========== TYPED VALUES ================================================== */
+
+class TypedValueTestCase : public TestCase
+{
+    public:
+        TypedValueTestCase();
+    private:
+        void DoRun() override;
+};
+
+TypedValueTestCase::TypedValueTestCase():
+    TestCase("Check that the numeric SetValue overloads format integers, bool values, and the floating point precision")
+{
+}
+
+void
+TypedValueTestCase::DoRun()
+{
+    std::vector<std::string> responses;
+    NumberGateway gateway;
+    RunGateway(gateway, [&responses](TestServer & server) {
+        // each message contains the precision to use
+        for (int32_t step = 0; step < 2; step++)
+        {
+            std::string response;
+            if (!server.Send(std::to_string(step) + " 0 " + std::to_string(step * 3) + "\r\n")
+                || !server.Receive(response))
+            {
+                break;
+            }
+            responses.push_back(response);
+        }
+        server.Send("-1 0\r\n"); // terminate message
+    });
+    Simulator::Destroy();
+
+    // the default precision is the shortest representation that converts back to the same value
+    NS_TEST_ASSERT_MSG_EQ(responses.size(), 2, "every message must be answered");
+    NS_TEST_ASSERT_MSG_EQ(responses[0], "-7 18446744073709551615 1 0.1 3.14159 text", "the default precision");
+    NS_TEST_ASSERT_MSG_EQ(responses[1], "-7 18446744073709551615 1 0.1 3.14 text", "a precision of 3 digits");
+}
+
+/* ========== BINARY TYPED VALUES =========================================== */
+
+class BinaryTypedValueTestCase : public TestCase
+{
+    public:
+        BinaryTypedValueTestCase();
+    private:
+        void DoRun() override;
+};
+
+BinaryTypedValueTestCase::BinaryTypedValueTestCase():
+    TestCase("Check that the numeric SetValue overloads send native fields with the BINARY framing")
+{
+}
+
+void
+BinaryTypedValueTestCase::DoRun()
+{
+    std::string response;
+    NumberGateway gateway(Gateway::FRAMING::BINARY);
+    RunWithServer(gateway, [&response](Ptr<GatewayTransport> transport) {
+        GatewayServer server(transport, Gateway::FRAMING::BINARY);
+        server.Send(EncodeMessage(Gateway::FRAMING::BINARY, 0, {}));
+        server.Receive(response);
+        server.Send(EncodeMessage(Gateway::FRAMING::BINARY, -1, {})); // terminate message
+        server.Close();
+    });
+    Simulator::Destroy();
+
+    // each read fails if the field has a different type
+    NS_TEST_ASSERT_MSG_EQ(response.size() > BinaryEncoder::HEADER_SIZE, true, "the message must be answered");
+    BinaryDecoder decoder(response.data() + BinaryEncoder::HEADER_SIZE, response.size() - BinaryEncoder::HEADER_SIZE);
+    int32_t int32Value;
+    int64_t int64Value;
+    double doubleValue;
+    std::string bytesValue;
+    NS_TEST_ASSERT_MSG_EQ(decoder.ReadInt32(int32Value), true, "an int32_t must be sent as an INT32 field");
+    NS_TEST_ASSERT_MSG_EQ(int32Value, -7, "the int32_t value");
+    NS_TEST_ASSERT_MSG_EQ(decoder.ReadInt64(int64Value), true, "a uint64_t must be sent as an INT64 field");
+    NS_TEST_ASSERT_MSG_EQ(int64Value, -1, "a uint64_t above the int64_t maximum must wrap around");
+    NS_TEST_ASSERT_MSG_EQ(decoder.ReadInt32(int32Value), true, "a bool must be sent as an INT32 field");
+    NS_TEST_ASSERT_MSG_EQ(int32Value, 1, "the bool value");
+    NS_TEST_ASSERT_MSG_EQ(decoder.ReadDouble(doubleValue), true, "a double must be sent as a DOUBLE field");
+    NS_TEST_ASSERT_MSG_EQ(doubleValue, 0.1, "the double value must not be rounded");
+    NS_TEST_ASSERT_MSG_EQ(decoder.ReadDouble(doubleValue), true, "a double must be sent as a DOUBLE field");
+    NS_TEST_ASSERT_MSG_EQ(decoder.ReadBytes(bytesValue), true, "a string must be sent as a BYTES field");
+    NS_TEST_ASSERT_MSG_EQ(bytesValue, "text", "the string value");
+    NS_TEST_ASSERT_MSG_EQ(decoder.IsEmpty(), true, "the response must only contain the values");
+}
+
+/* ========== TYPED GATEWAY ================================================= */
+
+class TypedGatewayTestCase : public TestCase
+{
+    public:
+        TypedGatewayTestCase();
+    private:
+        void DoRun() override;
+};
+
+TypedGatewayTestCase::TypedGatewayTestCase():
+    TestCase("Check that TypedGateway decodes records from consecutive fields and encodes response records")
+{
+}
+
+void
+TypedGatewayTestCase::DoRun()
+{
+    std::vector<std::string> responses;
+    VehicleGateway gateway;
+    RunGateway(gateway, [&responses](TestServer & server) {
+        const std::vector<std::string> messages = {"0 0 1 2 3 7 1 -1.5 0 0.25 300 0\r\n",
+                                                   "1 0 0 0 0 -8 0 1e3 1e3 0 9 1\r\n"};
+        for (const std::string & message : messages)
+        {
+            std::string response;
+            if (!server.Send(message) || !server.Receive(response))
+            {
+                break;
+            }
+            responses.push_back(response);
+        }
+        server.Send("-1 0\r\n"); // terminate message
+    });
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(responses.size(), 2, "every message must be answered");
+    NS_TEST_ASSERT_MSG_EQ(responses[0], "7 6 -300 -1.25", "the records of the first message");
+    NS_TEST_ASSERT_MSG_EQ(responses[1], "8 0 9 2000", "the records of the second message");
+
+    // the fields after the last whole record can be ignored
+    responses.clear();
+    VehicleGateway ignoringGateway;
+    ignoringGateway.SetIgnoreTrailingFields(true);
+    RunGateway(ignoringGateway, [&responses](TestServer & server) {
+        std::string response;
+        if (server.Send("0 0 1 2 3 7 1 -1.5 0 0.25 300 0 4 5\r\n") && server.Receive(response))
+        {
+            responses.push_back(response);
+        }
+        server.Send("-1 0\r\n"); // terminate message
+    });
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(responses.size(), 1, "a message with trailing fields must be answered");
+    NS_TEST_ASSERT_MSG_EQ(responses[0], "7 6 -300 -1.25", "the trailing fields must be ignored");
+}
+
+/* ========== ASYNCHRONOUS SEND ============================================= */
+
+class AsyncSendTestCase : public TestCase
+{
+    public:
+        AsyncSendTestCase();
+    private:
+        void DoRun() override;
+
+        /**
+         * @brief Run a gateway for a server that sends a burst of messages, and only reads the responses 100 ms later.
+         * @param asyncSend true to send the responses from the writer thread
+         * @param responses the received responses
+         * @return the send statistics of the gateway
+         */
+        Gateway::SendStatistics Run(bool asyncSend, std::vector<std::string> & responses);
+};
+
+AsyncSendTestCase::AsyncSendTestCase():
+    TestCase("Check that the writer thread sends every response in order, and counts the sent responses")
+{
+}
+
+Gateway::SendStatistics
+AsyncSendTestCase::Run(bool asyncSend, std::vector<std::string> & responses)
+{
+    const int32_t count = 100;
+    const std::string padding(10000, 'x'); // 1 MB of responses, so the writer thread waits for the server
+    EchoGateway gateway;
+    gateway.SetAsyncSend(asyncSend);
+    RunGateway(gateway, [&responses, &padding, count](TestServer & server) {
+        std::string burst;
+        for (int32_t step = 0; step < count; step++)
+        {
+            burst += "0 " + std::to_string(step * 1000) + " " + padding + std::to_string(step) + "\r\n";
+        }
+        server.Send(burst);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::string response;
+        while ((int32_t)responses.size() < count && server.Receive(response))
+        {
+            responses.push_back(response);
+        }
+        server.Send("-1 0\r\n"); // terminate message
+    });
+    Simulator::Destroy();
+    return gateway.GetSendStatistics();
+}
+
+void
+AsyncSendTestCase::DoRun()
+{
+    std::vector<std::string> syncResponses;
+    std::vector<std::string> asyncResponses;
+    Gateway::SendStatistics syncStatistics = Run(false, syncResponses);
+    Gateway::SendStatistics asyncStatistics = Run(true, asyncResponses);
+
+    NS_TEST_ASSERT_MSG_EQ(asyncResponses.size(), 100, "every message must be answered");
+    NS_TEST_ASSERT_MSG_EQ(asyncResponses == syncResponses, true, "the writer thread must send the same responses");
+    for (uint32_t step = 0; step < asyncResponses.size(); step++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(asyncResponses[step], std::string(10000, 'x') + std::to_string(step), "response order");
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(asyncStatistics.sentResponses, 100, "every response must be counted");
+    NS_TEST_ASSERT_MSG_EQ(asyncStatistics.sentBytes, syncStatistics.sentBytes, "the same bytes must be counted");
+    NS_TEST_ASSERT_MSG_EQ(asyncStatistics.queuedBytes, 0, "no response may remain queued once stopped");
+    NS_TEST_ASSERT_MSG_EQ(asyncStatistics.maxLatency < asyncStatistics.meanLatency, false, "the latency statistics");
+}
+
+/* ========== STOP WITH A BLOCKED WRITER ==================================== */
+
+class BlockedWriterTestCase : public TestCase
+{
+    public:
+        BlockedWriterTestCase();
+    private:
+        void DoRun() override;
+};
+
+BlockedWriterTestCase::BlockedWriterTestCase():
+    TestCase("Check that stopping a gateway does not wait forever for a server that stopped reading")
+{
+}
+
+void
+BlockedWriterTestCase::DoRun()
+{
+    std::atomic<bool> stopped(false);
+    EchoGateway gateway;
+    gateway.SetAsyncSend(true);
+    gateway.m_suffix = std::string(64 << 20, 'x'); // larger than the socket buffers, so the writer thread blocks
+    TestServer server;
+    server.Start([&stopped](TestServer & server) {
+        // keep the connection open without reading the response until the gateway has stopped
+        server.Send("0 0 v\r\n");
+        server.Send("-1 0\r\n"); // terminate message
+        for (uint32_t i = 0; i < 10000 && !stopped.load(); i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    gateway.Connect("127.0.0.1", server.GetPort());
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Simulator::Run();
+    Simulator::Destroy();
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+    stopped = true;
+    server.Join();
+
+    int64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+    NS_TEST_ASSERT_MSG_EQ(gateway.m_updates.size(), 1, "the message must be processed");
+    NS_TEST_ASSERT_MSG_LT(elapsedMs, 5000, "the gateway must stop once the queued responses cannot be sent");
+}
+
+/* ========== STEP TIMING =================================================== */
+
+class StepTimingTestCase : public TestCase
+{
+    public:
+        StepTimingTestCase();
+    private:
+        void DoRun() override;
+};
+
+StepTimingTestCase::StepTimingTestCase():
+    TestCase("Check that the Step trace source and the histograms report the time spent waiting for the server")
+{
+}
+
+void
+StepTimingTestCase::DoRun()
+{
+    StepRecorder recorder;
+    EchoGateway gateway;
+    gateway.SetTimingHistograms(true);
+    bool connected = gateway.TraceConnectWithoutContext("Step", MakeCallback(&StepRecorder::Record, &recorder));
+    RunGateway(gateway, [](TestServer & server) {
+        for (int32_t step = 0; step < 3; step++)
+        {
+            // the server computes for 20 ms between receiving a response and sending its next message
+            std::string response;
+            if (!server.Send(std::to_string(step) + " 0 v" + std::to_string(step) + "\r\n")
+                || !server.Receive(response))
+            {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        server.Send("-1 0\r\n"); // terminate message
+    });
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(connected, true, "the gateway must have a Step trace source");
+    NS_TEST_ASSERT_MSG_EQ(recorder.m_steps.size(), 3, "every step must be traced");
+    for (uint32_t step = 0; step < recorder.m_steps.size(); step++)
+    {
+        const Gateway::StepTiming & timing = recorder.m_steps[step];
+        NS_TEST_ASSERT_MSG_EQ(timing.timestamp, Seconds(step), "the simulation time of step " << step);
+        for (Time stage : {timing.queue, timing.parse, timing.events, timing.update, timing.response})
+        {
+            NS_TEST_ASSERT_MSG_EQ(stage.IsStrictlyNegative(), false, "the stages of step " << step);
+        }
+        if (step > 0)
+        {
+            NS_TEST_ASSERT_MSG_LT(MilliSeconds(15), timing.serverWait, "the server computes before step " << step);
+        }
+    }
+
+    const LatencyHistogram & serverWait = gateway.GetTimingHistogram(Gateway::TIMING_STAGE::SERVER_WAIT);
+    NS_TEST_ASSERT_MSG_EQ(serverWait.GetCount(), 3, "every step must be recorded in the histograms");
+    NS_TEST_ASSERT_MSG_LT(MilliSeconds(15), serverWait.GetMax(), "the histogram must record the server wait");
+}
+
+/* ========== REPLAY ======================================================== */
+
+class ReplayTestCase : public TestCase
+{
+    public:
+        ReplayTestCase();
+    private:
+        void DoRun() override;
+
+        /**
+         * @brief Replay the recorded messages, and compare the responses with the recorded responses.
+         * @param pacing when the recorded messages are received
+         * @param suffix appended to each response, so that the responses differ from the recording if not empty
+         * @param updates the simulation time (ms) and value of each processed message
+         * @return the number of responses that did not match the recording
+         */
+        uint64_t Replay(ReplayTransport::PACING pacing, const std::string & suffix, std::vector<std::string> & updates);
+
+        std::string m_messagePath;  //!< The recording of the received messages
+        std::string m_responsePath; //!< The recording of the responses
+};
+
+ReplayTestCase::ReplayTestCase():
+    TestCase("Check that a recorded session replays the same updates and responses without the server")
+{
+}
+
+uint64_t
+ReplayTestCase::Replay(ReplayTransport::PACING pacing, const std::string & suffix, std::vector<std::string> & updates)
+{
+    EchoGateway gateway;
+    gateway.m_suffix = suffix;
+    Ptr<ReplayTransport> transport = Create<ReplayTransport>();
+    transport->Open(m_messagePath, pacing);
+    transport->SetResponseLog(m_responsePath);
+    gateway.Connect(transport);
+    Simulator::Run();
+    Simulator::Destroy(); // closes the transport, which counts the responses that were not sent
+
+    updates = gateway.m_updates;
+    NS_TEST_EXPECT_MSG_EQ(transport->GetResponseCount(), 4, "the replay must send every response");
+    return transport->GetMismatchCount();
+}
+
+void
+ReplayTestCase::DoRun()
+{
+    m_messagePath = "/tmp/ns3-cosim-test-" + std::to_string(getpid()) + ".messages";
+    m_responsePath = "/tmp/ns3-cosim-test-" + std::to_string(getpid()) + ".responses";
+
+    // record a session with a server that computes for 10 ms per step
+    EchoGateway recordedGateway;
+    recordedGateway.SetRecordFile(m_messagePath, m_responsePath);
+    RunGateway(recordedGateway, [](TestServer & server) {
+        for (int32_t step = 0; step < 4; step++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            std::string response;
+            if (!server.Send(std::to_string(step) + " 0 v" + std::to_string(step) + "\r\n")
+                || !server.Receive(response))
+            {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        server.Send("-1 0\r\n"); // terminate message
+    });
+    Simulator::Destroy();
+
+    std::vector<std::string> updates;
+    uint64_t mismatches = Replay(ReplayTransport::PACING::WALL_CLOCK, "", updates);
+    NS_TEST_ASSERT_MSG_EQ(updates == recordedGateway.m_updates, true, "the replay must process the same updates");
+    NS_TEST_ASSERT_MSG_EQ(mismatches, 0, "the replay must send the recorded responses");
+
+    // at full speed, the connection closes before the main thread processes the last updates
+    mismatches = Replay(ReplayTransport::PACING::AS_FAST_AS_POSSIBLE, "", updates);
+    NS_TEST_ASSERT_MSG_EQ(updates == recordedGateway.m_updates, true, "a fast replay must process the same updates");
+    NS_TEST_ASSERT_MSG_EQ(mismatches, 0, "a fast replay must send the recorded responses");
+
+    mismatches = Replay(ReplayTransport::PACING::AS_FAST_AS_POSSIBLE, "!", updates);
+    NS_TEST_ASSERT_MSG_EQ(mismatches, 4, "each response that differs from the recording must be counted");
+
+    std::remove(m_messagePath.c_str());
+    std::remove(m_responsePath.c_str());
+}
+
+/* ========== REACTOR ======================================================= */
+
+class ReactorTestCase : public TestCase
+{
+    public:
+        ReactorTestCase();
+    private:
+        void DoRun() override;
+};
+
+ReactorTestCase::ReactorTestCase():
+    TestCase("Check that gateways sharing a reactor with fewer threads than gateways process every message in order")
+{
+}
+
+void
+ReactorTestCase::DoRun()
+{
+    if (!GatewayReactor::IsSupported())
+    {
+        return;
+    }
+
+    // 4 gateways share 2 reactor threads, and their servers send at different rates
+    const uint32_t gatewayCount = 4;
+    const int32_t stepCount = 50;
+    Ptr<GatewayReactor> reactor = Create<GatewayReactor>();
+    reactor->SetThreadCount(2);
+    std::vector<EchoGateway> gateways(gatewayCount);
+    std::vector<TestServer> servers(gatewayCount);
+    std::vector<std::vector<std::string>> responses(gatewayCount);
+    std::atomic<uint32_t> finishedCount(0);
+    for (uint32_t i = 0; i < gatewayCount; i++)
+    {
+        gateways[i].SetReactor(reactor);
+        servers[i].Start([&responses, &finishedCount, i, gatewayCount, stepCount](TestServer & server) {
+            for (int32_t step = 0; step < stepCount; step++)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(100 * i));
+                std::string response;
+                if (!server.Send("0 " + std::to_string(step * 1000000) + " " + std::to_string(step) + "\r\n")
+                    || !server.Receive(response))
+                {
+                    break;
+                }
+                responses[i].push_back(response);
+            }
+
+            // the first terminate message stops the simulation, so every server must finish its steps first
+            finishedCount++;
+            while (finishedCount.load() < gatewayCount)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            server.Send("-1 0\r\n"); // terminate message
+        });
+        gateways[i].Connect("127.0.0.1", servers[i].GetPort());
+    }
+    Simulator::Run();
+    for (TestServer & server : servers)
+    {
+        server.Join();
+    }
+    Simulator::Destroy();
+
+    for (uint32_t i = 0; i < gatewayCount; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(responses[i].size(), stepCount, "every message of gateway " << i << " must be answered");
+        for (int32_t step = 0; step < stepCount; step++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(responses[i][step], std::to_string(step), "the order of gateway " << i);
+            NS_TEST_ASSERT_MSG_EQ(gateways[i].m_updates[step], std::to_string(step) + " " + std::to_string(step),
+                                  "the update time of gateway " << i);
+        }
+    }
+}
+
+/* ========== REACTOR PAUSE ================================================= */
+
+class ReactorPauseTestCase : public TestCase
+{
+    public:
+        ReactorPauseTestCase();
+    private:
+        void DoRun() override;
+};
+
+ReactorPauseTestCase::ReactorPauseTestCase():
+    TestCase("Check that a paused descriptor is not handled until it is resumed, and is then handled without new data")
+{
+}
+
+void
+ReactorPauseTestCase::DoRun()
+{
+    if (!GatewayReactor::IsSupported())
+    {
+        return;
+    }
+
+    int descriptors[2];
+    NS_TEST_ASSERT_MSG_EQ(pipe(descriptors), 0, "the pipe must be created");
+    Ptr<GatewayReactor> reactor = Create<GatewayReactor>();
+    PausingReader reader(reactor, descriptors[0]);
+    NS_TEST_ASSERT_MSG_EQ(reactor->Add(descriptors[0], MakeCallback(&PausingReader::Receive, &reader)), true,
+                          "the pipe must be added");
+
+    // wait up to 1 s for the handler to be called a number of times
+    auto waitForCalls = [&reader](uint32_t count) {
+        for (int i = 0; i < 1000 && reader.m_callCount.load() < count; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+
+    // the first byte is handled, and the handler pauses the pipe
+    NS_TEST_ASSERT_MSG_EQ(write(descriptors[1], "ab", 2), 2, "2 bytes must be written");
+    waitForCalls(1);
+    NS_TEST_ASSERT_MSG_EQ(reader.m_byteCount.load(), 1, "the first call receives 1 byte");
+
+    // the second byte is waiting, but the paused pipe is not handled
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    NS_TEST_ASSERT_MSG_EQ(reader.m_callCount.load(), 1, "a paused descriptor must not be handled");
+
+    // resuming handles the waiting byte
+    reactor->Resume(descriptors[0]);
+    waitForCalls(2);
+    NS_TEST_ASSERT_MSG_EQ(reader.m_byteCount.load(), 2, "the resumed descriptor receives the waiting byte");
+
+    // resuming calls the handler once even though no data is available
+    reactor->Pause(descriptors[0]);
+    reactor->Resume(descriptors[0]);
+    waitForCalls(3);
+    NS_TEST_ASSERT_MSG_EQ(reader.m_callCount.load(), 3, "resuming calls the handler without new data");
+    NS_TEST_ASSERT_MSG_EQ(reader.m_byteCount.load(), 2, "no more bytes are available");
+
+    reactor->Remove(descriptors[0]);
+    close(descriptors[0]);
+    close(descriptors[1]);
+}
+
+/* ========== COORDINATOR =================================================== */
+
+class CoordinatorTestCase : public TestCase
+{
+    public:
+        CoordinatorTestCase();
+    private:
+        void DoRun() override;
+
+        /**
+         * @brief Run two coordinated gateways with lookaheads of 1 s and 300 ms, and 2 steps at 0 s and 1 s.
+         * @param mode the idle mode of the coordinator
+         */
+        void Run(Gateway::IDLE_MODE mode);
+};
+
+CoordinatorTestCase::CoordinatorTestCase():
+    TestCase("Check that the coordinator advances ns-3 to the minimum granted time of its federates")
+{
+}
+
+void
+CoordinatorTestCase::Run(Gateway::IDLE_MODE mode)
+{
+    const std::vector<Time> lookaheads = {Seconds(1), MilliSeconds(300)};
+    GatewayCoordinator coordinator;
+    coordinator.SetIdleMode(mode);
+    std::vector<EchoGateway> gateways(2);
+    std::vector<TestServer> servers(2);
+
+    // both servers wait at each barrier, and the last server to arrive records the time reached by ns-3
+    std::atomic<int64_t> timeReached(-1);
+    std::vector<int64_t> timesReached;
+    std::atomic<uint32_t> arrivedCount[2] = {{0}, {0}};
+    std::atomic<bool> isRecorded[2] = {{false}, {false}};
+    auto barrier = [&](int32_t step) {
+        if (arrivedCount[step].fetch_add(1) == 1)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50)); // ns-3 advances to the granted time
+            timesReached.push_back(timeReached.load());
+            isRecorded[step] = true;
+        }
+        while (!isRecorded[step].load())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+
+    Simulator::Schedule(Time(0), &ProbeTime, &timeReached);
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        gateways[i].SetLookahead(lookaheads[i]);
+        coordinator.Add(gateways[i]);
+        servers[i].Start([&barrier](TestServer & server) {
+            for (int32_t step = 0; step < 2; step++)
+            {
+                std::string response;
+                if (!server.Send(std::to_string(step) + " 0 v" + std::to_string(step) + "\r\n")
+                    || !server.Receive(response))
+                {
+                    break;
+                }
+                barrier(step);
+            }
+            server.Send("-1 0\r\n"); // terminate message
+        });
+        gateways[i].Connect("127.0.0.1", servers[i].GetPort());
+    }
+    Simulator::Run();
+    for (TestServer & server : servers)
+    {
+        server.Join();
+    }
+    int64_t timeStopped = Simulator::Now().GetMilliSeconds();
+    Simulator::Destroy();
+
+    // the grants are 1 s and 300 ms after step 0, and 2 s and 1.3 s after step 1
+    NS_TEST_ASSERT_MSG_EQ(timesReached.size(), 2, "both steps must be answered");
+    NS_TEST_ASSERT_MSG_LT(300 - timesReached[0], 11, "ns-3 must advance to the minimum grant after step 0");
+    NS_TEST_ASSERT_MSG_LT(timesReached[0], 301, "ns-3 must not advance past the minimum grant after step 0");
+    NS_TEST_ASSERT_MSG_LT(1300 - timesReached[1], 11, "ns-3 must advance to the minimum grant after step 1");
+    NS_TEST_ASSERT_MSG_LT(timesReached[1], 1301, "ns-3 must not advance past the minimum grant after step 1");
+    NS_TEST_ASSERT_MSG_EQ(timeStopped, 2000, "the simulation must stop at the largest last granted time");
+    for (const EchoGateway & gateway : gateways)
+    {
+        NS_TEST_ASSERT_MSG_EQ(gateway.m_updates.size(), 2, "every federate must process both steps");
+        NS_TEST_ASSERT_MSG_EQ(gateway.m_updates[1], "1000 v1", "the second step must execute at 1 s");
+    }
+}
+
+void
+CoordinatorTestCase::DoRun()
+{
+    Run(Gateway::IDLE_MODE::SPIN);
+    Run(Gateway::IDLE_MODE::BLOCK);
+}
+
+/* ========== NEXT EVENT REPORT ============================================= */
+
+class NextEventReportTestCase : public TestCase
+{
+    public:
+        NextEventReportTestCase(Gateway::FRAMING framing);
+    private:
+        void DoRun() override;
+
+        Gateway::FRAMING m_framing; //!< The framing of the messages
+};
+
+NextEventReportTestCase::NextEventReportTestCase(Gateway::FRAMING framing):
+    TestCase(std::string("Check that each response reports the next watched event time with the ")
+             + (framing == Gateway::FRAMING::BINARY ? "BINARY" : "TEXT") + " framing"),
+    m_framing(framing)
+{
+}
+
+void
+NextEventReportTestCase::DoRun()
+{
+    // the server starts at 10 s, and the watched events execute at 11.5 s and 12.5 s of server time
+    const std::vector<int64_t> expected = {11500, 11500, 12500, -1};
+    std::vector<int64_t> received;
+    std::vector<std::string> values;
+
+    PairGateway gateway(m_framing);
+    gateway.SetResponseMode(Gateway::RESPONSE_MODE::DELTA, 2);
+    gateway.SetNextEventReport(true);
+    gateway.WatchEvent(Simulator::Schedule(MilliSeconds(2500), [] {}));
+    gateway.WatchEvent(Simulator::Schedule(MilliSeconds(1500), [] {}));
+    RunWithServer(gateway, [this, &received, &values](Ptr<GatewayTransport> transport) {
+        GatewayServer server(transport, m_framing);
+        server.SetResponseMode(Gateway::RESPONSE_MODE::DELTA);
+        server.SetNextEventReport(true);
+        values.assign(4, "?");
+        for (int32_t step = 0; step < 4; step++)
+        {
+            server.Send(EncodeMessage(m_framing, 10 + step, {step, step}));
+            if (!server.ReceiveValues(values))
+            {
+                break;
+            }
+            Time next = server.GetNextEventTime();
+            received.push_back(next.IsStrictlyNegative() ? -1 : next.GetMilliSeconds());
+        }
+        server.Send(EncodeMessage(m_framing, -1, {})); // terminate message
+        server.Close();
+    });
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(received.size(), expected.size(), "every step must receive a response");
+    for (uint32_t step = 0; step < expected.size(); step++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(received[step], expected[step], "next event time of response " << step);
+    }
+    NS_TEST_ASSERT_MSG_EQ(values[0] + " " + values[1] + " " + values[2] + " " + values[3], "0 1 2 3",
+                          "the values must follow the next event time");
+}
+
+/* ========== SPARSE RECORDS ================================================ */
+
+class SparseRecordTestCase : public TestCase
+{
+    public:
+        SparseRecordTestCase();
+    private:
+        void DoRun() override;
+};
+
+SparseRecordTestCase::SparseRecordTestCase():
+    TestCase("Check that sparse records only update the masked fields, and persist between messages")
+{
+}
+
+void
+SparseRecordTestCase::DoRun()
+{
+    std::vector<std::string> responses;
+    SparseVehicleGateway gateway;
+    RunGateway(gateway, [&responses](TestServer & server) {
+        // the second message clears the flag of record 2 and moves it again after moving record 1
+        const std::vector<std::string> messages = {"0 0 2 7 1 2 3 5 1 0 2 4\r\n",
+                                                   "1 0 2 4 0 1 1 0 0 1 2 1 1 1 1\r\n"};
+        for (const std::string & message : messages)
+        {
+            std::string response;
+            if (!server.Send(message) || !server.Receive(response))
+            {
+                break;
+            }
+            responses.push_back(response);
+        }
+        server.Send("-1 0\r\n"); // terminate message
+    });
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(responses.size(), 2, "every message must be answered");
+    NS_TEST_ASSERT_MSG_EQ(responses[0], "-4 0 0 0 5 6", "the records after the first message");
+    NS_TEST_ASSERT_MSG_EQ(responses[1], "-4 0 0 1 -5 3", "the records after the second message");
+    NS_TEST_ASSERT_MSG_EQ(gateway.m_updated.size(), 2, "every message must be decoded");
+    NS_TEST_ASSERT_MSG_EQ(gateway.m_updated[0], "2 0", "the records updated by the first message");
+    NS_TEST_ASSERT_MSG_EQ(gateway.m_updated[1], "2 1", "each updated record must be listed once");
+}
+
+/* ========== SPARSE RECORD KEYS ============================================ */
+
+class SparseMaxRecordsTestCase : public TestCase
+{
+    public:
+        SparseMaxRecordsTestCase();
+    private:
+        void DoRun() override;
+};
+
+SparseMaxRecordsTestCase::SparseMaxRecordsTestCase():
+    TestCase("Check that sparse record keys may exceed the response count up to the maximum number of records")
+{
+}
+
+void
+SparseMaxRecordsTestCase::DoRun()
+{
+    std::vector<std::string> responses;
+    SparseVehicleGateway gateway;
+    gateway.SetMaxRecords(100); // the default maximum (3) rejects the key 99
+    RunGateway(gateway, [&responses](TestServer & server) {
+        // record 99 is decoded but not part of the response, and record 0 is
+        const std::vector<std::string> messages = {"0 0 99 2 7\r\n", "1 0 99 2 8 0 2 5\r\n"};
+        for (const std::string & message : messages)
+        {
+            std::string response;
+            if (!server.Send(message) || !server.Receive(response))
+            {
+                break;
+            }
+            responses.push_back(response);
+        }
+        server.Send("-1 0\r\n"); // terminate message
+    });
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(responses.size(), 2, "every message must be answered");
+    NS_TEST_ASSERT_MSG_EQ(responses[0], "0 0 0 0 0 0", "a record beyond the response count is not sent");
+    NS_TEST_ASSERT_MSG_EQ(responses[1], "-5 0 0 0 0 0", "the records after the second message");
+    NS_TEST_ASSERT_MSG_EQ(gateway.m_updated.size(), 2, "every message must be decoded");
+    NS_TEST_ASSERT_MSG_EQ(gateway.m_updated[0], "99", "the largest allowed key must be accepted");
+    NS_TEST_ASSERT_MSG_EQ(gateway.m_updated[1], "99 0", "the records updated by the second message");
+}
+
+/* ========== STAGED GATEWAY ================================================ */
+
+class StagedGatewayTestCase : public TestCase
+{
+    public:
+        StagedGatewayTestCase();
+    private:
+        void DoRun() override;
+};
+
+StagedGatewayTestCase::StagedGatewayTestCase():
+    TestCase("Check that a staged gateway decodes messages on the receiving thread, and applies them in order")
+{
+}
+
+void
+StagedGatewayTestCase::DoRun()
+{
+    std::vector<std::string> responses;
+    StagedSumGateway gateway;
+    RunGateway(gateway, [&responses](TestServer & server) {
+        // send every message before reading the responses, so several decoded messages can wait in the queue
+        const std::vector<std::string> messages = {"0 0 1 2\r\n", "1 0 3 4 5\r\n", "2 0\r\n", "3 0 -6\r\n"};
+        for (const std::string & message : messages)
+        {
+            server.Send(message);
+        }
+        for (uint32_t i = 0; i < messages.size(); i++)
+        {
+            std::string response;
+            if (!server.Receive(response))
+            {
+                break;
+            }
+            responses.push_back(response);
+        }
+        server.Send("-1 0\r\n"); // terminate message
+    });
+    Simulator::Destroy();
+
+    // the structs are reused between messages, so the values of a shorter message must not include older values
+    const std::vector<std::string> expected = {"3 1", "12 1", "0 1", "-6 1"};
+    NS_TEST_ASSERT_MSG_EQ(responses.size(), expected.size(), "every message must be answered");
+    for (uint32_t i = 0; i < expected.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(responses[i], expected[i], "response " << i);
+    }
+}
+
+/* ========== RESPONSE HEADER =============================================== */
+
+class ResponseHeaderTestCase : public TestCase
+{
+    public:
+        ResponseHeaderTestCase(Gateway::FRAMING framing);
+    private:
+        void DoRun() override;
+
+        Gateway::FRAMING m_framing; //!< The framing of the messages
+};
+
+ResponseHeaderTestCase::ResponseHeaderTestCase(Gateway::FRAMING framing):
+    TestCase(std::string("Check that pipelined responses carry the timestamp and sequence of their message with the ")
+             + (framing == Gateway::FRAMING::BINARY ? "BINARY" : "TEXT") + " framing"),
+    m_framing(framing)
+{
+}
+
+void
+ResponseHeaderTestCase::DoRun()
+{
+    const std::vector<std::string> expected = {"10000 0 0", "11000 1 1", "12000 2 2"};
+    std::vector<std::string> received;
+
+    PairGateway gateway(m_framing);
+    gateway.SetResponseHeader(true);
+    RunWithServer(gateway, [this, &expected, &received](Ptr<GatewayTransport> transport) {
+        GatewayServer server(transport, m_framing);
+        server.SetResponseHeader(true);
+        // send every message before reading the responses
+        for (int32_t step = 0; step < static_cast<int32_t>(expected.size()); step++)
+        {
+            server.Send(EncodeMessage(m_framing, 10 + step, {0, step}));
+        }
+        std::vector<std::string> values(4);
+        for (uint32_t i = 0; i < expected.size(); i++)
+        {
+            if (!server.ReceiveValues(values))
+            {
+                break;
+            }
+            received.push_back(std::to_string(server.GetResponseTime().GetMilliSeconds()) + " "
+                               + std::to_string(server.GetResponseSequence()) + " " + values[0]);
+        }
+        server.Send(EncodeMessage(m_framing, -1, {})); // terminate message
+        server.Close();
+    });
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(received.size(), expected.size(), "every message must be answered");
+    for (uint32_t i = 0; i < expected.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(received[i], expected[i], "the timestamp, sequence, and value of response " << i);
+    }
+}
+
+/* ========== PACING ======================================================== */
+
+class PacingTestCase : public TestCase
+{
+    public:
+        PacingTestCase();
+    private:
+        void DoRun() override;
+};
+
+PacingTestCase::PacingTestCase():
+    TestCase("Check that a paced gateway waits for the wall clock time of each update, and counts its deadlines")
+{
+}
+
+void
+PacingTestCase::DoRun()
+{
+    PacingRecorder recorder;
+    std::chrono::steady_clock::duration elapsed(0);
+    EchoGateway gateway;
+    gateway.SetPacing(10); // 10 simulation seconds per wall clock second
+    bool connected = gateway.TraceConnectWithoutContext("Pacing", MakeCallback(&PacingRecorder::Record, &recorder));
+    RunGateway(gateway, [&elapsed](TestServer & server) {
+        // the server sends each message as soon as it receives the previous response
+        std::chrono::steady_clock::time_point start;
+        for (int32_t step = 0; step < 3; step++)
+        {
+            std::string response;
+            if (!server.Send(std::to_string(step) + " 0 v\r\n") || !server.Receive(response))
+            {
+                break;
+            }
+            if (step == 0)
+            {
+                start = std::chrono::steady_clock::now();
+            }
+            elapsed = std::chrono::steady_clock::now() - start;
+        }
+        server.Send("-1 0\r\n"); // terminate message
+    });
+    Gateway::PacingStatistics statistics = gateway.GetPacingStatistics();
+    Simulator::Destroy();
+
+    // the updates at 1 s and 2 s are 100 ms and 200 ms of wall clock time after the first message
+    int64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+    NS_TEST_ASSERT_MSG_EQ(gateway.m_updates.size(), 3, "every message must be processed");
+    NS_TEST_ASSERT_MSG_GT(elapsedMs, 190, "the updates must wait for their wall clock time");
+    NS_TEST_ASSERT_MSG_LT(elapsedMs, 400, "the updates must not wait past their wall clock time");
+    NS_TEST_ASSERT_MSG_EQ(statistics.deadlines, 2, "each update after the first message must be a deadline");
+    NS_TEST_ASSERT_MSG_EQ(statistics.misses, 0, "the server is faster than the pacing");
+    NS_TEST_ASSERT_MSG_EQ(connected, true, "the Pacing trace source must exist");
+    NS_TEST_ASSERT_MSG_EQ(recorder.m_timings.size(), 2, "each deadline must be traced");
+    NS_TEST_ASSERT_MSG_EQ(recorder.m_timings[1].timestamp, Seconds(2), "the second deadline is the update at 2 s");
+    NS_TEST_ASSERT_MSG_GT(recorder.m_timings[1].slack, MilliSeconds(50),
+                          "the server responds long before each deadline");
+}
+
+/* ========== TEST SUITE ==================================================== */
+
+class GatewayTestSuite : public TestSuite
+{
+    public:
+        GatewayTestSuite();
+};
+
+GatewayTestSuite::GatewayTestSuite():
+    TestSuite("ns3-cosim-gateway", Type::UNIT)
+{
+    AddTestCase(new IdleModeTestCase());
+    AddTestCase(new SharedBlockModeTestCase());
+    AddTestCase(new TextTimestampTestCase());
+    AddTestCase(new BinaryFramingTestCase());
+    AddTestCase(new MessageBurstTestCase());
+    AddTestCase(new LookaheadTestCase());
+    AddTestCase(new DeltaResponseTestCase(Gateway::FRAMING::TEXT));
+    AddTestCase(new DeltaResponseTestCase(Gateway::FRAMING::BINARY));
+    AddTestCase(new TypedValueTestCase());
+    AddTestCase(new BinaryTypedValueTestCase());
+    AddTestCase(new TypedGatewayTestCase());
+    AddTestCase(new AsyncSendTestCase());
+    AddTestCase(new BlockedWriterTestCase());
+    AddTestCase(new StepTimingTestCase());
+    AddTestCase(new ReplayTestCase());
+    AddTestCase(new ReactorTestCase());
+    AddTestCase(new ReactorPauseTestCase());
+    AddTestCase(new CoordinatorTestCase());
+    AddTestCase(new NextEventReportTestCase(Gateway::FRAMING::TEXT));
+    AddTestCase(new NextEventReportTestCase(Gateway::FRAMING::BINARY));
+    AddTestCase(new SparseRecordTestCase());
+    AddTestCase(new SparseMaxRecordsTestCase());
+    AddTestCase(new StagedGatewayTestCase());
+    AddTestCase(new ResponseHeaderTestCase(Gateway::FRAMING::TEXT));
+    AddTestCase(new ResponseHeaderTestCase(Gateway::FRAMING::BINARY));
+    AddTestCase(new PacingTestCase());
+}
+
+static GatewayTestSuite g_gatewayTestSuite; //!< The static instance that registers the test suite
@@ -0,0 +1,428 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ns3/test.h"
+
+#include "ns3/gateway.h"
+#include "ns3/gateway-server.h"
+#include "ns3/gateway-transport.h"
+#include "ns3/shared-memory-transport.h"
+
+using namespace ns3;
+
+namespace
+{
+
+// a shared memory object name that does not conflict with other test processes
+std::string
+GetTestName()
+{
+    return "/ns3-cosim-test-" + std::to_string(getpid());
+}
+
+// a byte sequence that is not periodic in the ring capacities used by the tests
+std::string
+GetTestData(size_t size)
+{
+    std::string data(size, '\0');
+    for (size_t i = 0; i < size; i++)
+    {
+        data[i] = (char)(i * 7 + i / 251);
+    }
+    return data;
+}
+
+// receive exactly the requested number of bytes
+bool
+ReceiveAll(GatewayTransport & transport, std::string & data, size_t size)
+{
+    data.clear();
+    char buffer[100]; // smaller than the test data, so a receive never takes all of it
+    while (data.size() < size)
+    {
+        ssize_t bytesReceived = transport.Receive(buffer, std::min(sizeof(buffer), size - data.size()));
+        if (bytesReceived <= 0)
+        {
+            return false;
+        }
+        data.append(buffer, bytesReceived);
+    }
+    return true;
+}
+
+// a port number that is free on the loopback interface
+uint16_t
+GetFreePort()
+{
+    int freeSocket = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressSize = sizeof(address);
+    if (freeSocket == -1 || bind(freeSocket, (struct sockaddr *)&address, addressSize) == -1
+        || getsockname(freeSocket, (struct sockaddr *)&address, &addressSize) == -1)
+    {
+        NS_FATAL_ERROR("ERROR: the test failed to find a free port");
+    }
+    close(freeSocket);
+    return ntohs(address.sin_port);
+}
+
+// a gateway that responds to each message with its value followed by "!"
+class ExclaimGateway : public Gateway
+{
+    public:
+        ExclaimGateway():
+            Gateway(1)
+        {
+        }
+    private:
+        void DoInitialize(const std::vector<std::string> & receivedData) override
+        {
+            DoUpdate(receivedData);
+        }
+
+        void DoUpdate(const std::vector<std::string> & receivedData) override
+        {
+            SetValue(0, receivedData.at(0) + "!");
+            SendResponse();
+        }
+};
+
+} // namespace
+
+/* ========== SHARED MEMORY TRANSPORT ======================================= */
+
+class SharedMemoryTransportTestCase : public TestCase
+{
+    public:
+        SharedMemoryTransportTestCase();
+    private:
+        void DoRun() override;
+};
+
+SharedMemoryTransportTestCase::SharedMemoryTransportTestCase():
+    TestCase("Check that the shared memory transport delivers data larger than its rings in both directions")
+{
+}
+
+void
+SharedMemoryTransportTestCase::DoRun()
+{
+    const std::string name = GetTestName();
+    const std::string data = GetTestData(10000);
+
+    // the data is larger than the rings, so both rings wrap many times
+    Ptr<SharedMemoryTransport> server = Create<SharedMemoryTransport>();
+    server->Listen(name, 64);
+    std::string echoed;
+    std::thread client([&name, &data, &echoed] {
+        SharedMemoryTransport transport;
+        transport.Connect(name);
+        if (ReceiveAll(transport, echoed, data.size()))
+        {
+            transport.Send(echoed.data(), echoed.size());
+        }
+        transport.Close();
+    });
+    server->Accept();
+    NS_TEST_ASSERT_MSG_EQ(shm_open(name.c_str(), O_RDWR, 0), -1, "the name must be removed once the client connects");
+
+    std::string received;
+    bool sent = server->Send(data.data(), data.size());
+    bool receivedAll = ReceiveAll(*server, received, data.size());
+    client.join();
+    char byte;
+    ssize_t bytesAfterClose = server->Receive(&byte, 1);
+    server->Close();
+
+    NS_TEST_ASSERT_MSG_EQ(sent, true, "the server must send every byte");
+    NS_TEST_ASSERT_MSG_EQ(echoed == data, true, "the client must receive the data in order");
+    NS_TEST_ASSERT_MSG_EQ(receivedAll, true, "the server must receive every byte");
+    NS_TEST_ASSERT_MSG_EQ(received == data, true, "the server must receive the data in order");
+    NS_TEST_ASSERT_MSG_EQ(bytesAfterClose, 0, "the server must receive 0 bytes once the client closed");
+
+    // closing a listening transport removes its name
+    SharedMemoryTransport unused;
+    unused.Listen(name, 64);
+    unused.Close();
+    NS_TEST_ASSERT_MSG_EQ(shm_open(name.c_str(), O_RDWR, 0), -1, "closing a listening transport must remove the name");
+}
+
+/* ========== TCP TRANSPORT ================================================= */
+
+class TcpTransportTestCase : public TestCase
+{
+    public:
+        TcpTransportTestCase();
+    private:
+        void DoRun() override;
+};
+
+TcpTransportTestCase::TcpTransportTestCase():
+    TestCase("Check that a client can connect to a TCP transport as soon as it listens")
+{
+}
+
+void
+TcpTransportTestCase::DoRun()
+{
+    const uint16_t port = GetFreePort();
+    const std::string data = GetTestData(10000);
+
+    // the client connects before the server accepts
+    TcpTransport server;
+    server.Listen(port);
+    TcpTransport client;
+    client.Connect("localhost", port); // resolved to the IPv6 or IPv4 loopback address
+    server.Accept();
+
+    std::string received;
+    std::thread sender([&client, &data] {
+        client.Send(data.data(), data.size());
+        client.Close();
+    });
+    bool receivedAll = ReceiveAll(server, received, data.size());
+    sender.join();
+    char byte;
+    ssize_t bytesAfterClose = server.Receive(&byte, 1);
+    server.Close();
+
+    NS_TEST_ASSERT_MSG_EQ(receivedAll, true, "the server must receive every byte");
+    NS_TEST_ASSERT_MSG_EQ(received == data, true, "the server must receive the data in order");
+    NS_TEST_ASSERT_MSG_EQ(bytesAfterClose, 0, "the server must receive 0 bytes once the client closed");
+}
+
+/* ========== UNIX TRANSPORT ================================================ */
+
+class UnixTransportTestCase : public TestCase
+{
+    public:
+        UnixTransportTestCase();
+    private:
+        void DoRun() override;
+};
+
+UnixTransportTestCase::UnixTransportTestCase():
+    TestCase("Check that the Unix domain socket transport exchanges data and removes its socket file")
+{
+}
+
+void
+UnixTransportTestCase::DoRun()
+{
+    const std::string path = "/tmp" + GetTestName() + ".sock";
+    const std::string data = GetTestData(10000);
+
+    UnixTransport server;
+    server.Listen(path);
+    NS_TEST_ASSERT_MSG_EQ(access(path.c_str(), F_OK), 0, "the socket file must exist while listening");
+    UnixTransport client;
+    client.Connect(path);
+    server.Accept();
+    NS_TEST_ASSERT_MSG_EQ(access(path.c_str(), F_OK), -1, "the socket file must be removed once the client connects");
+
+    std::string received;
+    std::thread sender([&client, &data] {
+        client.Send(data.data(), data.size());
+        client.Close();
+    });
+    bool receivedAll = ReceiveAll(server, received, data.size());
+    sender.join();
+    char byte;
+    ssize_t bytesAfterClose = server.Receive(&byte, 1);
+    server.Close();
+
+    NS_TEST_ASSERT_MSG_EQ(receivedAll, true, "the server must receive every byte");
+    NS_TEST_ASSERT_MSG_EQ(received == data, true, "the server must receive the data in order");
+    NS_TEST_ASSERT_MSG_EQ(bytesAfterClose, 0, "the server must receive 0 bytes once the client closed");
+
+    // closing a listening transport removes its socket file
+    UnixTransport unused;
+    unused.Listen(path);
+    unused.Close();
+    NS_TEST_ASSERT_MSG_EQ(access(path.c_str(), F_OK), -1, "closing a listening transport must remove the file");
+}
+
+/* ========== SHARED MEMORY GATEWAY ========================================= */
+
+class SharedMemoryGatewayTestCase : public TestCase
+{
+    public:
+        SharedMemoryGatewayTestCase();
+    private:
+        void DoRun() override;
+};
+
+SharedMemoryGatewayTestCase::SharedMemoryGatewayTestCase():
+    TestCase("Check that a gateway exchanges messages with a server over the shared memory transport")
+{
+}
+
+void
+SharedMemoryGatewayTestCase::DoRun()
+{
+    const std::string name = GetTestName();
+    std::promise<void> listening;
+    std::vector<std::string> responses;
+    std::thread serverThread([&name, &listening, &responses] {
+        Ptr<SharedMemoryTransport> serverTransport = Create<SharedMemoryTransport>();
+        serverTransport->Listen(name);
+        listening.set_value();
+        serverTransport->Accept();
+        GatewayServer server(serverTransport);
+        std::string response;
+        for (int32_t step = 0; step < 3; step++)
+        {
+            std::string message = std::to_string(step) + " 0 v" + std::to_string(step) + "\r\n";
+            if (!server.Send(message) || !server.Receive(response))
+            {
+                break;
+            }
+            responses.push_back(response);
+        }
+        server.Send("-1 0\r\n"); // terminate message
+        server.Close();
+    });
+
+    ExclaimGateway gateway;
+    listening.get_future().wait(); // the transports are not shared between threads, since Ptr is not thread-safe
+    Ptr<SharedMemoryTransport> transport = Create<SharedMemoryTransport>();
+    transport->Connect(name);
+    gateway.Connect(transport);
+    Simulator::Run();
+    serverThread.join();
+    Simulator::Destroy();
+
+    const std::vector<std::string> expected = {"v0!", "v1!", "v2!"};
+    NS_TEST_ASSERT_MSG_EQ(responses.size(), expected.size(), "every message must be answered");
+    for (uint32_t i = 0; i < responses.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(responses[i], expected[i], "response " << i);
+    }
+}
+
+/* ========== SHUTDOWN ====================================================== */
+
+class ShutdownTestCase : public TestCase
+{
+    public:
+        ShutdownTestCase();
+    private:
+        void DoRun() override;
+
+        /**
+         * @brief Check that GatewayTransport::Shutdown wakes a thread blocked in Receive on a connected transport.
+         * @param transport the connected transport, whose peer never sends
+         * @param name the name of the transport in the test messages
+         */
+        void CheckShutdown(GatewayTransport & transport, const std::string & name);
+};
+
+ShutdownTestCase::ShutdownTestCase():
+    TestCase("Check that shutting down a transport wakes a thread blocked in Receive")
+{
+}
+
+void
+ShutdownTestCase::CheckShutdown(GatewayTransport & transport, const std::string & name)
+{
+    ssize_t bytesReceived = -1;
+    std::thread receiver([&transport, &bytesReceived] {
+        char byte;
+        bytesReceived = transport.Receive(&byte, 1);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)); // the receiver is blocked
+    transport.Shutdown();
+    receiver.join();
+    NS_TEST_ASSERT_MSG_EQ(bytesReceived, 0, "a blocked receive on the " << name << " transport must return 0");
+}
+
+void
+ShutdownTestCase::DoRun()
+{
+    const std::string name = GetTestName();
+    const std::string path = "/tmp" + GetTestName() + ".sock";
+
+    SharedMemoryTransport sharedServer;
+    sharedServer.Listen(name, 64);
+    sharedServer.Shutdown(); // nothing can be waiting before the client connects
+    SharedMemoryTransport sharedClient;
+    sharedClient.Connect(name);
+    sharedServer.Accept();
+    CheckShutdown(sharedServer, "shared memory");
+    sharedClient.Close();
+    sharedServer.Close();
+
+    UnixTransport unixServer;
+    unixServer.Listen(path);
+    UnixTransport unixClient;
+    unixClient.Connect(path);
+    unixServer.Accept();
+    CheckShutdown(unixServer, "Unix domain socket");
+    unixClient.Close();
+    unixServer.Close();
+}
+
+/* ========== TEST SUITE ==================================================== */
+
+class GatewayTransportTestSuite : public TestSuite
+{
+    public:
+        GatewayTransportTestSuite();
+};
+
+GatewayTransportTestSuite::GatewayTransportTestSuite():
+    TestSuite("ns3-cosim-gateway-transport", Type::UNIT)
+{
+    AddTestCase(new SharedMemoryTransportTestCase());
+    AddTestCase(new TcpTransportTestCase());
+    AddTestCase(new UnixTransportTestCase());
+    AddTestCase(new SharedMemoryGatewayTestCase());
+    AddTestCase(new ShutdownTestCase());
+}
+
+static GatewayTransportTestSuite g_gatewayTransportTestSuite; //!< The static instance that registers the test suite
@@ -0,0 +1,107 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include "ns3/test.h"
+
+#include "ns3/latency-histogram.h"
+
+using namespace ns3;
+
+/* ========== LATENCY HISTOGRAM ============================================= */
+
+class LatencyHistogramTestCase : public TestCase
+{
+    public:
+        LatencyHistogramTestCase();
+    private:
+        void DoRun() override;
+};
+
+LatencyHistogramTestCase::LatencyHistogramTestCase():
+    TestCase("Check that LatencyHistogram reports exact statistics and percentiles within 3 %")
+{
+}
+
+void
+LatencyHistogramTestCase::DoRun()
+{
+    LatencyHistogram histogram;
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetPercentile(50), Time(0), "an empty histogram must report 0");
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetMean(), Time(0), "an empty histogram must report 0");
+
+    for (int64_t i = 1; i <= 100000; i++)
+    {
+        histogram.Record(NanoSeconds(i * 10));
+    }
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetCount(), 100000, "every value must be counted");
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetMin(), NanoSeconds(10), "the minimum must be exact");
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetMax(), NanoSeconds(1000000), "the maximum must be exact");
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetMean(), NanoSeconds(500005), "the mean must be exact");
+
+    double percentiles[] = {1, 50, 90, 99, 99.9};
+    for (double percentile : percentiles)
+    {
+        double expected = percentile * 10000; // in nanoseconds
+        double actual = histogram.GetPercentile(percentile).GetNanoSeconds();
+        NS_TEST_ASSERT_MSG_EQ_TOL(actual, expected, 0.03 * expected, "percentile " << percentile);
+    }
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetPercentile(100), NanoSeconds(1000000), "the 100th percentile is the maximum");
+
+    histogram.Record(NanoSeconds(-5));
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetMin(), Time(0), "a negative value must be counted as 0");
+
+    histogram.Clear();
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetCount(), 0, "a cleared histogram must be empty");
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetMax(), Time(0), "a cleared histogram must report 0");
+
+    // values below 64 ns are counted exactly, and the largest Time is counted by the last bucket
+    histogram.Record(NanoSeconds(63));
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetPercentile(50), NanoSeconds(63), "a small value must be counted exactly");
+    histogram.Record(Time::Max());
+    NS_TEST_ASSERT_MSG_EQ(histogram.GetPercentile(100), Time::Max(), "the largest Time must be counted");
+}
+
+/* ========== TEST SUITE ==================================================== */
+
+class LatencyHistogramTestSuite : public TestSuite
+{
+    public:
+        LatencyHistogramTestSuite();
+};
+
+LatencyHistogramTestSuite::LatencyHistogramTestSuite():
+    TestSuite("ns3-cosim-latency-histogram", Type::UNIT)
+{
+    AddTestCase(new LatencyHistogramTestCase());
+}
+
+static LatencyHistogramTestSuite g_latencyHistogramTestSuite; //!< The static instance that registers the test suite
@@ -0,0 +1,135 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <string>
+
+#include "ns3/test.h"
+
+#include "ns3/receive-buffer.h"
+
+using namespace ns3;
+
+namespace
+{
+
+// write a string at the end of a receive buffer, in as many parts as the free space requires
+void
+WriteBuffer(ReceiveBuffer & buffer, const std::string & data)
+{
+    size_t written = 0;
+    while (written < data.size())
+    {
+        size_t size;
+        char * writable = buffer.GetWritable(data.size() - written, size);
+        data.copy(writable, size, written);
+        buffer.Commit(size);
+        written += size;
+    }
+}
+
+} // namespace
+
+/* ========== RING BUFFER =================================================== */
+
+class ReceiveBufferTestCase : public TestCase
+{
+    public:
+        ReceiveBufferTestCase();
+    private:
+        void DoRun() override;
+};
+
+ReceiveBufferTestCase::ReceiveBufferTestCase():
+    TestCase("Check that ReceiveBuffer wraps around, resumes delimiter searches across the wrap, and grows")
+{
+}
+
+void
+ReceiveBufferTestCase::DoRun()
+{
+    ReceiveBuffer buffer(8);
+    std::string data;
+    size_t size;
+    size_t position;
+
+    WriteBuffer(buffer, "abcdef");
+    buffer.Consume(4);
+    NS_TEST_ASSERT_MSG_EQ(buffer.GetSize(), 2, "consumed bytes must be removed");
+
+    // the next bytes are written at the end of the memory, and then at its start
+    buffer.GetWritable(8, size);
+    NS_TEST_ASSERT_MSG_EQ(size, 2, "the free space before the end of the memory must be returned first");
+    WriteBuffer(buffer, "gh");
+    buffer.GetWritable(8, size);
+    NS_TEST_ASSERT_MSG_EQ(size, 4, "the free space after the wrap must be returned next");
+    buffer.GetWritable(3, size);
+    NS_TEST_ASSERT_MSG_EQ(size, 3, "the free space must be limited to the maximum size");
+    WriteBuffer(buffer, "ijkl");
+    NS_TEST_ASSERT_MSG_EQ(buffer.GetSize(), 8, "the buffer must be full");
+
+    NS_TEST_ASSERT_MSG_EQ(buffer.Find("hi", position), true, "a delimiter across the wrap must be found");
+    NS_TEST_ASSERT_MSG_EQ(position, 3, "the delimiter position must be relative to the first buffered byte");
+    char peeked[4];
+    buffer.Peek(peeked, sizeof(peeked));
+    NS_TEST_ASSERT_MSG_EQ(std::string(peeked, 4), "efgh", "peeked bytes must be copied from the start of the buffer");
+    buffer.Read(5, data);
+    NS_TEST_ASSERT_MSG_EQ(data, "efghi", "read bytes must be copied across the wrap");
+
+    // a delimiter split between two receives is found once its last byte is received
+    NS_TEST_ASSERT_MSG_EQ(buffer.Find("lm", position), false, "a partial delimiter must not be found");
+    WriteBuffer(buffer, "m");
+    NS_TEST_ASSERT_MSG_EQ(buffer.Find("lm", position), true, "a delimiter completed by new bytes must be found");
+    NS_TEST_ASSERT_MSG_EQ(position, 2, "the resumed search must find the delimiter at its start");
+
+    // a full buffer grows, keeping the buffered bytes in order
+    WriteBuffer(buffer, "nopqrs");
+    NS_TEST_ASSERT_MSG_EQ(buffer.GetSize(), 10, "the buffer must grow to hold every byte");
+    buffer.Read(10, data);
+    NS_TEST_ASSERT_MSG_EQ(data, "jklmnopqrs", "the bytes must be read in the order they were written");
+    NS_TEST_ASSERT_MSG_EQ(buffer.GetSize(), 0, "read bytes must be removed");
+}
+
+/* ========== TEST SUITE ==================================================== */
+
+class ReceiveBufferTestSuite : public TestSuite
+{
+    public:
+        ReceiveBufferTestSuite();
+};
+
+ReceiveBufferTestSuite::ReceiveBufferTestSuite():
+    TestSuite("ns3-cosim-receive-buffer", Type::UNIT)
+{
+    AddTestCase(new ReceiveBufferTestCase());
+}
+
+static ReceiveBufferTestSuite g_receiveBufferTestSuite; //!< The static instance that registers the test suite
@@ -0,0 +1,156 @@
+/*
+ * NIST-developed software is provided by NIST as a public service. You may use,
+ * copy, and distribute copies of the software in any medium, provided that you
+ * keep intact this entire notice. You may improve, modify, and create
+ * derivative works of the software or any portion of the software, and you may
+ * copy and distribute such modifications or works. Modified works should carry
+ * a notice stating that you changed the software and should note the date and
+ * nature of any such change. Please explicitly acknowledge the National
+ * Institute of Standards and Technology as the source of the software. 
+ *
+ * NIST-developed software is expressly provided "AS IS." NIST MAKES NO WARRANTY
+ * OF ANY KIND, EXPRESS, IMPLIED, IN FACT, OR ARISING BY OPERATION OF LAW,
+ * INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTY OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, NON-INFRINGEMENT, AND DATA ACCURACY. NIST
+ * NEITHER REPRESENTS NOR WARRANTS THAT THE OPERATION OF THE SOFTWARE WILL BE
+ * UNINTERRUPTED OR ERROR-FREE, OR THAT ANY DEFECTS WILL BE CORRECTED. NIST DOES
+ * NOT WARRANT OR MAKE ANY REPRESENTATIONS REGARDING THE USE OF THE SOFTWARE OR
+ * THE RESULTS THEREOF, INCLUDING BUT NOT LIMITED TO THE CORRECTNESS, ACCURACY,
+ * RELIABILITY, OR USEFULNESS OF THE SOFTWARE.
+ * 
+ * You are solely responsible for determining the appropriateness of using and
+ * distributing the software and you assume all risks associated with its use,
+ * including but not limited to the risks and costs of program errors,
+ * compliance with applicable laws, damage to or loss of data, programs or
+ * equipment, and the unavailability or interruption of operation. This software 
+ * is not intended to be used in any situation where a failure could cause risk
+ * of injury or damage to property. The software developed by NIST employees is
+ * not subject to copyright protection within the United States.
+ *
+ * Author: Thomas Roth <thomas.roth@nist.gov>
+*/
+
+#include <string>
+#include <thread>
+
+#include "ns3/test.h"
+
+#include "ns3/spsc-queue.h"
+
+using namespace ns3;
+
+/* ========== ONE THREAD ==================================================== */
+
+class SpscQueueTestCase : public TestCase
+{
+    public:
+        SpscQueueTestCase();
+    private:
+        void DoRun() override;
+};
+
+SpscQueueTestCase::SpscQueueTestCase():
+    TestCase("Check that SpscQueue is bounded, ordered, and recycles popped values")
+{
+}
+
+void
+SpscQueueTestCase::DoRun()
+{
+    SpscQueue<std::string> queue(3); // rounded up to 4 slots
+    std::string value;
+    NS_TEST_ASSERT_MSG_EQ(queue.IsEmpty(), true, "a new queue must be empty");
+    NS_TEST_ASSERT_MSG_EQ(queue.Pop(value), false, "an empty queue must not pop");
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        value = std::to_string(i);
+        NS_TEST_ASSERT_MSG_EQ(queue.Push(value), true, "the queue must accept 4 elements");
+    }
+    value = "4";
+    NS_TEST_ASSERT_MSG_EQ(queue.Push(value), false, "a full queue must not push");
+    NS_TEST_ASSERT_MSG_EQ(value, "4", "a failed push must not change the value");
+    NS_TEST_ASSERT_MSG_EQ(queue.IsEmpty(), false, "a full queue must not be empty");
+
+    value = "recycled";
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(queue.Pop(value), true, "the queue must return 4 elements");
+        NS_TEST_ASSERT_MSG_EQ(value, std::to_string(i), "the elements must be returned in order");
+    }
+    NS_TEST_ASSERT_MSG_EQ(queue.IsEmpty(), true, "the queue must be empty after popping every element");
+    NS_TEST_ASSERT_MSG_EQ(queue.Pop(value), false, "an emptied queue must not pop");
+
+    // the value left in the first slot by the first Pop is returned by the next Push into that slot
+    value = "5";
+    NS_TEST_ASSERT_MSG_EQ(queue.Push(value), true, "the emptied queue must accept an element");
+    NS_TEST_ASSERT_MSG_EQ(value, "recycled", "the push must return the value left in its slot by a previous pop");
+}
+
+/* ========== TWO THREADS =================================================== */
+
+class SpscQueueThreadTestCase : public TestCase
+{
+    public:
+        SpscQueueThreadTestCase();
+    private:
+        void DoRun() override;
+};
+
+SpscQueueThreadTestCase::SpscQueueThreadTestCase():
+    TestCase("Check that SpscQueue passes every element in order from a producer thread to a consumer thread")
+{
+}
+
+void
+SpscQueueThreadTestCase::DoRun()
+{
+    const uint64_t count = 200000;
+    SpscQueue<uint64_t> queue(64);
+
+    std::thread producer([&queue, count] {
+        for (uint64_t i = 0; i < count; i++)
+        {
+            uint64_t value = i;
+            while (!queue.Push(value))
+            {
+                std::this_thread::yield(); // the queue is full
+            }
+        }
+    });
+
+    uint64_t popped = 0;
+    uint64_t outOfOrder = 0;
+    uint64_t value = 0;
+    while (popped < count)
+    {
+        if (!queue.Pop(value))
+        {
+            std::this_thread::yield(); // the queue is empty
+            continue;
+        }
+        outOfOrder += (value != popped);
+        popped++;
+    }
+    producer.join();
+
+    NS_TEST_ASSERT_MSG_EQ(outOfOrder, 0, "every element must be popped once, in the order it was pushed");
+    NS_TEST_ASSERT_MSG_EQ(queue.IsEmpty(), true, "the queue must be empty after popping every element");
+}
+
+/* ========== TEST SUITE ==================================================== */
+
+class SpscQueueTestSuite : public TestSuite
+{
+    public:
+        SpscQueueTestSuite();
+};
+
+SpscQueueTestSuite::SpscQueueTestSuite():
+    TestSuite("ns3-cosim-spsc-queue", Type::UNIT)
+{
+    AddTestCase(new SpscQueueTestCase());
+    AddTestCase(new SpscQueueThreadTestCase());
+}
+
+static SpscQueueTestSuite g_spscQueueTestSuite; //!< The static instance that registers the test suite